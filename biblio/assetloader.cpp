@@ -0,0 +1,241 @@
+#include "assetloader.h"
+#include "assetregistry.h"
+#include <QColor>
+#include <QDebug>
+#include <QMetaObject>
+#include <QStandardPaths>
+#include <QThreadPool>
+
+// Constants
+// Game textures, in the order of GameWidget's textures array (file name without ".jpg", and registry name)
+const char *const TEXTURE_NAMES[AssetLoader::TEXTURE_COUNT] = {"apple", "strawberry", "banana", "pear", "bomb", "floor", "cannon", "blade", "handle", "chain"};
+const char *const BACKUP_TEXTURE_NAMES[] = {"red", "orange_alt"}; // Replace the first two textures when missing
+const int BACKUP_TEXTURE_COUNT = 2;
+const char *const TEXTURE_CACHE_FILE = "/textures.atlas";
+const char *const ASSET_NAMES[AssetLoader::AssetCount] = {"textures", "cascades", "sounds"};
+
+// Fallback when a texture image cannot be loaded
+static QImage createColorTexture(const QColor &color)
+{
+    QImage img(256, 256, QImage::Format_RGBA8888);
+    img.fill(color);
+    return img;
+}
+
+const char *AssetLoader::textureName(int texture)
+{
+    return TEXTURE_NAMES[texture];
+}
+
+AssetLoader::AssetLoader(QObject *parent)
+    : QObject(parent), shared(std::make_shared<Shared>())
+{
+    shared->owner = this;
+}
+
+AssetLoader::~AssetLoader()
+{
+    // Tasks still running keep the shared state alive; nothing is announced to this object any more
+    std::lock_guard<std::mutex> lock(shared->ownerMutex);
+    shared->owner = nullptr;
+    shared->cancelled = true;
+}
+
+void AssetLoader::start(bool withTextures)
+{
+    if (started)
+    {
+        return;
+    }
+    started = true;
+    shared->clock.start();
+
+    // One task per kind of asset, JPEG decoding spreads over the remaining threads of the global pool
+    std::shared_ptr<Shared> state = shared;
+    QThreadPool *pool = QThreadPool::globalInstance();
+    if (withTextures)
+    {
+        pool->start([state]() { loadTextures(state); });
+    }
+    else
+    {
+        qDebug() << "Textures already uploaded by a previous game, not loading them";
+        complete(state, Textures);
+    }
+    pool->start([state]() { loadCascades(state); });
+    pool->start([state]() { loadSounds(state); });
+}
+
+bool AssetLoader::isFinished() const
+{
+    for (bool assetLoaded : loaded)
+    {
+        if (!assetLoaded)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetLoader::complete(const std::shared_ptr<Shared> &shared, Asset asset)
+{
+    const qint64 elapsedMs = shared->clock.elapsed();
+    // Posted under the lock: the owner cannot be destroyed in between, and its pending events die with it
+    std::lock_guard<std::mutex> lock(shared->ownerMutex);
+    AssetLoader *owner = shared->owner;
+    if (!owner)
+    {
+        return;
+    }
+    QMetaObject::invokeMethod(owner, [owner, asset, elapsedMs]() { owner->announce(asset, elapsedMs); }, Qt::QueuedConnection);
+}
+
+void AssetLoader::announce(Asset asset, qint64 elapsedMs)
+{
+    loaded[asset] = true;
+    qDebug() << "Asset loaded:" << ASSET_NAMES[asset] << "in" << elapsedMs << "ms";
+    emit assetLoaded(asset);
+    if (isFinished())
+    {
+        qDebug() << "All assets loaded in" << shared->clock.elapsed() << "ms";
+        emit finished();
+    }
+}
+
+void AssetLoader::loadTextures(const std::shared_ptr<Shared> &shared)
+{
+    if (shared->cancelled)
+    {
+        return;
+    }
+    const AssetRegistry &assets = AssetRegistry::get();
+
+    // The atlas and its mipmaps are cached, keyed by the source files: JPEGs are only decoded when they change
+    QStringList &textureAssets = shared->textureAssets;
+    for (const char *name : TEXTURE_NAMES)
+    {
+        textureAssets << QString("textures/%1.jpg").arg(name);
+    }
+    for (const char *name : BACKUP_TEXTURE_NAMES)
+    {
+        textureAssets << QString("textures/%1.jpg").arg(name);
+    }
+    QStringList sourcePaths;
+    for (const QString &name : textureAssets)
+    {
+        sourcePaths << assets.root() + "/" + name;
+    }
+    shared->textureCachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + TEXTURE_CACHE_FILE;
+    shared->textureKey = TextureAtlas::sourceKey(sourcePaths);
+
+    if (shared->atlas.load(shared->textureCachePath, shared->textureKey))
+    {
+        qDebug() << "Texture atlas loaded from cache:" << shared->textureCachePath;
+        complete(shared, Textures);
+        return;
+    }
+
+    // Each JPEG is decoded by its own task, the last one to finish builds the atlas
+    shared->decodedImages.resize(textureAssets.size());
+    shared->pendingImages = static_cast<int>(textureAssets.size());
+    for (int i = 0; i < textureAssets.size(); ++i)
+    {
+        std::shared_ptr<Shared> state = shared;
+        QThreadPool::globalInstance()->start([state, i]() { decodeTexture(state, i); });
+    }
+}
+
+void AssetLoader::decodeTexture(const std::shared_ptr<Shared> &shared, int index)
+{
+    // Decoded straight from the asset bytes (the mapped archive when packed); skipped once the window is gone
+    if (!shared->cancelled)
+    {
+        shared->decodedImages[index] = QImage::fromData(AssetRegistry::get().data(shared->textureAssets[index]));
+    }
+    // acq_rel: the last task sees every other task's image
+    if (shared->pendingImages.fetch_sub(1, std::memory_order_acq_rel) == 1 && !shared->cancelled)
+    {
+        buildAtlas(*shared);
+        complete(shared, Textures);
+    }
+}
+
+void AssetLoader::buildAtlas(Shared &shared)
+{
+    std::vector<QImage> &images = shared.decodedImages;
+
+    // Try loading backup textures if original textures failed
+    if (images[0].isNull())
+    {
+        qWarning() << "Failed to load apple.jpg, trying backup red.jpg";
+        images[0] = images[TEXTURE_COUNT];
+    }
+    if (images[1].isNull())
+    {
+        qWarning() << "Failed to load orange.jpg, trying backup orange_alt.jpg";
+        images[1] = images[TEXTURE_COUNT + 1];
+    }
+    images.resize(images.size() - BACKUP_TEXTURE_COUNT);
+
+    // check if images are loaded correctly
+    bool allLoaded = true;
+    for (QImage &image : images)
+    {
+        allLoaded = allLoaded && !image.isNull();
+    }
+    if (!allLoaded)
+    {
+        qCritical() << "Error loading texture images";
+
+        // Create fallback colored textures
+        images[0] = createColorTexture(QColor(255, 0, 0));     // Red for apple
+        images[1] = createColorTexture(QColor(255, 165, 0));   // Orange
+        images[2] = createColorTexture(QColor(255, 255, 0));   // Yellow for banana
+        images[3] = createColorTexture(QColor(0, 255, 0));     // Green for pear
+        images[4] = createColorTexture(QColor(50, 50, 50));    // Dark gray for bomb
+        images[5] = createColorTexture(QColor(0, 0, 255));     // Blue for floor
+        images[6] = createColorTexture(QColor(100, 100, 100)); // Gray for cannon
+        images[7] = createColorTexture(QColor(255, 255, 255)); // White for blade
+        images[8] = createColorTexture(QColor(150, 75, 0));    // Brown for handle
+        images[9] = createColorTexture(QColor(128, 128, 128)); // Gray for chain
+    }
+
+    std::vector<QImage> atlasImages;
+    for (int i = 0; i < TEXTURE_COUNT; ++i)
+    {
+        if (i != FLOOR_TEXTURE)
+        {
+            atlasImages.push_back(images[i]);
+        }
+    }
+    shared.atlas.build(atlasImages, {images[FLOOR_TEXTURE]});
+    if (!shared.atlas.save(shared.textureCachePath, shared.textureKey))
+    {
+        qWarning() << "Could not write the texture cache:" << shared.textureCachePath;
+    }
+
+    // The decoded images are no longer needed once the atlas holds them
+    images.clear();
+}
+
+void AssetLoader::loadCascades(const std::shared_ptr<Shared> &shared)
+{
+    if (shared->cancelled)
+    {
+        return;
+    }
+    shared->cascades = CameraHandler::loadCascadeSet(CameraHandler::configuredCascadeSet());
+    complete(shared, Cascades);
+}
+
+void AssetLoader::loadSounds(const std::shared_ptr<Shared> &shared)
+{
+    const AssetRegistry &assets = AssetRegistry::get();
+    shared->soundsFound = assets.contains("sounds/fruit_slice.wav") && assets.contains("sounds/cannon-shot.wav");
+    if (!shared->soundsFound)
+    {
+        qCritical() << "Cannot find the sound files in" << assets.root();
+    }
+    complete(shared, Sounds);
+}
@@ -0,0 +1,186 @@
+/**
+ * @file assetloader.h
+ * @brief Déclaration de la classe AssetLoader.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "camerahandler.h"
+#include "textureatlas.h"
+
+/**
+ * @class AssetLoader
+ * @brief Charge les ressources d'une partie (textures, classificateurs, sons) en parallèle, pendant le compte à rebours.
+ *
+ * Le chargement démarre dès la construction de GameWindow, sur le pool de threads global : chaque JPEG est
+ * décodé par sa propre tâche (ou l'atlas est lu dans son cache), les classificateurs XML sont analysés
+ * et les sons sont cherchés dans l'AssetRegistry. Seul ce qui demande le thread graphique reste à GameWidget :
+ * l'envoi de l'atlas au GPU dans son contexte OpenGL et la création des QSoundEffect. Les textures ne sont
+ * pas chargées si une partie précédente les a déjà envoyées au GPU (GameWidget::sharedTexturesUploaded()).
+ *
+ * Chaque ressource est annoncée par assetLoaded() sur le thread graphique, avec son temps de chargement
+ * affiché dans la console ; finished() suit la dernière.
+ *
+ * Les tâches n'écrivent que dans un état partagé (Shared) : une fenêtre fermée pendant le chargement
+ * détruit son loader sans attendre, les tâches en cours finissent seules et leurs annonces sont abandonnées.
+ */
+class AssetLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum Asset
+     * @brief Ressources chargées, chacune annoncée séparément.
+     */
+    enum Asset
+    {
+        Textures,   ///< Atlas des textures et page du sol, prêts à envoyer (textureAtlas()), sauf si start() ne les charge pas.
+        Cascades,   ///< Classificateurs de détection de main (takeCascades()).
+        Sounds,     ///< Effets sonores (hasSounds()).
+        AssetCount
+    };
+    Q_ENUM(Asset)
+
+    static constexpr int TEXTURE_COUNT = 10;    ///< Nombre de textures du jeu.
+    static constexpr int FLOOR_TEXTURE = 5;     ///< Texture du sol, répétée, gardée hors de l'atlas.
+
+    /**
+     * @brief Nom d'une texture du jeu (nom du fichier sans ".jpg", et nom dans GLResourceRegistry).
+     * @param texture Indice de la texture, de 0 à TEXTURE_COUNT - 1.
+     */
+    static const char *textureName(int texture);
+
+    /**
+     * @brief Constructeur de AssetLoader.
+     * @param parent Objet parent, nullptr par défaut.
+     */
+    explicit AssetLoader(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructeur de AssetLoader.
+     * N'attend pas les tâches en cours : elles s'arrêtent au plus tôt, et les ressources qu'elles n'ont pas encore annoncées sont abandonnées.
+     */
+    ~AssetLoader();
+
+    /**
+     * @brief Lance le chargement de toutes les ressources. Sans effet s'il est déjà lancé.
+     * @param withTextures false si les textures sont déjà sur le GPU : Textures est alors annoncé sans rien charger.
+     */
+    void start(bool withTextures = true);
+
+    /**
+     * @brief Indique si une ressource a été annoncée (assetLoaded()).
+     */
+    bool isLoaded(Asset asset) const { return loaded[asset]; }
+
+    /**
+     * @brief Indique si toutes les ressources ont été annoncées.
+     */
+    bool isFinished() const;
+
+    /**
+     * @brief Atlas des textures, avec ses mipmaps. Valide une fois Textures annoncé.
+     */
+    const TextureAtlas &textureAtlas() const { return shared->atlas; }
+
+    /**
+     * @brief Récupère les classificateurs chargés. À appeler une fois Cascades annoncé ; le loader ne les garde pas.
+     */
+    std::vector<CameraHandler::HandCascade> takeCascades() { return std::move(shared->cascades); }
+
+    /**
+     * @brief Indique si les effets sonores ont été trouvés dans l'AssetRegistry. Valide une fois Sounds annoncé.
+     */
+    bool hasSounds() const { return shared->soundsFound; }
+
+signals:
+    /**
+     * @brief Émis sur le thread graphique quand une ressource est prête.
+     * @param asset Ressource chargée.
+     */
+    void assetLoaded(AssetLoader::Asset asset);
+
+    /**
+     * @brief Émis sur le thread graphique après la dernière ressource.
+     */
+    void finished();
+
+private:
+    /**
+     * @struct Shared
+     * @brief État du chargement, partagé avec les tâches qui peuvent survivre au loader.
+     * Écrit par les tâches ; lu sur le thread graphique une fois la ressource annoncée.
+     */
+    struct Shared
+    {
+        QElapsedTimer clock;                ///< Démarré par start(), pour les temps de chargement.
+        std::mutex ownerMutex;              ///< Protège owner.
+        AssetLoader *owner = nullptr;       ///< Loader à prévenir, nullptr une fois détruit.
+        std::atomic<bool> cancelled{false}; ///< true une fois le loader détruit : les tâches restantes ne font plus rien.
+        TextureAtlas atlas;                 ///< Atlas et page du sol.
+        QStringList textureAssets;          ///< Images sources dans l'AssetRegistry : les textures du jeu puis leurs remplaçantes.
+        QString textureCachePath;           ///< Fichier de cache de l'atlas.
+        QByteArray textureKey;              ///< Empreinte des images sources.
+        std::vector<QImage> decodedImages;  ///< Images décodées, dans l'ordre de textureAssets.
+        std::atomic<int> pendingImages{0};  ///< Décodages en cours ; le dernier construit l'atlas.
+        std::vector<CameraHandler::HandCascade> cascades; ///< Classificateurs chargés.
+        bool soundsFound = false;           ///< Effets sonores présents.
+    };
+
+    std::shared_ptr<Shared> shared; ///< État partagé avec les tâches.
+    bool started = false; ///< true une fois start() appelé.
+    bool loaded[AssetCount] = {}; ///< Ressources annoncées (thread graphique).
+
+    /**
+     * @brief Tâche des textures : lit l'atlas dans son cache, ou lance un décodage par image.
+     */
+    static void loadTextures(const std::shared_ptr<Shared> &shared);
+
+    /**
+     * @brief Tâche de décodage d'une image source. La dernière terminée construit l'atlas.
+     * @param index Indice dans textureAssets.
+     */
+    static void decodeTexture(const std::shared_ptr<Shared> &shared, int index);
+
+    /**
+     * @brief Construit l'atlas à partir des images décodées (avec remplaçantes et couleurs de secours) et l'enregistre dans le cache.
+     */
+    static void buildAtlas(Shared &shared);
+
+    /**
+     * @brief Tâche des classificateurs : analyse les fichiers XML de CameraHandler::configuredCascadeSet().
+     */
+    static void loadCascades(const std::shared_ptr<Shared> &shared);
+
+    /**
+     * @brief Tâche des sons : vérifie que les effets sonores sont présents.
+     */
+    static void loadSounds(const std::shared_ptr<Shared> &shared);
+
+    /**
+     * @brief Annonce une ressource sur le thread graphique, si le loader existe encore. Appelable depuis n'importe quel thread.
+     * @param asset Ressource chargée.
+     */
+    static void complete(const std::shared_ptr<Shared> &shared, Asset asset);
+
+    /**
+     * @brief Marque une ressource comme chargée et émet les signaux (thread graphique).
+     * @param asset Ressource chargée.
+     * @param elapsedMs Temps de chargement.
+     */
+    void announce(Asset asset, qint64 elapsedMs);
+};
+
+#endif // ASSETLOADER_H
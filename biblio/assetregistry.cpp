@@ -0,0 +1,209 @@
+#include "assetregistry.h"
+#include "launchoptions.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QResource>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+// Constants
+const char *const ARCHIVE_FILE = "assets.rcc";
+const char *const ARCHIVE_ROOT = ":/assets";
+const char *const ROOT_MARKER = "fist.xml"; // Every assets directory has the default cascade
+
+const AssetRegistry &AssetRegistry::get()
+{
+    static const AssetRegistry registry;
+    return registry;
+}
+
+AssetRegistry::AssetRegistry()
+{
+    QElapsedTimer timer;
+    timer.start();
+    const QString appDir = QCoreApplication::applicationDirPath();
+
+    // --assets names an archive or a directory
+    const QString option = LaunchOptions::get().assets;
+    if (!option.isEmpty())
+    {
+        if (QFileInfo(option).isDir())
+        {
+            rootPath = QDir::cleanPath(QFileInfo(option).absoluteFilePath());
+        }
+        else if (!openArchive(option))
+        {
+            qWarning() << "Cannot open asset archive" << option;
+        }
+    }
+
+    // The archive built with the program: next to the executable, inside a macOS bundle, or next to the bundle
+    if (rootPath.isEmpty())
+    {
+        const QStringList archives = {
+            appDir + "/" + ARCHIVE_FILE,
+            appDir + "/../Resources/" + ARCHIVE_FILE,
+            appDir + "/../../../" + ARCHIVE_FILE};
+        for (const QString &fileName : archives)
+        {
+            if (QFile::exists(fileName) && openArchive(fileName))
+            {
+                break;
+            }
+        }
+    }
+
+    // Loose assets directory, when running from the build or source tree
+    if (rootPath.isEmpty())
+    {
+        QStringList possibleRoots = {
+            appDir + "/../Resources/assets",        // macOS bundle
+            appDir + "/assets",                     // Copied next to the executable by CMake
+            appDir + "/../../../biblio/assets",
+            "assets", "../assets", "../../assets", "../../../assets",
+            "biblio/assets", "../biblio/assets", "../../biblio/assets", "../../../biblio/assets"};
+        const QString dataLocation = QStandardPaths::locate(QStandardPaths::AppDataLocation, "assets", QStandardPaths::LocateDirectory);
+        if (!dataLocation.isEmpty())
+        {
+            possibleRoots << dataLocation;
+        }
+
+        for (const QString &root : possibleRoots)
+        {
+            if (QFile::exists(root + "/" + ROOT_MARKER))
+            {
+                rootPath = QDir::cleanPath(QFileInfo(root).absoluteFilePath());
+                break;
+            }
+        }
+
+        if (rootPath.isEmpty())
+        {
+            qCritical() << "Cannot find the assets directory. Tried paths:";
+            for (const QString &root : possibleRoots)
+            {
+                qCritical() << " - " << root;
+            }
+        }
+    }
+
+    index();
+    qDebug() << "Assets:" << files.size() << "files in" << rootPath << (packed ? "(packed)" : "(directory)")
+             << "resolved in" << timer.elapsed() << "ms";
+}
+
+bool AssetRegistry::openArchive(const QString &fileName)
+{
+    archive.setFileName(fileName);
+    if (!archive.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    // Registered in place: resources are read straight from the mapping
+    const uchar *mapped = archive.map(0, archive.size());
+    if (!mapped || !QResource::registerResource(mapped))
+    {
+        archive.close();
+        return false;
+    }
+    if (!QFileInfo(ARCHIVE_ROOT).isDir())
+    {
+        QResource::unregisterResource(mapped);
+        archive.close();
+        return false;
+    }
+
+    // Copies extracted by localFile() belong to this version of the archive
+    const QFileInfo info(fileName);
+    extractRoot = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+                  QString("/assets-%1-%2").arg(info.size(), 0, 16).arg(info.lastModified().toMSecsSinceEpoch(), 0, 16);
+    rootPath = ARCHIVE_ROOT;
+    packed = true;
+    return true;
+}
+
+void AssetRegistry::index()
+{
+    if (rootPath.isEmpty())
+    {
+        return;
+    }
+
+    QDirIterator it(rootPath, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        const QString filePath = it.next();
+        files.insert(filePath.mid(rootPath.size() + 1), it.fileInfo().size());
+    }
+}
+
+QString AssetRegistry::path(const QString &name) const
+{
+    return contains(name) ? rootPath + "/" + name : QString();
+}
+
+QUrl AssetRegistry::url(const QString &name) const
+{
+    if (!contains(name))
+    {
+        return QUrl();
+    }
+    return packed ? QUrl("qrc" + path(name)) : QUrl::fromLocalFile(path(name));
+}
+
+QByteArray AssetRegistry::data(const QString &name) const
+{
+    if (!contains(name))
+    {
+        return QByteArray();
+    }
+
+    if (packed)
+    {
+        // The archive is built uncompressed, so the bytes are those of the mapping
+        QResource resource(path(name));
+        if (resource.compressionAlgorithm() == QResource::NoCompression)
+        {
+            return QByteArray::fromRawData(reinterpret_cast<const char *>(resource.data()), resource.size());
+        }
+        return resource.uncompressedData();
+    }
+
+    QFile file(path(name));
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+QString AssetRegistry::localFile(const QString &name) const
+{
+    if (!contains(name))
+    {
+        return QString();
+    }
+    if (!packed)
+    {
+        return path(name);
+    }
+
+    std::lock_guard<std::mutex> lock(extractMutex);
+    const QString target = extractRoot + "/" + name;
+    const QFileInfo info(target);
+    if (info.exists() && info.size() == files.value(name))
+    {
+        return target;
+    }
+
+    QDir().mkpath(info.absolutePath());
+    QSaveFile file(target);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data(name)) != files.value(name) || !file.commit())
+    {
+        qWarning() << "Could not extract" << name << "to" << target;
+        return QString();
+    }
+    return target;
+}
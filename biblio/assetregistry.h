@@ -0,0 +1,110 @@
+/**
+ * @file assetregistry.h
+ * @brief Déclaration de la classe AssetRegistry.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef ASSETREGISTRY_H
+#define ASSETREGISTRY_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QUrl>
+#include <mutex>
+
+/**
+ * @class AssetRegistry
+ * @brief Emplacement unique des ressources du jeu (classificateurs, textures, sons, police, rapport).
+ *
+ * Les ressources sont nommées par leur chemin dans le dossier assets (par ex. "sounds/fruit_slice.wav").
+ * Elles sont trouvées une seule fois par processus, dans cet ordre :
+ * - l'archive ou le dossier donné par --assets (BIBLIO_ASSETS) ;
+ * - l'archive assets.rcc construite avec le programme (qt_add_binary_resources), à côté de l'exécutable ;
+ * - le premier dossier assets trouvé près de l'exécutable ou du dossier courant.
+ *
+ * L'archive est projetée en mémoire et enregistrée comme ressource Qt non compressée : data() renvoie
+ * les octets de l'archive sans copie, et path() un chemin ":/assets/..." accepté par QImage, QFile ou
+ * QFontDatabase. Le contenu est listé une fois à l'ouverture, contains() ne touche plus au disque.
+ */
+class AssetRegistry
+{
+public:
+    /**
+     * @brief Registre du processus, ouvert au premier appel (sûr entre threads).
+     */
+    static const AssetRegistry &get();
+
+    /**
+     * @brief Indique si les ressources viennent d'une archive.
+     */
+    bool isPacked() const { return packed; }
+
+    /**
+     * @brief Dossier racine des ressources (":/assets" pour une archive), vide si rien n'a été trouvé.
+     */
+    QString root() const { return rootPath; }
+
+    /**
+     * @brief Indique si une ressource existe, sans accès au disque.
+     * @param name Chemin relatif au dossier assets.
+     */
+    bool contains(const QString &name) const { return files.contains(name); }
+
+    /**
+     * @brief Chemin d'une ressource, utilisable par les classes de Qt (QFile, QImage, QFontDatabase...).
+     * @param name Chemin relatif au dossier assets.
+     * @return Chemin dans l'archive ou sur le disque ; vide si la ressource n'existe pas.
+     */
+    QString path(const QString &name) const;
+
+    /**
+     * @brief URL d'une ressource (qrc: ou file:), pour QSoundEffect ou QDesktopServices.
+     * @param name Chemin relatif au dossier assets.
+     * @return URL vide si la ressource n'existe pas.
+     */
+    QUrl url(const QString &name) const;
+
+    /**
+     * @brief Contenu d'une ressource.
+     * @param name Chemin relatif au dossier assets.
+     * @return Octets de l'archive projetée, sans copie ; lus depuis le disque sans archive ; vide si la ressource n'existe pas.
+     */
+    QByteArray data(const QString &name) const;
+
+    /**
+     * @brief Fichier réel d'une ressource, pour les bibliothèques qui ne lisent que des fichiers (OpenCV, visionneuse PDF).
+     * Depuis une archive, la ressource est extraite une fois dans le dossier de cache.
+     * @param name Chemin relatif au dossier assets.
+     * @return Chemin absolu ; vide si la ressource n'existe pas ou n'a pas pu être extraite.
+     */
+    QString localFile(const QString &name) const;
+
+private:
+    QString rootPath; ///< Dossier racine, terminé sans "/".
+    bool packed = false; ///< true si les ressources viennent d'une archive.
+    QFile archive; ///< Archive ouverte, projetée en mémoire tant que le processus tourne.
+    QString extractRoot; ///< Dossier du cache où localFile() extrait les ressources de cette archive.
+    QHash<QString, qint64> files; ///< Ressources disponibles et leur taille, listées à l'ouverture.
+    mutable std::mutex extractMutex; ///< Protège les extractions de localFile().
+
+    /**
+     * @brief Trouve et liste les ressources (appelé une fois par get()).
+     */
+    AssetRegistry();
+
+    /**
+     * @brief Projette une archive .rcc en mémoire et l'enregistre sous ":/".
+     * @param fileName Fichier de l'archive.
+     * @return true si l'archive est valide et contient un dossier assets.
+     */
+    bool openArchive(const QString &fileName);
+
+    /**
+     * @brief Liste le contenu du dossier racine.
+     */
+    void index();
+};
+
+#endif // ASSETREGISTRY_H
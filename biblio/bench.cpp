@@ -0,0 +1,265 @@
+// Headless per-stage latency benchmark: runs the camera-to-collision pipeline without a window
+// and writes p50/p95/p99 for each stage as JSON, so that builds can be compared.
+// Only GL-free units are linked: fruits are simulated through GameGeometry, as Fruit does.
+
+#include "camerahandler.h"
+#include "framesource.h"
+#include "gamegeometry.h"
+#include "samplestats.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Constants
+const int DEFAULT_ITERATIONS = 300;
+const int DEFAULT_FRUITS = 20;
+const int SIMULATED_FRAME_MS = 16;  // Game time advanced per iteration (one 60 Hz tick)
+const char *const DEFAULT_OUTPUT = "biblio_bench.json";
+
+// A fruit in flight, as far as the collision path is concerned (Fruit without its meshes and textures)
+struct BenchFruit
+{
+    int launchMs;
+    QVector3D speed;
+
+    explicit BenchFruit(int timeMs) : launchMs(timeMs), speed(GameGeometry::randomLaunchSpeed()) {}
+
+    QVector3D position(int nowMs) const
+    {
+        return GameGeometry::fruitTrajectory(GameGeometry::launchPosition(), speed, nowMs - launchMs);
+    }
+};
+
+// Stage names, in pipeline order
+static const char *const STAGES[] = {"capture", "color_conversion", "detect_faces",
+                                     "convert_camera_point", "fruit_hit_all", "fruit_physics"};
+
+static QJsonObject summarize(const std::vector<double> &samples)
+{
+    QJsonObject summary;
+    summary["samples"] = static_cast<int>(samples.size());
+    summary["mean_ms"] = SampleStats::mean(samples);
+    summary["p50_ms"] = SampleStats::percentile(samples, 0.50);
+    summary["p95_ms"] = SampleStats::percentile(samples, 0.95);
+    summary["p99_ms"] = SampleStats::percentile(samples, 0.99);
+    summary["max_ms"] = samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end());
+    return summary;
+}
+
+// Textured background with a hand-sized skin-colored blob moving along a circle
+static void drawSyntheticFrame(const cv::Mat &background, int iteration, cv::Mat &frame)
+{
+    background.copyTo(frame);
+    double angle = iteration * 0.05;
+    cv::Point center(static_cast<int>(frame.cols / 2 + frame.cols / 4 * std::cos(angle)),
+                     static_cast<int>(frame.rows / 2 + frame.rows / 4 * std::sin(angle)));
+    cv::ellipse(frame, center, cv::Size(frame.cols / 12, frame.rows / 8), 0, 0, 360, cv::Scalar(120, 160, 210), cv::FILLED);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("biblio_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Per-stage latency benchmark of the biblio camera and collision pipeline.");
+    parser.addHelpOption();
+    QCommandLineOption inputOption("input", "Video file or directory of images to replay (synthetic frames if omitted).", "path");
+    QCommandLineOption iterationsOption("iterations", "Number of frames to run.", "n", QString::number(DEFAULT_ITERATIONS));
+    QCommandLineOption fruitsOption("fruits", "Number of fruits in flight.", "n", QString::number(DEFAULT_FRUITS));
+    QCommandLineOption sizeOption("size", "Synthetic frame size.", "WxH", "640x480");
+    QCommandLineOption modeOption("mode", "Detection mode: full, roi or flow.", "mode", "flow");
+    // Detection and asset loading may print while the benchmark runs: the report goes to a file unless "-" is given
+    QCommandLineOption outputOption("output", "Write the JSON report to this file, or to stdout with \"-\".", "file", DEFAULT_OUTPUT);
+    parser.addOptions({inputOption, iterationsOption, fruitsOption, sizeOption, modeOption, outputOption});
+    parser.process(app);
+
+    const int iterations = std::max(1, parser.value(iterationsOption).toInt());
+    const int fruitCount = std::max(0, parser.value(fruitsOption).toInt());
+    const QString input = parser.value(inputOption);
+    const QString mode = parser.value(modeOption);
+
+    // Replay every frame of the clip, in order and without pacing
+    std::unique_ptr<FrameSource> source;
+    if (!input.isEmpty())
+    {
+        source = FrameSource::create(input, 0.0, true);
+        if (!source)
+        {
+            std::cerr << "Cannot read input " << input.toStdString() << std::endl;
+            return 2;
+        }
+    }
+
+    cv::Mat background;
+    if (!source)
+    {
+        const QStringList size = parser.value(sizeOption).split('x');
+        const int width = size.value(0).toInt() > 0 ? size.value(0).toInt() : 640;
+        const int height = size.value(1).toInt() > 0 ? size.value(1).toInt() : 480;
+        background.create(height, width, CV_8UC3);
+        cv::RNG rng(42);
+        rng.fill(background, cv::RNG::UNIFORM, cv::Scalar::all(40), cv::Scalar::all(90));
+        cv::GaussianBlur(background, background, cv::Size(5, 5), 0);
+    }
+
+    CameraHandler cameraHandler;
+    if (mode == "full")
+    {
+        cameraHandler.setDetectionMode(CameraHandler::DetectionMode::FullFrame);
+    }
+    else if (mode == "roi")
+    {
+        cameraHandler.setDetectionMode(CameraHandler::DetectionMode::RoiTracking);
+    }
+    else
+    {
+        cameraHandler.setDetectionMode(CameraHandler::DetectionMode::OpticalFlow);
+    }
+    cameraHandler.setDetectionPyramidLevel(CameraHandler::AUTO_DETECTION_LEVEL);
+
+    // Deterministic fruit launches on a simulated clock, in plain milliseconds (QTime would wrap at midnight)
+    srand(42);
+    std::vector<BenchFruit> fruits;
+    for (int i = 0; i < fruitCount; ++i)
+    {
+        // Staggered launches so fruits are spread along their trajectories
+        fruits.emplace_back(-i * 150);
+    }
+
+    std::map<std::string, std::vector<double>> timings;
+    auto elapsedMs = [](std::chrono::steady_clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+    };
+
+    cv::Mat frame;
+    cv::Mat grayFrame;
+    uint64_t hands = 0;
+    uint64_t hits = 0;
+    for (int iteration = 0; iteration < iterations; ++iteration)
+    {
+        const int now = iteration * SIMULATED_FRAME_MS;
+
+        auto start = std::chrono::steady_clock::now();
+        if (source)
+        {
+            frame.release();
+            if (!source->grab() || !source->retrieve(frame))
+            {
+                std::cerr << "Input ended at iteration " << iteration << std::endl;
+                break;
+            }
+        }
+        else
+        {
+            drawSyntheticFrame(background, iteration, frame);
+        }
+        timings["capture"].push_back(elapsedMs(start));
+
+        start = std::chrono::steady_clock::now();
+        cv::cvtColor(frame, grayFrame, cv::COLOR_BGR2GRAY);
+        timings["color_conversion"].push_back(elapsedMs(start));
+
+        start = std::chrono::steady_clock::now();
+        std::vector<cv::Point> points = cameraHandler.detectFaces(frame, grayFrame, false);
+        timings["detect_faces"].push_back(elapsedMs(start));
+        hands += points.size();
+
+        // Without a hand, still time the collision path from the frame center
+        if (points.empty())
+        {
+            points.emplace_back(frame.cols / 2, frame.rows / 2);
+        }
+
+        start = std::chrono::steady_clock::now();
+        std::vector<QVector3D> katanaPositions;
+        for (const cv::Point &point : points)
+        {
+            katanaPositions.push_back(GameGeometry::projectCameraPoint(point, frame.size()));
+        }
+        timings["convert_camera_point"].push_back(elapsedMs(start));
+
+        start = std::chrono::steady_clock::now();
+        for (const QVector3D &katana : katanaPositions)
+        {
+            for (const BenchFruit &fruit : fruits)
+            {
+                if (GameGeometry::isKatanaHit(katana, fruit.position(now)))
+                {
+                    ++hits;
+                }
+            }
+        }
+        timings["fruit_hit_all"].push_back(elapsedMs(start));
+
+        // Same fall-and-respawn step as GameWidget::paintGL
+        start = std::chrono::steady_clock::now();
+        for (BenchFruit &fruit : fruits)
+        {
+            if (fruit.position(now).y() < 0)
+            {
+                fruit = BenchFruit(now);
+            }
+        }
+        timings["fruit_physics"].push_back(elapsedMs(start));
+    }
+
+    QJsonObject stages;
+    double pipelineP50 = 0.0;
+    for (const char *stage : STAGES)
+    {
+        QJsonObject summary = summarize(timings[stage]);
+        pipelineP50 += summary["p50_ms"].toDouble();
+        stages[stage] = summary;
+    }
+
+    QJsonObject config;
+    config["input"] = source ? source->description() : QString("synthetic %1x%2").arg(background.cols).arg(background.rows);
+    config["iterations"] = iterations;
+    config["fruits"] = fruitCount;
+    config["detection_mode"] = mode;
+#ifdef NDEBUG
+    config["build"] = "release";
+#else
+    config["build"] = "debug";
+#endif
+
+    QJsonObject report;
+    report["config"] = config;
+    report["stages"] = stages;
+    report["stage_order"] = QJsonArray::fromStringList({STAGES[0], STAGES[1], STAGES[2], STAGES[3], STAGES[4], STAGES[5]});
+    report["sum_of_p50_ms"] = pipelineP50;
+    report["hands_detected"] = static_cast<double>(hands);
+    report["fruit_hits"] = static_cast<double>(hits);
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    const QString outputPath = parser.value(outputOption);
+    if (outputPath == "-")
+    {
+        std::cout << json.constData();
+    }
+    else
+    {
+        QFile output(outputPath);
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            std::cerr << "Cannot write " << outputPath.toStdString() << std::endl;
+            return 2;
+        }
+        output.write(json);
+        std::cerr << "Report written to " << outputPath.toStdString() << std::endl;
+    }
+    return 0;
+}
@@ -1,18 +1,122 @@
 #include "camerahandler.h"
+#include "gamelog.h"
+#include "launchoptions.h"
+#include "assetregistry.h"
 #include <QDebug>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <vector>
-#include <QCoreApplication>
-#include <QDir>
-#include <QStandardPaths>
 
-CameraHandler::CameraHandler()
+// Constants
+const float ROI_SCALE = 2.5f;         // Search window size, in hand sizes around the predicted center
+const float ROI_VELOCITY_MARGIN = 2.0f; // Extra window size per pixel/frame of predicted motion
+const int MIN_HAND_SIZE = 30;         // Smallest hand the cascade looks for (pixels)
+const int MAX_HAND_SIZE = 300;        // Largest hand the cascade looks for (pixels)
+const double FUSION_IOU = 0.3;        // Overlap above which boxes from the ensemble are the same hand
+const int FLOW_MAX_POINTS = 40;       // Feature points seeded inside the hand box
+const size_t FLOW_MIN_POINTS = 6;     // Fewer surviving points than this means the track is lost
+const float FLOW_MIN_CONFIDENCE = 0.5f; // Minimum fraction of points passing the forward-backward check
+const float FLOW_MAX_FB_ERROR = 1.0f; // Forward-backward round trip error allowed per point (pixels)
+const double LATENCY_SMOOTHING = 0.1; // Weight of the newest sample in the capture timing averages
+const int CAMERA_DEVICE = 0;          // Index of the camera opened by openCamera()
+
+// Capture modes probed on each device, kept for the whole process: probing restarts the stream for every
+// mode tried, which takes seconds, and every game and settings window opens its own CameraHandler
+static std::mutex probeMutex;
+static std::map<int, std::vector<CaptureProfile>> probedDevices;
+
+// Intersection over union of two boxes
+static double overlapRatio(const cv::Rect &a, const cv::Rect &b)
+{
+    double intersection = (a & b).area();
+    double unionArea = a.area() + b.area() - intersection;
+    return unionArea > 0 ? intersection / unionArea : 0.0;
+}
+
+// FOURCC code of a four-character format name
+static int fourccCode(const char *name)
 {
-    loadFaceCascade();
+    return cv::VideoWriter::fourcc(name[0], name[1], name[2], name[3]);
+}
+
+// Packed 4:2:2 formats: Y interleaved with chroma, two bytes per pixel
+static bool isPacked422(int fourcc)
+{
+    return fourcc == fourccCode("YUYV") || fourcc == fourccCode("YUY2") || fourcc == fourccCode("UYVY");
+}
+
+// Planar and semi-planar 4:2:0 formats: a full Y plane followed by quarter-size chroma
+static bool isPlanar420(int fourcc)
+{
+    return fourcc == fourccCode("NV12") || fourcc == fourccCode("NV21") || fourcc == fourccCode("YU12")
+           || fourcc == fourccCode("I420") || fourcc == fourccCode("YV12");
+}
+
+// Formats whose luma can be handed to detection without a BGR round trip
+static bool hasLumaPlane(int fourcc)
+{
+    return isPacked422(fourcc) || isPlanar420(fourcc) || fourcc == fourccCode("GREY")
+           || fourcc == fourccCode("Y800") || fourcc == fourccCode("MJPG");
+}
+
+// Y plane of a raw driver buffer; shares the buffer for planar and gray formats, empty if the layout is not recognized
+static cv::Mat extractLuma(const cv::Mat &raw, int fourcc, const cv::Size &size)
+{
+    if (raw.empty() || !raw.isContinuous())
+    {
+        return cv::Mat();
+    }
+    if (fourcc == fourccCode("MJPG"))
+    {
+        // libjpeg decodes only the luma component: no chroma upsampling, no color conversion
+        return cv::imdecode(raw, cv::IMREAD_GRAYSCALE);
+    }
+
+    const size_t bytes = raw.total() * raw.elemSize();
+    const size_t pixels = static_cast<size_t>(size.area());
+    if (pixels == 0)
+    {
+        return cv::Mat();
+    }
+    if ((fourcc == fourccCode("GREY") || fourcc == fourccCode("Y800")) && bytes == pixels)
+    {
+        return raw.reshape(1, size.height);
+    }
+    if (isPlanar420(fourcc) && bytes == pixels * 3 / 2)
+    {
+        return raw.reshape(1, size.height * 3 / 2).rowRange(0, size.height);
+    }
+    if (isPacked422(fourcc) && bytes == pixels * 2)
+    {
+        // Y is interleaved with chroma, so this one needs a copy
+        cv::Mat gray;
+        cv::extractChannel(raw.reshape(2, size.height), gray, fourcc == fourccCode("UYVY") ? 1 : 0);
+        return gray;
+    }
+    return cv::Mat();
+}
+
+CameraHandler::CameraHandler(bool loadCascades)
+{
+    if (loadCascades) {
+        loadFaceCascade();
+    }
+
+    // Constant-velocity model on the hand center: state (x, y, vx, vy), measurement (x, y), one frame per step
+    handFilter.init(4, 2, 0, CV_32F);
+    handFilter.transitionMatrix = (cv::Mat_<float>(4, 4) << 1, 0, 1, 0,
+                                                             0, 1, 0, 1,
+                                                             0, 0, 1, 0,
+                                                             0, 0, 0, 1);
+    cv::setIdentity(handFilter.measurementMatrix);
+    cv::setIdentity(handFilter.processNoiseCov, cv::Scalar::all(1.0));
+    cv::setIdentity(handFilter.measurementNoiseCov, cv::Scalar::all(4.0));
 }
 
 CameraHandler::~CameraHandler()
 {
+    stopCapture();
     if (cap.isOpened())
     {
         cap.release();
@@ -21,64 +125,85 @@ CameraHandler::~CameraHandler()
 
 bool CameraHandler::loadFaceCascade()
 {
-    QStringList pathsToTry;
-    QString appDir = QCoreApplication::applicationDirPath();
+    return setCascadeSet(configuredCascadeSet());
+}
 
-    // Path for macOS bundle (assets inside Resources folder)
-    pathsToTry << appDir + "/../Resources/assets/fist.xml";
-    // Path if assets folder is next to the executable
-    pathsToTry << appDir + "/assets/fist.xml";
-    
-    // Paths relative to current working directory (useful for development/build dir execution)
-    pathsToTry << "assets/fist.xml";
-    pathsToTry << "../assets/fist.xml"; // If executable is in a subfolder like 'bin'
-    pathsToTry << "../../assets/fist.xml";
-    pathsToTry << "biblio/assets/fist.xml"; // If running from project root and executable is in biblio/
-    pathsToTry << "../biblio/assets/fist.xml";
-    pathsToTry << "../../biblio/assets/fist.xml";
-    pathsToTry << "./../../../biblio/assets/fist.xml";
+QStringList CameraHandler::configuredCascadeSet()
+{
+    // BIBLIO_CASCADES selects the ensemble, e.g. "fist,lpalm,rpalm"; the fist cascade alone by default
+    QStringList fileNames;
+    const QString configured = qEnvironmentVariable("BIBLIO_CASCADES");
+    for (QString name : configured.split(',', Qt::SkipEmptyParts)) {
+        name = name.trimmed();
+        if (!name.endsWith(".xml")) {
+            name += ".xml";
+        }
+        fileNames << name;
+    }
+    if (fileNames.isEmpty()) {
+        fileNames << "fist.xml";
+    }
+    return fileNames;
+}
 
-    // Path for when fist.xml is in the same directory as the executable (less likely for 'assets' structure)
-    pathsToTry << appDir + "/fist.xml";
-    pathsToTry << "fist.xml";
+bool CameraHandler::setCascadeSet(const QStringList &fileNames)
+{
+    return setCascades(loadCascadeSet(fileNames));
+}
 
+bool CameraHandler::setCascades(std::vector<HandCascade> loaded)
+{
+    cascades = std::move(loaded);
+    return !cascades.empty();
+}
 
-    for (const QString& cascadePath : pathsToTry) {
-        QFileInfo fileInfo(cascadePath);
-        qDebug() << "Attempting to load Haar Cascade from:" << QDir::cleanPath(fileInfo.absoluteFilePath());
-        if (faceCascade.load(QDir::cleanPath(fileInfo.absoluteFilePath()).toStdString())) {
-            qDebug() << "Successfully loaded Haar Cascade from:" << QDir::cleanPath(fileInfo.absoluteFilePath());
-            return true;
+std::vector<CameraHandler::HandCascade> CameraHandler::loadCascadeSet(const QStringList &fileNames)
+{
+    std::vector<HandCascade> loaded;
+    for (const QString &fileName : fileNames) {
+        HandCascade cascade;
+        cascade.name = fileName;
+        if (loadCascade(fileName, cascade.classifier)) {
+            loaded.push_back(cascade);
         }
     }
-    
-    // Attempt to locate via Qt Resource system if it were used (example, not active here)
-    // pathsToTry << ":/assets/fist.xml";
+    return loaded;
+}
 
-    // Final attempt with a path that might be set via an environment variable or a known install location
-    // This part would be specific to deployment strategy if assets are installed system-wide
-    // For example, using QStandardPaths:
-    QString dataLocation = QStandardPaths::locate(QStandardPaths::AppDataLocation, "assets/fist.xml");
-    if (!dataLocation.isEmpty()) {
-         qDebug() << "Attempting to load Haar Cascade from AppDataLocation:" << dataLocation;
-        if (faceCascade.load(dataLocation.toStdString())) {
-            qDebug() << "Successfully loaded Haar Cascade from AppDataLocation:" << dataLocation;
-            return true;
-        }
+bool CameraHandler::loadCascade(const QString &fileName, cv::CascadeClassifier &classifier)
+{
+    // OpenCV only reads files: a packed asset is extracted once by the registry
+    const QString cascadePath = AssetRegistry::get().localFile(fileName);
+    if (!cascadePath.isEmpty() && classifier.load(cascadePath.toStdString())) {
+        qDebug() << "Successfully loaded Haar Cascade from:" << cascadePath;
+        return true;
     }
 
-
-    qDebug() << "Error: Could not load Haar Cascade ('fist.xml'). All attempted paths failed.";
-    qDebug() << "Ensure 'fist.xml' is present in one of the expected 'assets' directory locations relative to the executable or build directory.";
+    qDebug() << "Error: Could not load Haar Cascade (" << fileName << ") from" << AssetRegistry::get().root();
     return false;
 }
 
 int CameraHandler::openCamera()
 {
+    // The capture thread owns 'cap' while it runs
+    stopCapture();
+
+    // A recorded input replaces the camera entirely (CI machines, benchmarks)
+    const LaunchOptions &options = LaunchOptions::get();
+    if (!options.source.isEmpty())
+    {
+        return openSource(options.source, options.sourceRate, options.sourceLoop, options.sourceFps);
+    }
+    source.reset();
+
     // First try - explicitly use AVFOUNDATION backend for macOS
-    cap.open(0, cv::CAP_AVFOUNDATION);
+    cap.open(CAMERA_DEVICE, cv::CAP_AVFOUNDATION);
     if (cap.isOpened())
+    {
+        negotiateCaptureProfile();
+        configureLumaCapture();
         return 1;
+    }
 
 // Check if camera access was denied (specific to macOS)
 #ifdef __APPLE__
@@ -94,10 +219,16 @@ int CameraHandler::openCamera()
 #endif
 
     // Second try - default camera with default backend
-    cap.open(0);
+    cap.open(CAMERA_DEVICE);
     if (cap.isOpened())
+    {
+        negotiateCaptureProfile();
+        configureLumaCapture();
         return 1;
+    }
 
+    // Network streams are decoded by FFmpeg straight to BGR
+    lumaCaptureActive = false;
     cap.open("http://192.168.1.80:8000/camera/mjpeg", cv::CAP_FFMPEG);
     if (cap.isOpened())
         return 1;
@@ -110,20 +241,314 @@ int CameraHandler::openCamera()
     return 0; 
 }
 
+int CameraHandler::openSource(const QString &location, double rate, bool loop, double sequenceFps)
+{
+    stopCapture();
+    if (cap.isOpened())
+    {
+        cap.release();
+    }
+    lumaCaptureActive = false;
+
+    source = FrameSource::create(location, rate, loop, sequenceFps);
+    if (!source)
+    {
+        return 0;
+    }
+
+    activeProfile = CaptureProfile();
+    activeProfile.width = source->frameSize().width;
+    activeProfile.height = source->frameSize().height;
+    activeProfile.fps = source->frameRate() * rate;
+    qDebug() << "Replaying" << source->description() << "at rate" << rate << (loop ? "(looping)" : "");
+    return 1;
+}
+
+void CameraHandler::negotiateCaptureProfile()
+{
+    // The mode the camera opened in, to go back to when no probed mode is selected
+    const CaptureProfile original = CaptureProfile::readFrom(cap);
+
+    // Probe each device once per process, even when it accepts none of the modes tried
+    bool probed = false;
+    {
+        std::lock_guard<std::mutex> lock(probeMutex);
+        auto known = probedDevices.find(CAMERA_DEVICE);
+        if (known == probedDevices.end())
+        {
+            known = probedDevices.emplace(CAMERA_DEVICE, CaptureProfile::probe(cap)).first;
+            probed = true;
+        }
+        supportedProfiles = known->second;
+    }
+    if (probed)
+    {
+        qDebug() << "Camera supports" << supportedProfiles.size() << "capture modes";
+        for (const CaptureProfile &profile : supportedProfiles)
+        {
+            qDebug() << "  " << profile.toString();
+        }
+    }
+
+    CaptureProfile requested = CaptureProfile::preferred();
+    if (requested.isAuto())
+    {
+        requested = CaptureProfile::selectLowestLatency(supportedProfiles);
+    }
+    if (requested.isAuto() && probed)
+    {
+        // Probing left the camera in the last mode tried
+        requested = original;
+    }
+    // Even with backend defaults, never let the driver queue frames ahead of us
+    requested.bufferSize = 1;
+
+    activeProfile = requested.applyTo(cap);
+    qDebug() << "Capture mode requested:" << requested.toString() << "obtained:" << activeProfile.toString()
+             << "buffer:" << activeProfile.bufferSize;
+}
+
+void CameraHandler::configureLumaCapture()
+{
+    lumaCaptureActive = false;
+    if (!lumaCaptureRequested)
+    {
+        return;
+    }
+
+    const int fourcc = static_cast<int>(cap.get(cv::CAP_PROP_FOURCC));
+    if (!hasLumaPlane(fourcc))
+    {
+        qDebug() << "Luma capture not supported for format" << activeProfile.fourcc << ", capturing BGR";
+        return;
+    }
+
+    // Backends that ignore the property keep converting, which shows in the read-back
+    cap.set(cv::CAP_PROP_CONVERT_RGB, 0);
+    if (cap.get(cv::CAP_PROP_CONVERT_RGB) != 0)
+    {
+        cap.set(cv::CAP_PROP_CONVERT_RGB, 1);
+        qDebug() << "Backend does not hand out raw frames, capturing BGR";
+        return;
+    }
+
+    lumaCaptureActive = true;
+    qDebug() << "Luma capture enabled, format" << activeProfile.fourcc;
+}
+
+bool CameraHandler::ensureColor(CapturedFrame &frame)
+{
+    if (!frame.image.empty())
+    {
+        return true;
+    }
+    if (frame.gray.empty())
+    {
+        return false;
+    }
+
+    const int rows = frame.gray.rows;
+    if (frame.fourcc == fourccCode("MJPG"))
+    {
+        frame.image = cv::imdecode(frame.raw, cv::IMREAD_COLOR);
+    }
+    else if (isPacked422(frame.fourcc))
+    {
+        const int code = frame.fourcc == fourccCode("UYVY") ? cv::COLOR_YUV2BGR_UYVY : cv::COLOR_YUV2BGR_YUYV;
+        cv::cvtColor(frame.raw.reshape(2, rows), frame.image, code);
+    }
+    else if (isPlanar420(frame.fourcc))
+    {
+        int code = cv::COLOR_YUV2BGR_I420;
+        if (frame.fourcc == fourccCode("NV12"))
+            code = cv::COLOR_YUV2BGR_NV12;
+        else if (frame.fourcc == fourccCode("NV21"))
+            code = cv::COLOR_YUV2BGR_NV21;
+        else if (frame.fourcc == fourccCode("YV12"))
+            code = cv::COLOR_YUV2BGR_YV12;
+        cv::cvtColor(frame.raw.reshape(1, rows * 3 / 2), frame.image, code);
+    }
+    else
+    {
+        cv::cvtColor(frame.gray, frame.image, cv::COLOR_GRAY2BGR);
+    }
+    return !frame.image.empty();
+}
+
 bool CameraHandler::isOpened() const
 {
-    return cap.isOpened();
+    // Avoid touching 'cap' from another thread while the capture thread reads it
+    if (captureRunning.load(std::memory_order_acquire))
+    {
+        return true;
+    }
+    return source || cap.isOpened();
 }
 
 bool CameraHandler::getFrame(cv::Mat &frame)
 {
-    if (!cap.isOpened())
+    if (isCapturing())
+    {
+        CapturedFrame latest;
+        if (!getLatestFrame(latest) || !ensureColor(latest))
+        {
+            return false;
+        }
+        frame = latest.image;
+        return !frame.empty();
+    }
+
+    if (!isOpened())
+    {
+        return false;
+    }
+
+    return grabFrame() && retrieveFrame(frame);
+}
+
+bool CameraHandler::startCapture()
+{
+    if (isCapturing())
+    {
+        return true;
+    }
+    if (!source && !cap.isOpened())
+    {
+        return false;
+    }
+
+    capturedFrames.store(0, std::memory_order_relaxed);
+    droppedFrames.store(0, std::memory_order_relaxed);
+    frameIntervalMs.store(0.0, std::memory_order_relaxed);
+    grabWaitMs.store(0.0, std::memory_order_relaxed);
+    captureRunning.store(true, std::memory_order_release);
+    captureThread = std::thread(&CameraHandler::captureLoop, this);
+    return true;
+}
+
+void CameraHandler::stopCapture()
+{
+    captureRunning.store(false, std::memory_order_release);
+    if (captureThread.joinable())
+    {
+        captureThread.join();
+    }
+}
+
+bool CameraHandler::isCapturing() const
+{
+    return captureRunning.load(std::memory_order_acquire);
+}
+
+bool CameraHandler::getLatestFrame(CapturedFrame &frame)
+{
+    if (!frameBuffer.update())
     {
         return false;
     }
 
-    cap >> frame;
-    return !frame.empty();
+    // Shallow copy: the capture thread never writes into a buffer it has handed out
+    frame = frameBuffer.readBuffer();
+    return !frame.image.empty() || !frame.gray.empty();
+}
+
+bool CameraHandler::grabFrame()
+{
+    return source ? source->grab() : cap.grab();
+}
+
+bool CameraHandler::retrieveFrame(cv::Mat &frame)
+{
+    return source ? source->retrieve(frame) : cap.retrieve(frame);
+}
+
+void CameraHandler::captureLoop()
+{
+    uint64_t sequence = 0;
+    std::chrono::steady_clock::time_point previousCaptureTime;
+    const int rawFourcc = lumaCaptureActive ? static_cast<int>(cap.get(cv::CAP_PROP_FOURCC)) : 0;
+    const cv::Size rawSize(activeProfile.width, activeProfile.height);
+    // An unpaced replay hands over every frame: wait for the consumer instead of overwriting
+    const bool lockstep = source && !source->isPaced();
+    bool sourceEnded = false;
+
+    while (captureRunning.load(std::memory_order_acquire))
+    {
+        if (lockstep && frameBuffer.pending())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        // grab() returns as soon as the driver hands over a frame, so timestamp right after it
+        auto grabStart = std::chrono::steady_clock::now();
+        if (!grabFrame())
+        {
+            if (source && !sourceEnded)
+            {
+                qDebug() << "Replay finished after" << sequence << "frames";
+                sourceEnded = true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+        auto captureTime = std::chrono::steady_clock::now();
+
+        // A driver holding stale frames returns from grab() immediately, so a short wait means queued lag
+        double waitMs = std::chrono::duration<double, std::milli>(captureTime - grabStart).count();
+        double averageWait = grabWaitMs.load(std::memory_order_relaxed);
+        grabWaitMs.store(averageWait == 0.0 ? waitMs : averageWait * (1.0 - LATENCY_SMOOTHING) + waitMs * LATENCY_SMOOTHING,
+                         std::memory_order_relaxed);
+        if (sequence > 0)
+        {
+            double intervalMs = std::chrono::duration<double, std::milli>(captureTime - previousCaptureTime).count();
+            double averageInterval = frameIntervalMs.load(std::memory_order_relaxed);
+            frameIntervalMs.store(averageInterval == 0.0 ? intervalMs : averageInterval * (1.0 - LATENCY_SMOOTHING) + intervalMs * LATENCY_SMOOTHING,
+                                  std::memory_order_relaxed);
+        }
+        previousCaptureTime = captureTime;
+
+        CapturedFrame &slot = frameBuffer.writeBuffer();
+        // Detach from any consumer still holding the previous image instead of overwriting it
+        slot.image.release();
+        slot.gray.release();
+        slot.raw.release();
+        slot.fourcc = 0;
+        if (lumaCaptureActive)
+        {
+            if (!cap.retrieve(slot.raw) || slot.raw.empty())
+            {
+                continue;
+            }
+            slot.gray = extractLuma(slot.raw, rawFourcc, rawSize);
+            if (!slot.gray.empty())
+            {
+                slot.fourcc = rawFourcc;
+            }
+            else if (slot.raw.type() == CV_8UC3)
+            {
+                // The backend converted after all
+                slot.image = slot.raw;
+                slot.raw.release();
+            }
+            else
+            {
+                continue;
+            }
+        }
+        else if (!retrieveFrame(slot.image) || slot.image.empty())
+        {
+            continue;
+        }
+        slot.sequence = ++sequence;
+        slot.captureTime = captureTime;
+
+        capturedFrames.fetch_add(1, std::memory_order_relaxed);
+        if (frameBuffer.publish())
+        {
+            droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
 }
 
 std::vector<cv::Point> CameraHandler::detectFaces(cv::Mat &frame, cv::Mat &grayFrame, bool thresholdingEnabled)
@@ -135,25 +560,349 @@ std::vector<cv::Point> CameraHandler::detectFaces(cv::Mat &frame, cv::Mat &grayF
         cv::threshold(grayFrame, grayFrame, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
     }
 
-    if (!faceCascade.empty())
+    for (const auto &face : detectHands(grayFrame))
     {
-        std::vector<cv::Rect> faces;
-        faceCascade.detectMultiScale(grayFrame, faces, 1.1, 6,
-                                     0 | cv::CASCADE_FIND_BIGGEST_OBJECT | cv::CASCADE_SCALE_IMAGE,
-                                     cv::Size(30, 30), cv::Size(300, 300));
+        // Draw rectangles around detected faces
+        cv::rectangle(frame, face, cv::Scalar(0, 255, 0), 2);
+
+        // Add center point to detected points
+        cv::Point center(face.x + face.width / 2, face.y + face.height / 2);
+        detectedPoints.push_back(center);
+        BIBLIO_LOG(Detection, "Hand center: (%d, %d)", center.x, center.y);
+        cv::circle(frame, center, 5, cv::Scalar(255, 0, 0), -1);
+    }
 
-        for (const auto &face : faces)
+    return detectedPoints;
+}
+
+std::vector<cv::Rect> CameraHandler::detectHands(const cv::Mat &grayFrame)
+{
+    const cv::Rect fullFrame(0, 0, grayFrame.cols, grayFrame.rows);
+    if (cascades.empty() || fullFrame.empty())
+    {
+        return {};
+    }
+
+    // Downscale for detection only; every rectangle below stays in full-resolution coordinates
+    int level = detectionPyramidLevel;
+    if (level == AUTO_DETECTION_LEVEL)
+    {
+        level = 0;
+        while (level < MAX_DETECTION_LEVEL && (grayFrame.cols >> level) > AUTO_DETECTION_WIDTH)
         {
-            // Draw rectangles around detected faces
-            cv::rectangle(frame, face, cv::Scalar(0, 255, 0), 2);
+            ++level;
+        }
+    }
+    cv::buildPyramid(grayFrame, grayPyramid, level);
+    const cv::Mat &detectionFrame = grayPyramid[level];
+    const double scale = static_cast<double>(detectionFrame.cols) / grayFrame.cols;
 
-            // Add center point to detected points
-            cv::Point center(face.x + face.width / 2, face.y + face.height / 2);
-            detectedPoints.push_back(center);
-            std::cout << "Face center: (" << center.x << ", " << center.y << ")" << std::endl;
-            cv::circle(frame, center, 5, cv::Scalar(255, 0, 0), -1);
+    if (detectionMode == DetectionMode::OpticalFlow)
+    {
+        // Cheap point tracking between cascade runs; the cascade only runs every K frames or when the track is lost
+        if (flowActive && framesSinceFullScan < reacquireInterval)
+        {
+            ++framesSinceFullScan;
+            std::vector<cv::Rect> tracked = trackWithFlow(detectionFrame, scale);
+            if (!tracked.empty())
+            {
+                lastFullScan = false;
+                return tracked;
+            }
         }
+
+        std::vector<cv::Rect> hands = scanRegion(detectionFrame, scale, fullFrame, DetectionMode::FullFrame);
+        framesSinceFullScan = 0;
+        lastFullScan = true;
+        startFlowTracking(detectionFrame, scale, hands);
+        return hands;
     }
 
-    return detectedPoints;
+    std::vector<cv::Rect> hands;
+    bool tracking = detectionMode == DetectionMode::RoiTracking && trackingActive;
+    bool needFullScan = !tracking || framesSinceFullScan >= reacquireInterval;
+
+    if (tracking)
+    {
+        cv::Mat prediction = handFilter.predict();
+        cv::Point2f center(prediction.at<float>(0), prediction.at<float>(1));
+        cv::Point2f velocity(prediction.at<float>(2), prediction.at<float>(3));
+
+        if (!needFullScan)
+        {
+            // Search a few hand sizes around the prediction, widened along the motion
+            int width = cvRound(lastHandSize.width * ROI_SCALE + std::abs(velocity.x) * ROI_VELOCITY_MARGIN);
+            int height = cvRound(lastHandSize.height * ROI_SCALE + std::abs(velocity.y) * ROI_VELOCITY_MARGIN);
+            width = std::max(width, 2 * MIN_HAND_SIZE);
+            height = std::max(height, 2 * MIN_HAND_SIZE);
+
+            cv::Rect roi(cvRound(center.x - width / 2.0f), cvRound(center.y - height / 2.0f), width, height);
+            roi &= fullFrame;
+            if (roi.width >= MIN_HAND_SIZE && roi.height >= MIN_HAND_SIZE)
+            {
+                hands = scanRegion(detectionFrame, scale, roi, DetectionMode::RoiTracking);
+            }
+            ++framesSinceFullScan;
+
+            // Hand lost inside the window: reacquire on the whole frame right away
+            needFullScan = hands.empty();
+        }
+    }
+
+    if (needFullScan)
+    {
+        hands = scanRegion(detectionFrame, scale, fullFrame, DetectionMode::FullFrame);
+        framesSinceFullScan = 0;
+    }
+    lastFullScan = needFullScan;
+
+    if (detectionMode == DetectionMode::RoiTracking)
+    {
+        updateTracking(hands);
+    }
+
+    return hands;
+}
+
+std::vector<cv::Rect> CameraHandler::scanRegion(const cv::Mat &detectionFrame, double scale, const cv::Rect &region, DetectionMode mode)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // Map the region and the hand size limits into the downscaled image
+    cv::Rect scaledRegion(cvFloor(region.x * scale), cvFloor(region.y * scale),
+                          cvCeil(region.width * scale), cvCeil(region.height * scale));
+    scaledRegion &= cv::Rect(0, 0, detectionFrame.cols, detectionFrame.rows);
+
+    // Every cascade scans the same gray image; with several of them, one per core
+    std::vector<std::vector<cv::Rect>> boxes(cascades.size());
+    std::vector<std::vector<int>> scores(cascades.size());
+    auto runCascades = [&](const cv::Range &range) {
+        for (int i = range.start; i < range.end; ++i)
+        {
+            cv::CascadeClassifier &classifier = cascades[i].classifier;
+            cv::Size window = classifier.getOriginalWindowSize();
+            cv::Size minSize(std::max(cvRound(MIN_HAND_SIZE * scale), window.width),
+                             std::max(cvRound(MIN_HAND_SIZE * scale), window.height));
+            cv::Size maxSize(cvRound(MAX_HAND_SIZE * scale), cvRound(MAX_HAND_SIZE * scale));
+            if (scaledRegion.width < minSize.width || scaledRegion.height < minSize.height)
+            {
+                continue;
+            }
+            classifier.detectMultiScale(detectionFrame(scaledRegion), boxes[i], scores[i], 1.1, 6,
+                                        0 | cv::CASCADE_FIND_BIGGEST_OBJECT | cv::CASCADE_SCALE_IMAGE,
+                                        minSize, maxSize);
+        }
+    };
+    if (cascades.size() > 1)
+    {
+        cv::parallel_for_(cv::Range(0, static_cast<int>(cascades.size())), runCascades);
+    }
+    else
+    {
+        // A single cascade keeps detectMultiScale's own parallelism over scales
+        runCascades(cv::Range(0, 1));
+    }
+
+    std::vector<cv::Rect> hands = fuseDetections(boxes, scores);
+
+    // Back to full-resolution coordinates
+    for (auto &hand : hands)
+    {
+        hand += scaledRegion.tl();
+        hand = cv::Rect(cvRound(hand.x / scale), cvRound(hand.y / scale),
+                        cvRound(hand.width / scale), cvRound(hand.height / scale));
+    }
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        DetectionStats &stats = detectionStats[static_cast<int>(mode)];
+        stats.scans++;
+        stats.hits += hands.empty() ? 0 : 1;
+        stats.totalMs += elapsedMs;
+    }
+
+    return hands;
+}
+
+std::vector<cv::Rect> CameraHandler::fuseDetections(const std::vector<std::vector<cv::Rect>> &boxes,
+                                                    const std::vector<std::vector<int>> &scores)
+{
+    // Flatten the ensemble output; the score of a box is its neighbour count
+    std::vector<cv::Rect> candidates;
+    std::vector<double> weights;
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+        for (size_t j = 0; j < boxes[i].size(); ++j)
+        {
+            candidates.push_back(boxes[i][j]);
+            weights.push_back(j < scores[i].size() ? std::max(scores[i][j], 1) : 1);
+        }
+    }
+    if (candidates.empty())
+    {
+        return {};
+    }
+
+    // Non-maximum suppression down to a single hand: the strongest box wins and absorbs
+    // every box overlapping it, averaged by score so that agreeing cascades refine the estimate
+    size_t best = std::max_element(weights.begin(), weights.end()) - weights.begin();
+    double totalWeight = 0.0, x = 0.0, y = 0.0, width = 0.0, height = 0.0;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        if (i != best && overlapRatio(candidates[i], candidates[best]) < FUSION_IOU)
+        {
+            continue;
+        }
+        totalWeight += weights[i];
+        x += weights[i] * candidates[i].x;
+        y += weights[i] * candidates[i].y;
+        width += weights[i] * candidates[i].width;
+        height += weights[i] * candidates[i].height;
+    }
+
+    return {cv::Rect(cvRound(x / totalWeight), cvRound(y / totalWeight),
+                     cvRound(width / totalWeight), cvRound(height / totalWeight))};
+}
+
+void CameraHandler::startFlowTracking(const cv::Mat &detectionFrame, double scale, const std::vector<cv::Rect> &hands)
+{
+    flowActive = false;
+    flowPoints.clear();
+    if (hands.empty())
+    {
+        return;
+    }
+
+    // Seed corners inside the hand box, in detection-level coordinates
+    const cv::Rect &hand = hands.front();
+    flowBox = cv::Rect2f(hand.x * scale, hand.y * scale, hand.width * scale, hand.height * scale);
+    cv::Rect box = cv::Rect(flowBox) & cv::Rect(0, 0, detectionFrame.cols, detectionFrame.rows);
+    if (box.area() == 0)
+    {
+        return;
+    }
+
+    cv::goodFeaturesToTrack(detectionFrame(box), flowPoints, FLOW_MAX_POINTS, 0.01, 3);
+    if (flowPoints.size() < FLOW_MIN_POINTS)
+    {
+        flowPoints.clear();
+        return;
+    }
+    for (auto &point : flowPoints)
+    {
+        point += cv::Point2f(box.tl());
+    }
+
+    // The pyramid buffers are reused for the next frame, keep our own copy
+    detectionFrame.copyTo(previousFlowFrame);
+    flowActive = true;
+}
+
+std::vector<cv::Rect> CameraHandler::trackWithFlow(const cv::Mat &detectionFrame, double scale)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<cv::Rect> hands;
+
+    if (previousFlowFrame.size() == detectionFrame.size() && !flowPoints.empty())
+    {
+        std::vector<cv::Point2f> nextPoints, backPoints;
+        std::vector<uchar> status, backStatus;
+        std::vector<float> errors;
+        cv::calcOpticalFlowPyrLK(previousFlowFrame, detectionFrame, flowPoints, nextPoints, status, errors, cv::Size(15, 15), 2);
+        cv::calcOpticalFlowPyrLK(detectionFrame, previousFlowFrame, nextPoints, backPoints, backStatus, errors, cv::Size(15, 15), 2);
+
+        // Keep the points that come back where they started
+        std::vector<cv::Point2f> keptPoints;
+        std::vector<float> dx, dy;
+        for (size_t i = 0; i < flowPoints.size(); ++i)
+        {
+            if (!status[i] || !backStatus[i] || cv::norm(backPoints[i] - flowPoints[i]) > FLOW_MAX_FB_ERROR)
+            {
+                continue;
+            }
+            keptPoints.push_back(nextPoints[i]);
+            dx.push_back(nextPoints[i].x - flowPoints[i].x);
+            dy.push_back(nextPoints[i].y - flowPoints[i].y);
+        }
+
+        float confidence = static_cast<float>(keptPoints.size()) / flowPoints.size();
+        if (keptPoints.size() >= FLOW_MIN_POINTS && confidence >= FLOW_MIN_CONFIDENCE)
+        {
+            // Median motion is robust to the few background points caught in the box
+            std::nth_element(dx.begin(), dx.begin() + dx.size() / 2, dx.end());
+            std::nth_element(dy.begin(), dy.begin() + dy.size() / 2, dy.end());
+            flowBox.x += dx[dx.size() / 2];
+            flowBox.y += dy[dy.size() / 2];
+
+            // Most of the hand must still be in view
+            cv::Rect2f visible = flowBox & cv::Rect2f(0.0f, 0.0f, detectionFrame.cols, detectionFrame.rows);
+            if (visible.area() >= 0.5f * flowBox.area())
+            {
+                flowPoints = keptPoints;
+                hands.emplace_back(cvRound(flowBox.x / scale), cvRound(flowBox.y / scale),
+                                   cvRound(flowBox.width / scale), cvRound(flowBox.height / scale));
+            }
+        }
+    }
+
+    if (hands.empty())
+    {
+        flowActive = false;
+    }
+    else
+    {
+        detectionFrame.copyTo(previousFlowFrame);
+    }
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        DetectionStats &stats = detectionStats[static_cast<int>(DetectionMode::OpticalFlow)];
+        stats.scans++;
+        stats.hits += hands.empty() ? 0 : 1;
+        stats.totalMs += elapsedMs;
+    }
+
+    return hands;
+}
+
+void CameraHandler::updateTracking(const std::vector<cv::Rect> &hands)
+{
+    if (hands.empty())
+    {
+        trackingActive = false;
+        return;
+    }
+
+    // Follow the biggest hand, like CASCADE_FIND_BIGGEST_OBJECT does
+    const cv::Rect &hand = *std::max_element(hands.begin(), hands.end(),
+                                             [](const cv::Rect &a, const cv::Rect &b) { return a.area() < b.area(); });
+    cv::Point2f center(hand.x + hand.width / 2.0f, hand.y + hand.height / 2.0f);
+    lastHandSize = hand.size();
+
+    if (!trackingActive)
+    {
+        handFilter.statePost = (cv::Mat_<float>(4, 1) << center.x, center.y, 0.0f, 0.0f);
+        cv::setIdentity(handFilter.errorCovPost, cv::Scalar::all(10.0));
+        trackingActive = true;
+        return;
+    }
+
+    cv::Mat measurement = (cv::Mat_<float>(2, 1) << center.x, center.y);
+    handFilter.correct(measurement);
+}
+
+void CameraHandler::setDetectionMode(DetectionMode mode)
+{
+    detectionMode = mode;
+    trackingActive = false;
+    flowActive = false;
+    framesSinceFullScan = 0;
+}
+
+CameraHandler::DetectionStats CameraHandler::getDetectionStats(DetectionMode mode) const
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return detectionStats[static_cast<int>(mode)];
 }
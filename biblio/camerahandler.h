@@ -10,8 +10,34 @@
 #include <opencv2/opencv.hpp>
 #include <opencv2/objdetect.hpp> 
 #include <QString>
+#include <QStringList>
 #include <vector>
 #include <opencv2/core/types.hpp> 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <opencv2/video/tracking.hpp>
+#include "triplebuffer.h"
+#include "captureprofile.h"
+#include "framesource.h"
+#include <memory>
+
+/**
+ * @struct CapturedFrame
+ * @brief Image capturée par le thread de capture, accompagnée de ses métadonnées.
+ */
+struct CapturedFrame
+{
+    cv::Mat image;                                      ///< Image couleur (BGR) ; vide en capture luminance tant que CameraHandler::ensureColor() n'a pas été appelé.
+    cv::Mat gray;                                       ///< Plan de luminance (Y), sans copie lorsque le format le permet ; vide hors capture luminance.
+    cv::Mat raw;                                        ///< Données brutes livrées par le pilote en capture luminance (YUYV, NV12, MJPG...).
+    int fourcc = 0;                                     ///< Format des données brutes (code FOURCC), 0 hors capture luminance.
+    uint64_t sequence = 0;                              ///< Numéro de séquence croissant attribué à la capture.
+    std::chrono::steady_clock::time_point captureTime;  ///< Instant de la capture (horloge monotone).
+};
 
 /**
  * @class CameraHandler
@@ -24,11 +50,49 @@
 class CameraHandler
 {
 public:
+    /**
+     * @enum DetectionMode
+     * @brief Stratégie de recherche de la main par le classificateur en cascade.
+     */
+    enum class DetectionMode
+    {
+        FullFrame,  ///< Balayage de l'image entière à chaque détection.
+        RoiTracking, ///< Balayage d'une région autour de la position prédite, avec ré-acquisition périodique sur l'image entière.
+        OpticalFlow  ///< Classificateur toutes les K images ; entre deux, suivi de points (Lucas–Kanade pyramidal) dans la dernière boîte.
+    };
+
+    /**
+     * @struct DetectionStats
+     * @brief Statistiques cumulées d'un type de balayage (durée et taux de réussite).
+     */
+    struct DetectionStats
+    {
+        uint64_t scans = 0;     ///< Nombre de balayages effectués.
+        uint64_t hits = 0;      ///< Nombre de balayages ayant trouvé une main.
+        double totalMs = 0.0;   ///< Durée cumulée des balayages, en millisecondes.
+
+        /** @brief Durée moyenne d'un balayage en millisecondes. */
+        double averageMs() const { return scans ? totalMs / scans : 0.0; }
+        /** @brief Proportion de balayages ayant trouvé une main (entre 0 et 1). */
+        double hitRate() const { return scans ? static_cast<double>(hits) / scans : 0.0; }
+    };
+
+    /**
+     * @struct HandCascade
+     * @brief Classificateur en cascade chargé, avec le nom du fichier dont il provient.
+     */
+    struct HandCascade
+    {
+        QString name;                       ///< Nom du fichier XML (par ex. "fist.xml").
+        cv::CascadeClassifier classifier;   ///< Classificateur OpenCV.
+    };
+
     /**
      * @brief Constructeur de la classe CameraHandler.
      * Initialise les membres, notamment en tentant de charger le classificateur en cascade.
+     * @param loadCascades false si les classificateurs sont chargés ailleurs (AssetLoader) puis installés par setCascades().
      */
-    CameraHandler();
+    explicit CameraHandler(bool loadCascades = true);
 
     /**
      * @brief Destructeur de la classe CameraHandler.
@@ -42,6 +106,23 @@ public:
      */
     int openCamera();
 
+    /**
+     * @brief Remplace la caméra par une source rejouée (fichier vidéo ou dossier d'images).
+     * openCamera() l'utilise lorsque l'option de lancement --source (ou BIBLIO_SOURCE) est donnée.
+     * @param location Chemin du fichier vidéo ou du dossier d'images.
+     * @param rate Multiplicateur de cadence ; 0 pour livrer chaque image sans attente et sans en perdre.
+     * @param loop true pour rejouer la source en boucle.
+     * @param sequenceFps Cadence d'origine attribuée à un dossier d'images.
+     * @return 1 en cas de succès, 0 si la source ne peut pas être lue.
+     */
+    int openSource(const QString& location, double rate, bool loop, double sequenceFps = 30.0);
+
+    /**
+     * @brief Indique si les images proviennent d'une source rejouée plutôt que d'une caméra.
+     * @return true après un openSource() réussi.
+     */
+    bool isReplaying() const { return source != nullptr; }
+
     /**
      * @brief Vérifie si la caméra est ouverte et prête à capturer.
      * @return true si la caméra est ouverte, false sinon.
@@ -50,10 +131,97 @@ public:
 
     /**
      * @brief Récupère une nouvelle image (frame) de la caméra.
+     * Lecture bloquante si le thread de capture n'est pas démarré, sinon équivalent à getLatestFrame().
      * @param frame Référence vers un objet cv::Mat qui recevra l'image capturée. (paramètre de sortie)
      * @return true si une image a été récupérée avec succès, false sinon.
      */
     bool getFrame(cv::Mat& frame);
+
+    /**
+     * @brief Démarre le thread de capture en arrière-plan.
+     * Les images sont déposées dans un tampon triple ; les consommateurs lisent la plus récente
+     * sans jamais bloquer. La caméra doit avoir été ouverte au préalable.
+     * @return true si le thread tourne, false si la caméra n'est pas ouverte.
+     */
+    bool startCapture();
+
+    /**
+     * @brief Arrête le thread de capture et attend sa fin.
+     */
+    void stopCapture();
+
+    /**
+     * @brief Indique si le thread de capture est actif.
+     * @return true si la capture en arrière-plan est démarrée.
+     */
+    bool isCapturing() const;
+
+    /**
+     * @brief Récupère la dernière image publiée par le thread de capture, sans bloquer.
+     * @param frame Image et métadonnées (séquence, horodatage) de la capture. (paramètre de sortie)
+     * @return true si une image plus récente que la précédente lecture est disponible, false sinon.
+     */
+    bool getLatestFrame(CapturedFrame& frame);
+
+    /**
+     * @brief Nombre d'images capturées par le thread de capture depuis son démarrage.
+     * @return Compteur d'images capturées.
+     */
+    uint64_t capturedFrameCount() const { return capturedFrames.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Nombre d'images écrasées avant d'avoir été lues par un consommateur.
+     * @return Compteur d'images perdues.
+     */
+    uint64_t droppedFrameCount() const { return droppedFrames.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Modes de capture acceptés par la caméra, relevés lors de la première ouverture.
+     * @return Liste des modes (vide pour un flux réseau ou un backend qui n'accepte aucun réglage).
+     */
+    const std::vector<CaptureProfile>& getSupportedProfiles() const { return supportedProfiles; }
+
+    /**
+     * @brief Mode de capture effectivement obtenu lors de la dernière ouverture.
+     * @return Format, résolution, cadence et profondeur de tampon relus auprès du backend.
+     */
+    CaptureProfile getActiveProfile() const { return activeProfile; }
+
+    /**
+     * @brief Intervalle mesuré entre deux images livrées par la caméra (moyenne glissante).
+     * @return Intervalle en millisecondes, 0 tant que la capture n'a pas livré deux images.
+     */
+    double getFrameIntervalMs() const { return frameIntervalMs.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Durée mesurée de l'attente dans grab() (moyenne glissante).
+     * Proche de l'intervalle entre images lorsque le pilote ne retient aucune image d'avance.
+     * @return Durée en millisecondes.
+     */
+    double getGrabWaitMs() const { return grabWaitMs.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Demande la capture en luminance seule, à appliquer lors de la prochaine ouverture de la caméra.
+     * Le pilote livre alors ses données brutes (CAP_PROP_CONVERT_RGB désactivé) : le plan Y est transmis
+     * à la détection sans conversion BGR, la couleur n'est reconstruite que par ensureColor().
+     * Si le backend ou le format ne s'y prêtent pas, la capture reste en BGR.
+     * @param enabled true pour demander la capture en luminance.
+     */
+    void setLumaCapture(bool enabled) { lumaCaptureRequested = enabled; }
+
+    /**
+     * @brief Indique si la caméra ouverte livre effectivement des images en luminance seule.
+     * @return true si les images capturées ont un plan gray et pas d'image couleur.
+     */
+    bool isLumaCapture() const { return lumaCaptureActive; }
+
+    /**
+     * @brief Reconstruit l'image couleur d'une capture en luminance, si elle ne l'est pas déjà.
+     * À n'appeler que lorsque la couleur est réellement affichée : c'est la conversion évitée par la capture en luminance.
+     * @param frame Image capturée ; son champ image est rempli. (paramètre d'entrée/sortie)
+     * @return true si frame.image contient une image BGR.
+     */
+    static bool ensureColor(CapturedFrame& frame);
     
     /**
      * @brief Détecte une main dans une image donnée (on remarque que les variables s'appellent
@@ -67,18 +235,228 @@ public:
      */
     std::vector<cv::Point> detectFaces(cv::Mat& frame, cv::Mat& grayFrame, bool thresholdingEnabled);
 
+    /**
+     * @brief Exécute le classificateur en cascade sur une image en niveaux de gris, sans dessiner.
+     * Utilisé par detectFaces() et par le thread de détection asynchrone (HandDetectionWorker).
+     * @param grayFrame Image en niveaux de gris sur laquelle effectuer la détection.
+     * @return std::vector<cv::Rect> Rectangles englobants des mains détectées.
+     */
+    std::vector<cv::Rect> detectHands(const cv::Mat& grayFrame);
+
+    /**
+     * @brief Installe des classificateurs déjà chargés.
+     * La détection ne doit pas être en cours : arrêter le HandDetectionWorker avant, le redémarrer après.
+     * @param loaded Classificateurs retournés par loadCascadeSet().
+     * @return true si au moins un classificateur est installé.
+     */
+    bool setCascades(std::vector<HandCascade> loaded);
+
+    /**
+     * @brief Ensemble de classificateurs choisi par la variable d'environnement BIBLIO_CASCADES (par ex. "fist,lpalm,rpalm"),
+     * à défaut fist.xml seul.
+     * @return Noms des fichiers XML.
+     */
+    static QStringList configuredCascadeSet();
+
+    /**
+     * @brief Charge un ensemble de classificateurs, sans modifier aucun CameraHandler (utilisable depuis un autre thread).
+     * @param fileNames Fichiers XML à charger depuis le dossier assets.
+     * @return Classificateurs chargés ; ceux introuvables sont omis.
+     */
+    static std::vector<HandCascade> loadCascadeSet(const QStringList& fileNames);
+
+    /**
+     * @brief Choisit la stratégie de détection utilisée par detectHands().
+     * @param mode Balayage complet ou suivi par région d'intérêt.
+     */
+    void setDetectionMode(DetectionMode mode);
+
+    /**
+     * @brief Retourne la stratégie de détection courante.
+     * @return Mode de détection.
+     */
+    DetectionMode getDetectionMode() const { return detectionMode; }
+
+    /**
+     * @brief Définit l'intervalle de ré-acquisition en modes RoiTracking et OpticalFlow.
+     * @param frames Nombre de détections entre deux balayages complets forcés (K).
+     */
+    void setReacquireInterval(int frames) { reacquireInterval = std::max(1, frames); }
+
+    /**
+     * @brief Définit la résolution de détection, indépendamment de la résolution de capture et d'affichage.
+     * La détection s'exécute sur un niveau de la pyramide de l'image en niveaux de gris ; les rectangles
+     * retournés restent exprimés en coordonnées de l'image d'origine.
+     * @param level 0 pour la pleine résolution, 1 pour 1/2, 2 pour 1/4, ou AUTO_DETECTION_LEVEL pour choisir
+     * le plus petit niveau dont la largeur ne dépasse pas AUTO_DETECTION_WIDTH pixels. Les autres valeurs sont ramenées dans cet intervalle.
+     * @note Chaque niveau double la taille minimale d'une main détectable : au niveau 2, elle est d'environ
+     * 4 fois la fenêtre du classificateur dans l'image d'origine.
+     */
+    void setDetectionPyramidLevel(int level) { detectionPyramidLevel = std::clamp(level, AUTO_DETECTION_LEVEL, MAX_DETECTION_LEVEL); }
+
+    /**
+     * @brief Indique si la dernière détection a balayé toute l'image, sans rien reprendre des images précédentes.
+     * Toujours vrai en mode FullFrame ; en suivi, seulement aux ré-acquisitions. À lire sur le thread de detectHands().
+     */
+    bool lastDetectionWasFullScan() const { return lastFullScan; }
+
+    /**
+     * @brief Retourne le niveau de pyramide configuré pour la détection.
+     * @return Niveau configuré (éventuellement AUTO_DETECTION_LEVEL).
+     */
+    int getDetectionPyramidLevel() const { return detectionPyramidLevel; }
+
+    static constexpr int AUTO_DETECTION_LEVEL = -1;     ///< Choix automatique du niveau de pyramide.
+    static constexpr int MAX_DETECTION_LEVEL = 2;       ///< Niveau de pyramide le plus grossier (1/4).
+    static constexpr int AUTO_DETECTION_WIDTH = 640;    ///< Largeur maximale visée par le choix automatique.
+
+    /**
+     * @brief Statistiques cumulées d'un type de balayage.
+     * @param mode FullFrame pour les balayages complets (y compris les ré-acquisitions), RoiTracking pour les balayages de région,
+     * OpticalFlow pour les mises à jour par flot optique (un succès correspond à un suivi jugé fiable).
+     * @return Copie des statistiques (lecture possible depuis un autre thread).
+     */
+    DetectionStats getDetectionStats(DetectionMode mode) const;
+
     
     
 private:
     cv::VideoCapture cap; ///< Objet VideoCapture d'OpenCV pour gérer le flux de la caméra.
-    cv::CascadeClassifier faceCascade; ///< Classificateur en cascade OpenCV pour la détection de visages.
+    std::unique_ptr<FrameSource> source; ///< Source rejouée utilisée à la place de cap, nullptr pour la caméra.
+
+    std::vector<HandCascade> cascades; ///< Ensemble de classificateurs exécutés sur chaque image (fusionnés par fuseDetections()).
+
+    std::thread captureThread;                  ///< Thread de capture en arrière-plan.
+    std::atomic<bool> captureRunning{false};    ///< Indicateur d'activité du thread de capture.
+    std::atomic<uint64_t> capturedFrames{0};    ///< Nombre d'images capturées.
+    std::atomic<uint64_t> droppedFrames{0};     ///< Nombre d'images écrasées sans avoir été lues.
+    TripleBuffer<CapturedFrame> frameBuffer;    ///< Tampon triple entre le thread de capture et les consommateurs.
+    std::atomic<double> frameIntervalMs{0.0};   ///< Moyenne glissante de l'intervalle entre images, en millisecondes.
+    std::atomic<double> grabWaitMs{0.0};        ///< Moyenne glissante de l'attente dans grab(), en millisecondes.
+
+    std::vector<CaptureProfile> supportedProfiles;  ///< Modes acceptés par la caméra (sondés une fois par processus).
+    CaptureProfile activeProfile;                   ///< Mode obtenu lors de la dernière ouverture.
+    bool lumaCaptureRequested = false;              ///< Capture en luminance demandée par setLumaCapture().
+    bool lumaCaptureActive = false;                 ///< Capture en luminance acceptée par le backend pour la caméra ouverte.
 
     /**
-     * @brief Charge le fichier XML du classificateur en cascade pour la détection de main.
-     * @return true si le chargement est réussi, false sinon.
-     * @note Le chemin vers le fichier cascade est généralement codé en dur ou configurable.
+     * @brief Applique le mode de capture choisi à la caméra qui vient d'être ouverte.
+     * Utilise le mode enregistré dans les paramètres, ou à défaut le mode de plus faible latence
+     * parmi ceux acceptés (au moins 640x480 à 30 images/s), avec un tampon pilote d'une seule image.
+     * Les modes acceptés ne sont sondés qu'à la première ouverture de la caméra dans le processus ; si aucun
+     * n'est retenu, la caméra revient au mode dans lequel elle s'est ouverte.
+     */
+    void negotiateCaptureProfile();
+
+    /**
+     * @brief Désactive la conversion RGB du backend si le format de la caméra a un plan de luminance exploitable.
+     * Appelée après negotiateCaptureProfile() ; met à jour lumaCaptureActive.
+     */
+    void configureLumaCapture();
+
+    /**
+     * @brief Boucle du thread de capture : lit la caméra et publie chaque image dans frameBuffer.
+     */
+    void captureLoop();
+
+    /**
+     * @brief Passe à l'image suivante de la caméra ou de la source rejouée.
+     * @return true si une image est prête à être récupérée.
+     */
+    bool grabFrame();
+
+    /**
+     * @brief Récupère l'image obtenue par grabFrame().
+     * @param frame Image couleur. (paramètre de sortie)
+     * @return true si une image a été récupérée.
+     */
+    bool retrieveFrame(cv::Mat& frame);
+
+    DetectionMode detectionMode = DetectionMode::FullFrame; ///< Stratégie de détection courante.
+    int reacquireInterval = 15;         ///< Nombre de détections entre deux balayages complets en mode suivi.
+    int framesSinceFullScan = 0;        ///< Détections effectuées depuis le dernier balayage complet.
+    bool lastFullScan = false;          ///< Indique que la dernière détection a balayé toute l'image.
+    bool trackingActive = false;        ///< Indique que le filtre de Kalman suit une main.
+    cv::KalmanFilter handFilter;        ///< Filtre de Kalman à vitesse constante (x, y, vx, vy) sur le centre de la main.
+    cv::Size lastHandSize;              ///< Taille de la dernière main détectée, pour dimensionner la région d'intérêt.
+
+    int detectionPyramidLevel = 0;          ///< Niveau de pyramide utilisé pour la détection (ou AUTO_DETECTION_LEVEL).
+    std::vector<cv::Mat> grayPyramid;       ///< Pyramide de l'image en niveaux de gris courante (réutilisée d'une image à l'autre).
+
+    mutable std::mutex statsMutex;      ///< Protège detectionStats (écrit par le thread de détection, lu par l'interface).
+    DetectionStats detectionStats[3];   ///< Statistiques indexées par DetectionMode.
+
+    bool flowActive = false;                ///< Indique que des points sont suivis par flot optique.
+    cv::Mat previousFlowFrame;              ///< Image (niveau de détection) sur laquelle les points suivis ont été mesurés.
+    std::vector<cv::Point2f> flowPoints;    ///< Points caractéristiques suivis, en coordonnées du niveau de détection.
+    cv::Rect2f flowBox;                     ///< Boîte de la main suivie, en coordonnées du niveau de détection.
+
+    /**
+     * @brief Exécute le classificateur sur une région de l'image et met à jour les statistiques.
+     * @param detectionFrame Image en niveaux de gris réduite sur laquelle tourne le classificateur.
+     * @param scale Rapport entre detectionFrame et l'image d'origine (1, 1/2 ou 1/4).
+     * @param region Région à balayer, en coordonnées de l'image d'origine.
+     * @param mode Type de balayage comptabilisé.
+     * @return Rectangles détectés, en coordonnées de l'image d'origine.
+     */
+    std::vector<cv::Rect> scanRegion(const cv::Mat& detectionFrame, double scale, const cv::Rect& region, DetectionMode mode);
+
+    /**
+     * @brief Initialise le suivi par flot optique à partir de la main détectée par le classificateur.
+     * @param detectionFrame Image en niveaux de gris du niveau de détection.
+     * @param scale Rapport entre detectionFrame et l'image d'origine.
+     * @param hands Rectangles détectés, en coordonnées de l'image d'origine.
+     */
+    void startFlowTracking(const cv::Mat& detectionFrame, double scale, const std::vector<cv::Rect>& hands);
+
+    /**
+     * @brief Déplace la boîte suivie selon le flot optique (Lucas–Kanade pyramidal, vérification aller-retour).
+     * @param detectionFrame Image en niveaux de gris du niveau de détection.
+     * @param scale Rapport entre detectionFrame et l'image d'origine.
+     * @return La boîte déplacée, en coordonnées de l'image d'origine, ou un vecteur vide si le suivi n'est plus fiable.
+     */
+    std::vector<cv::Rect> trackWithFlow(const cv::Mat& detectionFrame, double scale);
+
+    /**
+     * @brief Met à jour le filtre de Kalman avec la main détectée, ou abandonne le suivi.
+     * @param hands Rectangles détectés lors du dernier balayage.
+     */
+    void updateTracking(const std::vector<cv::Rect>& hands);
+
+    /**
+     * @brief Charge l'ensemble de classificateurs par défaut pour la détection de main.
+     * @return true si au moins un classificateur est chargé, false sinon.
+     * @note L'ensemble est celui de configuredCascadeSet().
      */
     bool loadFaceCascade();
+
+    /**
+     * @brief Charge et installe un ensemble de classificateurs (construction seulement, avant tout thread de détection).
+     * Les classificateurs sont exécutés en parallèle sur la même image puis leurs rectangles sont
+     * fusionnés en une seule estimation de la main.
+     * @param fileNames Fichiers XML à charger depuis le dossier assets (fist.xml, lpalm.xml, rpalm.xml, left.xml, right.xml, combined_cascade.xml).
+     * @return true si au moins un classificateur a pu être chargé.
+     */
+    bool setCascadeSet(const QStringList& fileNames);
+
+    /**
+     * @brief Charge un fichier XML de classificateur en cascade depuis les ressources du jeu (AssetRegistry).
+     * @param fileName Nom du fichier (par ex. "fist.xml").
+     * @param classifier Classificateur à initialiser. (paramètre de sortie)
+     * @return true si le chargement est réussi, false sinon.
+     */
+    static bool loadCascade(const QString& fileName, cv::CascadeClassifier& classifier);
+
+    /**
+     * @brief Fusionne les rectangles de tous les classificateurs en une seule estimation de la main.
+     * Suppression des non-maxima : le rectangle le mieux noté l'emporte et absorbe ceux qui le recouvrent,
+     * moyennés selon leur score (nombre de voisins retenus par detectMultiScale).
+     * @param boxes Rectangles détectés, un vecteur par classificateur.
+     * @param scores Nombre de voisins de chaque rectangle, un vecteur par classificateur.
+     * @return Zéro ou un rectangle.
+     */
+    static std::vector<cv::Rect> fuseDetections(const std::vector<std::vector<cv::Rect>>& boxes,
+                                                const std::vector<std::vector<int>>& scores);
 };
 
 #endif // CAMERAHANDLER_H
@@ -16,6 +16,8 @@ CameraWidget::CameraWidget(QWidget *parent)
     ui->label->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
     ui->label->setAlignment(Qt::AlignCenter);
 
+    // Same capture path as the game, so the settings show what the game will get
+    cameraHandler.setLumaCapture(qEnvironmentVariable("BIBLIO_LUMA_CAPTURE", "1") != "0");
     int openStatus = cameraHandler.openCamera();
     if (openStatus <= 0) {
         // Show different messages based on the error
@@ -43,7 +45,10 @@ CameraWidget::CameraWidget(QWidget *parent)
         
         showPlaceholderMessage("Camera access required", 
                               "Please grant camera permission in System Settings → Privacy & Security → Camera");
+    } else {
+        cameraHandler.startCapture();
     }
+    lastFrameTimer.start();
 
     timer = new QTimer(this);
     connect(timer, &QTimer::timeout, this, &CameraWidget::updateFrame);
@@ -86,6 +91,29 @@ CameraWidget::~CameraWidget()
     delete ui;
 }
 
+void CameraWidget::setCaptureProfile(const CaptureProfile &profile)
+{
+    CaptureProfile::setPreferred(profile);
+    if (cameraHandler.openCamera() > 0) {
+        cameraHandler.startCapture();
+    }
+    lastFrameTimer.restart();
+}
+
+QString CameraWidget::captureStatus() const
+{
+    if (!cameraHandler.isOpened()) {
+        return "Camera not available";
+    }
+    CaptureProfile active = cameraHandler.getActiveProfile();
+    return QString("Active mode: %1%2, driver buffer %3 - %4 ms between frames, %5 ms waiting in grab()")
+        .arg(active.toString())
+        .arg(cameraHandler.isLumaCapture() ? " (luma)" : "")
+        .arg(active.bufferSize)
+        .arg(cameraHandler.getFrameIntervalMs(), 0, 'f', 1)
+        .arg(cameraHandler.getGrabWaitMs(), 0, 'f', 1);
+}
+
 void CameraWidget::updateFrame()
 {
     cv::Mat frame;
@@ -96,6 +124,7 @@ void CameraWidget::updateFrame()
             reopenCounter = 0;
             int status = cameraHandler.openCamera();
             if (status > 0) {
+                cameraHandler.startCapture();
                 qDebug() << "Camera reconnected successfully";
             }
         }
@@ -104,16 +133,31 @@ void CameraWidget::updateFrame()
         return;
     }
     
-    if (!cameraHandler.getFrame(frame)) {
-        showPlaceholderMessage("No Frame Received", "Camera is connected but no video stream is available");
+    CapturedFrame captured;
+    if (!cameraHandler.getLatestFrame(captured)) {
+        // No new frame since the last tick; only complain if the stream has stalled
+        if (lastFrameTimer.elapsed() > 2000) {
+            showPlaceholderMessage("No Frame Received", "Camera is connected but no video stream is available");
+        }
         return;
     }
+    lastFrameTimer.restart();
+
+    // Gray straight from the capture when it delivers luma, otherwise from the BGR image before it is modified
+    cv::Mat frameGray;
+    if (!captured.gray.empty()) {
+        frameGray = captured.gray.clone();
+    } else {
+        cv::cvtColor(captured.image, frameGray, cv::COLOR_BGR2GRAY);
+    }
 
-    // Convert BGR (OpenCV default) to RGB (Qt expects RGB format)
-    cv::cvtColor(frame, frame, cv::COLOR_BGR2RGB);
+    // The preview always shows color
+    if (!CameraHandler::ensureColor(captured)) {
+        return;
+    }
 
-    cv::Mat frameGray = frame.clone();
-    cv::cvtColor(frameGray, frameGray, cv::COLOR_RGB2GRAY);
+    // Convert BGR (OpenCV default) to RGB (Qt expects RGB format)
+    cv::cvtColor(captured.image, frame, cv::COLOR_BGR2RGB);
 
     cameraHandler.detectFaces(frame, frameGray, thresholdingEnabled);
 
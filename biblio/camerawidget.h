@@ -3,6 +3,7 @@
 
 #include <QWidget>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QImage>
 #include <QPixmap>
 #include "camerahandler.h"
@@ -19,6 +20,13 @@ public:
     explicit CameraWidget(QWidget *parent = nullptr);
     ~CameraWidget();
 
+    // Capture modes found on the camera, empty if it could not be opened
+    const std::vector<CaptureProfile> &supportedCaptureProfiles() const { return cameraHandler.getSupportedProfiles(); }
+    // Saves the mode as the user's choice and reopens the camera with it
+    void setCaptureProfile(const CaptureProfile &profile);
+    // Active mode and measured timing, for display
+    QString captureStatus() const;
+
 private slots:
     void updateFrame();
     void on_thresholdingButton_clicked();
@@ -27,6 +35,7 @@ private:
     Ui::CameraWidget *ui;
     CameraHandler cameraHandler;
     QTimer *timer;
+    QElapsedTimer lastFrameTimer; // Time since the last frame received from the capture thread
     
     void showPlaceholderMessage(const QString &title, const QString &message);
     bool thresholdingEnabled = false; // Flag to enable/disable thresholding
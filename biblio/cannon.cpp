@@ -2,6 +2,8 @@
 #include <iostream>
 #include <sys/socket.h>
 #include "fruit.h"
+#include "glresourceregistry.h"
+#include <algorithm>
 
 Cannon::Cannon()
 {
@@ -9,134 +11,131 @@ Cannon::Cannon()
     angleX = 0;
     angleY = 0;
     angleZ = 0;
-    quadric = gluNewQuadric();
     hasTexture = false;
 }
 
-Cannon::~Cannon()
+void Cannon::createDisplayLists()
 {
-    gluDeleteQuadric(quadric);
-}
-
-void Cannon::drawCannon()
-{
-    // Set material properties for the cannon
-    GLfloat ambient[] = {0.2f, 0.2f, 0.2f, 1.0f};
-    GLfloat diffuse[] = {0.8f, 0.8f, 0.8f, 1.0f};
-    GLfloat specular[] = {1.0f, 1.0f, 1.0f, 1.0f};
-    GLfloat shininess = 50.0f;
-
-    glMaterialfv(GL_FRONT, GL_AMBIENT, ambient);
-    glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuse);
-    glMaterialfv(GL_FRONT, GL_SPECULAR, specular);
-    glMaterialfv(GL_FRONT, GL_SHININESS, &shininess);
-
-    
-
-    // Draw the cannon base (cubic) with texture
-    glPushMatrix();
-    glTranslatef(position.x(), position.y() - 1.3f, position.z());
-    glScalef(1.5f, 1.f, 1.5f);
-    
-    // Apply cannon texture if available
-    if (hasTexture) {
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, cannonTexture);
-    }
-    
-    glBegin(GL_QUADS);
-
-    // Face avant (z = +1)
-    glNormal3f(0.0, 0.0, 1.0);
-    glTexCoord2f(0.0f, 0.0f); glVertex3f(-1.0, -1.0, 1.0);
-    glTexCoord2f(1.0f, 0.0f); glVertex3f(1.0, -1.0, 1.0);
-    glTexCoord2f(1.0f, 1.0f); glVertex3f(0.8, 1.0, 0.8);
-    glTexCoord2f(0.0f, 1.0f); glVertex3f(-0.8, 1.0, 0.8);
-
-    // Face arrière (z = -1)
-    glNormal3f(0.0, 0.0, -1.0);
-    glTexCoord2f(0.0f, 0.0f); glVertex3f(-1.0, -1.0, -1.0);
-    glTexCoord2f(0.0f, 1.0f); glVertex3f(-0.8, 1.0, -0.8);
-    glTexCoord2f(1.0f, 1.0f); glVertex3f(0.8, 1.0, -0.8);
-    glTexCoord2f(1.0f, 0.0f); glVertex3f(1.0, -1.0, -1.0);
-
-    // Face gauche (x = -1)
-    glNormal3f(-1.0, 0.0, 0.0);
-    glTexCoord2f(0.0f, 0.0f); glVertex3f(-1.0, -1.0, -1.0);
-    glTexCoord2f(1.0f, 0.0f); glVertex3f(-1.0, -1.0, 1.0);
-    glTexCoord2f(1.0f, 1.0f); glVertex3f(-0.8, 1.0, 0.8);
-    glTexCoord2f(0.0f, 1.0f); glVertex3f(-0.8, 1.0, -0.8);
-
-    // Face droite (x = +1)
-    glNormal3f(1.0, 0.0, 0.0);
-    glTexCoord2f(0.0f, 0.0f); glVertex3f(1.0, -1.0, -1.0);
-    glTexCoord2f(1.0f, 0.0f); glVertex3f(1.0, -1.0, 1.0);
-    glTexCoord2f(1.0f, 1.0f); glVertex3f(0.8, 1.0, 0.8);
-    glTexCoord2f(0.0f, 1.0f); glVertex3f(0.8, 1.0, -0.8);
-
-    // Face supérieure (y = +1)
-    glNormal3f(0.0, 1.0, 0.0);
-    glTexCoord2f(0.0f, 0.0f); glVertex3f(-0.8, 1.0, -0.8);
-    glTexCoord2f(0.0f, 1.0f); glVertex3f(-0.8, 1.0, 0.8);
-    glTexCoord2f(1.0f, 1.0f); glVertex3f(0.8, 1.0, 0.8);
-    glTexCoord2f(1.0f, 0.0f); glVertex3f(0.8, 1.0, -0.8);
-
-    // Face inférieure (y = -1)
-    glNormal3f(0.0, -1.0, 0.0);
-    glTexCoord2f(0.0f, 0.0f); glVertex3f(-1.0, -1.0, -1.0);
-    glTexCoord2f(1.0f, 0.0f); glVertex3f(1.0, -1.0, -1.0);
-    glTexCoord2f(1.0f, 1.0f); glVertex3f(1.0, -1.0, 1.0);
-    glTexCoord2f(0.0f, 1.0f); glVertex3f(-1.0, -1.0, 1.0);
-
-    glEnd();
-    
-    // If texture was enabled for the base, keep it enabled for barrel
-    if (!hasTexture) {
-        glDisable(GL_TEXTURE_2D);
+    GLResourceRegistry &resources = GLResourceRegistry::current();
+    GLUquadric *quadric = resources.quadric("cannon");
+    // Texture coordinates are always compiled, texturing is enabled at draw time
+    gluQuadricTexture(quadric, GL_TRUE);
+
+    // Base and barrel attach, relative to the cannon position
+    bool created = false;
+    bodyList = resources.displayList("cannon.body", &created);
+    if (created)
+    {
+        glNewList(bodyList, GL_COMPILE);
+
+        // Draw the cannon base (cubic)
+        glPushMatrix();
+        glTranslatef(0.0f, -1.3f, 0.0f);
+        glScalef(1.5f, 1.f, 1.5f);
+
+        glBegin(GL_QUADS);
+
+        // Face avant (z = +1)
+        glNormal3f(0.0, 0.0, 1.0);
+        glTexCoord2f(0.0f, 0.0f); glVertex3f(-1.0, -1.0, 1.0);
+        glTexCoord2f(1.0f, 0.0f); glVertex3f(1.0, -1.0, 1.0);
+        glTexCoord2f(1.0f, 1.0f); glVertex3f(0.8, 1.0, 0.8);
+        glTexCoord2f(0.0f, 1.0f); glVertex3f(-0.8, 1.0, 0.8);
+
+        // Face arrière (z = -1)
+        glNormal3f(0.0, 0.0, -1.0);
+        glTexCoord2f(0.0f, 0.0f); glVertex3f(-1.0, -1.0, -1.0);
+        glTexCoord2f(0.0f, 1.0f); glVertex3f(-0.8, 1.0, -0.8);
+        glTexCoord2f(1.0f, 1.0f); glVertex3f(0.8, 1.0, -0.8);
+        glTexCoord2f(1.0f, 0.0f); glVertex3f(1.0, -1.0, -1.0);
+
+        // Face gauche (x = -1)
+        glNormal3f(-1.0, 0.0, 0.0);
+        glTexCoord2f(0.0f, 0.0f); glVertex3f(-1.0, -1.0, -1.0);
+        glTexCoord2f(1.0f, 0.0f); glVertex3f(-1.0, -1.0, 1.0);
+        glTexCoord2f(1.0f, 1.0f); glVertex3f(-0.8, 1.0, 0.8);
+        glTexCoord2f(0.0f, 1.0f); glVertex3f(-0.8, 1.0, -0.8);
+
+        // Face droite (x = +1)
+        glNormal3f(1.0, 0.0, 0.0);
+        glTexCoord2f(0.0f, 0.0f); glVertex3f(1.0, -1.0, -1.0);
+        glTexCoord2f(1.0f, 0.0f); glVertex3f(1.0, -1.0, 1.0);
+        glTexCoord2f(1.0f, 1.0f); glVertex3f(0.8, 1.0, 0.8);
+        glTexCoord2f(0.0f, 1.0f); glVertex3f(0.8, 1.0, -0.8);
+
+        // Face supérieure (y = +1)
+        glNormal3f(0.0, 1.0, 0.0);
+        glTexCoord2f(0.0f, 0.0f); glVertex3f(-0.8, 1.0, -0.8);
+        glTexCoord2f(0.0f, 1.0f); glVertex3f(-0.8, 1.0, 0.8);
+        glTexCoord2f(1.0f, 1.0f); glVertex3f(0.8, 1.0, 0.8);
+        glTexCoord2f(1.0f, 0.0f); glVertex3f(0.8, 1.0, -0.8);
+
+        // Face inférieure (y = -1)
+        glNormal3f(0.0, -1.0, 0.0);
+        glTexCoord2f(0.0f, 0.0f); glVertex3f(-1.0, -1.0, -1.0);
+        glTexCoord2f(1.0f, 0.0f); glVertex3f(1.0, -1.0, -1.0);
+        glTexCoord2f(1.0f, 1.0f); glVertex3f(1.0, -1.0, 1.0);
+        glTexCoord2f(0.0f, 1.0f); glVertex3f(-1.0, -1.0, 1.0);
+
+        glEnd();
+
+        glPopMatrix();
+
+        // Draw the spherical cannon barrel attach
+        glPushMatrix();
+        glTranslatef(0.0f, -0.1f, 0.0f);
+        gluSphere(quadric, 0.6, 16, 16);
+        glPopMatrix();
+
+        glEndList();
     }
-    
-    glPopMatrix();
 
-    
-    // Apply cannon texture if available
-    if (hasTexture) {
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, cannonTexture);
-        
-        // Enable texture coordinates generation
-        gluQuadricTexture(quadric, GL_TRUE);
-    }
+    // Barrel, along +z before the cannon rotation
+    barrelList = resources.displayList("cannon.barrel", &created);
+    if (created)
+    {
+        glNewList(barrelList, GL_COMPILE);
+        glPushMatrix();
 
-    // Draw the spherical cannon barrel attach
-    glPushMatrix();
-    glTranslatef(position.x(), position.y() - 0.1f, position.z());
-    gluSphere(quadric, 0.6, 16, 16);
-    glPopMatrix();
+        // Draw the cannon body (cylinder)
+        gluCylinder(quadric, 0.2, 0.2, 3, 16, 16);
 
-    // Draw the cannon barrel with texture
-    glPushMatrix();
-    glTranslatef(position.x(), position.y(), position.z());
+        // Draw the cannon barrel (cone)
+        glTranslatef(0.0f, 0.0f, 3.f);
+        gluCylinder(quadric, 0.2, 0.4, 3, 16, 16);
 
-    // Rotate the cannon based on the angle
-    glRotatef(angleX, 1.0f, 0.0f, 0.0f);
-    glRotatef(angleY, 0.0f, 1.0f, 0.0f);
-    glRotatef(angleZ, 0.0f, 0.0f, 1.0f);
-
-
-    // Draw the cannon body (cylinder)
-    gluCylinder(quadric, 0.2, 0.2, 3, 16, 16);
+        glPopMatrix();
+        glEndList();
+    }
+}
 
-    // Draw the cannon barrel (cone)
-    glTranslatef(0.0f, 0.0f, 3.f);
-    gluCylinder(quadric, 0.2, 0.4, 3, 16, 16);
+void Cannon::submit(RenderQueue &queue)
+{
+    // Set material properties for the cannon
+    RenderQueue::State state;
+    const GLfloat specular[] = {1.0f, 1.0f, 1.0f, 1.0f};
+    std::copy(specular, specular + 4, state.material.specular);
+    state.material.shininess = 50.0f;
 
-    // Disable texture if we enabled it
-    if (hasTexture) {
-        gluQuadricTexture(quadric, GL_FALSE);
-        glDisable(GL_TEXTURE_2D);
+    // Apply cannon texture if available
+    if (hasTexture)
+    {
+        state.texture = cannonTexture;
+        // The compiled texture coordinates cover [0, 1], the image is one region of the atlas
+        state.textureRegion = textureRegion;
     }
 
-    glPopMatrix();
+    QMatrix4x4 model;
+    model.translate(position);
+    const GLuint body = bodyList;
+    queue.submit(RenderQueue::Opaque, model, state, [body](GLStateCache &) { glCallList(body); });
+
+    // Rotate the cannon based on the angle, only the barrel follows it
+    model.rotate(angleX, 1.0f, 0.0f, 0.0f);
+    model.rotate(angleY, 0.0f, 1.0f, 0.0f);
+    model.rotate(angleZ, 0.0f, 0.0f, 1.0f);
+    const GLuint barrel = barrelList;
+    queue.submit(RenderQueue::Opaque, model, state, [barrel](GLStateCache &) { glCallList(barrel); });
 }
 
 void Cannon::setDirection(QVector3D direction)
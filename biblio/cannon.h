@@ -6,7 +6,9 @@
 
 #include <qvectornd.h> 
 #include <QVector3D>  
+#include <QRectF>
 #include <qopengl.h>  
+#include "renderqueue.h"
 
 #ifdef __APPLE__
 #include <OpenGL/glu.h>
@@ -27,23 +29,25 @@ private :
     float angleX;           ///< Angle de rotation du canon autour de l'axe X.
     float angleY;           ///< Angle de rotation du canon autour de l'axe Y.
     float angleZ;           ///< Angle de rotation du canon autour de l'axe Z.
-    GLUquadric* quadric;    ///< Objet quadrique GLU utilisé pour dessiner les parties du canon.
+    GLuint bodyList = 0;    ///< Liste d'affichage du socle et de la sphère d'attache (possédée par GLResourceRegistry).
+    GLuint barrelList = 0;  ///< Liste d'affichage du tube, dessinée avec l'orientation du canon (possédée par GLResourceRegistry).
     GLuint cannonTexture;   ///< Identifiant de la texture OpenGL pour le canon.
     bool hasTexture;        ///< Indicateur booléen : true si une texture est assignée au canon, false sinon.
+    QRectF textureRegion;   ///< Région de l'image du canon dans sa texture.
 
 
 public:
     /**
      * @brief Constructeur de la classe Cannon.
-     * Initialise les angles, la position par défaut et l'objet quadrique.
+     * Initialise les angles et la position par défaut.
      */
     Cannon();
 
     /**
-     * @brief Destructeur de la classe Cannon.
-     * Libère les ressources allouées (par exemple, l'objet quadrique GLU).
+     * @brief Compile la géométrie du canon dans des listes d'affichage, une seule fois par groupe de contextes.
+     * Nécessite un contexte OpenGL courant ; à appeler avant submit().
      */
-    ~Cannon();
+    void createDisplayLists();
 
     /**
      * @brief Définit la position du canon.
@@ -61,14 +65,16 @@ public:
     /**
      * @brief Assigne une texture au canon.
      * @param textureId Identifiant de la texture OpenGL à utiliser.
+     * @param region Région de l'image du canon dans cette texture (atlas).
      */
-    void setTexture(GLuint textureId) { cannonTexture = textureId; hasTexture = true; }
+    void setTexture(GLuint textureId, const QRectF &region) { cannonTexture = textureId; textureRegion = region; hasTexture = true; }
 
     /**
-     * @brief Dessine le canon dans la scène OpenGL.
-     * Utilise la position et les angles actuels pour transformer et dessiner le modèle du canon.
+     * @brief Soumet le canon à la file de rendu : le socle, puis le tube orienté.
+     * Utilise la position et les angles actuels pour transformer les listes d'affichage du canon.
+     * @param queue File de rendu de l'image.
      */
-    void drawCannon();
+    void submit(RenderQueue &queue);
 
     /**
      * @brief Méthode appelée lors de la création d'un fruit.
@@ -0,0 +1,201 @@
+#include "captureprofile.h"
+#include <QRegularExpression>
+#include <QSettings>
+#include <algorithm>
+#include <cmath>
+
+// Constants
+const char *const PROFILE_SETTINGS_KEY = "camera/captureProfile";
+const double FPS_TOLERANCE = 0.9;     // Fraction of the requested rate the backend must report back
+
+// Modes tried by probe(): compressed and raw formats at the usual webcam sizes and rates
+static const char *const PROBE_FOURCCS[] = {"MJPG", "YUYV"};
+static const cv::Size PROBE_SIZES[] = {{320, 240}, {640, 480}, {800, 600}, {1280, 720}, {1920, 1080}};
+static const double PROBE_RATES[] = {60.0, 30.0};
+
+// Decodes the FOURCC property ("MJPG", "YUYV"...); empty when the backend does not report it
+static QString fourccToString(double value)
+{
+    int code = static_cast<int>(value);
+    if (code <= 0)
+    {
+        return QString();
+    }
+    char chars[4] = {static_cast<char>(code & 0xFF), static_cast<char>((code >> 8) & 0xFF),
+                     static_cast<char>((code >> 16) & 0xFF), static_cast<char>((code >> 24) & 0xFF)};
+    return QString::fromLatin1(chars, 4).trimmed();
+}
+
+// Compressed formats cost a decode on the capture thread
+static bool isCompressed(const QString &fourcc)
+{
+    return fourcc == "MJPG" || fourcc == "H264";
+}
+
+QString CaptureProfile::toString() const
+{
+    if (isAuto())
+    {
+        return "auto";
+    }
+    return QString("%1 %2x%3 @%4").arg(fourcc.isEmpty() ? "----" : fourcc).arg(width).arg(height).arg(fps);
+}
+
+CaptureProfile CaptureProfile::fromString(const QString &text)
+{
+    static const QRegularExpression pattern("^(\\S{4})\\s+(\\d+)x(\\d+)\\s+@([0-9.]+)$");
+    CaptureProfile profile;
+    QRegularExpressionMatch match = pattern.match(text.trimmed());
+    if (!match.hasMatch())
+    {
+        return profile;
+    }
+    profile.fourcc = match.captured(1) == "----" ? QString() : match.captured(1);
+    profile.width = match.captured(2).toInt();
+    profile.height = match.captured(3).toInt();
+    profile.fps = match.captured(4).toDouble();
+    return profile;
+}
+
+std::vector<CaptureProfile> CaptureProfile::probe(cv::VideoCapture &cap)
+{
+    std::vector<CaptureProfile> supported;
+    if (!cap.isOpened())
+    {
+        return supported;
+    }
+
+    for (const char *fourcc : PROBE_FOURCCS)
+    {
+        for (const cv::Size &size : PROBE_SIZES)
+        {
+            for (double rate : PROBE_RATES)
+            {
+                CaptureProfile requested;
+                requested.fourcc = fourcc;
+                requested.width = size.width;
+                requested.height = size.height;
+                requested.fps = rate;
+
+                // Drivers silently fall back to the nearest mode they have: only keep exact read-backs
+                CaptureProfile actual = requested.applyTo(cap);
+                bool formatMatches = actual.fourcc.isEmpty() || actual.fourcc == requested.fourcc;
+                bool sizeMatches = actual.width == requested.width && actual.height == requested.height;
+                bool rateMatches = actual.fps <= 0.0 || actual.fps >= requested.fps * FPS_TOLERANCE;
+                if (!formatMatches || !sizeMatches || !rateMatches)
+                {
+                    continue;
+                }
+                if (actual.fourcc.isEmpty())
+                {
+                    actual.fourcc = requested.fourcc;
+                }
+                if (actual.fps <= 0.0)
+                {
+                    actual.fps = requested.fps;
+                }
+
+                bool duplicate = std::any_of(supported.begin(), supported.end(), [&actual](const CaptureProfile &p) {
+                    return p.fourcc == actual.fourcc && p.width == actual.width && p.height == actual.height
+                           && std::abs(p.fps - actual.fps) < 0.5;
+                });
+                if (!duplicate)
+                {
+                    supported.push_back(actual);
+                }
+            }
+        }
+    }
+    return supported;
+}
+
+CaptureProfile CaptureProfile::selectLowestLatency(const std::vector<CaptureProfile> &profiles,
+                                                   int minWidth, int minHeight, double minFps)
+{
+    if (profiles.empty())
+    {
+        return CaptureProfile();
+    }
+
+    // Higher rate first (shorter wait for the next frame), then fewer pixels, then no decode step
+    auto lowerLatency = [](const CaptureProfile &a, const CaptureProfile &b) {
+        if (std::abs(a.fps - b.fps) >= 0.5)
+        {
+            return a.fps > b.fps;
+        }
+        if (a.width * a.height != b.width * b.height)
+        {
+            return a.width * a.height < b.width * b.height;
+        }
+        return !isCompressed(a.fourcc) && isCompressed(b.fourcc);
+    };
+
+    std::vector<CaptureProfile> candidates;
+    for (const CaptureProfile &profile : profiles)
+    {
+        if (profile.width >= minWidth && profile.height >= minHeight && profile.fps >= minFps * FPS_TOLERANCE)
+        {
+            candidates.push_back(profile);
+        }
+    }
+
+    if (candidates.empty())
+    {
+        // Nothing meets the target: the fastest mode, at the largest size available at that rate
+        return *std::min_element(profiles.begin(), profiles.end(), [](const CaptureProfile &a, const CaptureProfile &b) {
+            if (std::abs(a.fps - b.fps) >= 0.5)
+            {
+                return a.fps > b.fps;
+            }
+            return a.width * a.height > b.width * b.height;
+        });
+    }
+    return *std::min_element(candidates.begin(), candidates.end(), lowerLatency);
+}
+
+CaptureProfile CaptureProfile::applyTo(cv::VideoCapture &cap) const
+{
+    // V4L2 validates the size against the current format, so the format goes first
+    if (!fourcc.isEmpty())
+    {
+        QByteArray code = fourcc.toLatin1();
+        cap.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc(code[0], code[1], code[2], code[3]));
+    }
+    if (width > 0 && height > 0)
+    {
+        cap.set(cv::CAP_PROP_FRAME_WIDTH, width);
+        cap.set(cv::CAP_PROP_FRAME_HEIGHT, height);
+    }
+    if (fps > 0.0)
+    {
+        cap.set(cv::CAP_PROP_FPS, fps);
+    }
+    if (bufferSize > 0)
+    {
+        cap.set(cv::CAP_PROP_BUFFERSIZE, bufferSize);
+    }
+    return readFrom(cap);
+}
+
+CaptureProfile CaptureProfile::readFrom(cv::VideoCapture &cap)
+{
+    CaptureProfile profile;
+    profile.fourcc = fourccToString(cap.get(cv::CAP_PROP_FOURCC));
+    profile.width = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH));
+    profile.height = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
+    profile.fps = cap.get(cv::CAP_PROP_FPS);
+    profile.bufferSize = static_cast<int>(cap.get(cv::CAP_PROP_BUFFERSIZE));
+    return profile;
+}
+
+CaptureProfile CaptureProfile::preferred()
+{
+    QSettings settings;
+    return fromString(settings.value(PROFILE_SETTINGS_KEY, "auto").toString());
+}
+
+void CaptureProfile::setPreferred(const CaptureProfile &profile)
+{
+    QSettings settings;
+    settings.setValue(PROFILE_SETTINGS_KEY, profile.toString());
+}
@@ -0,0 +1,97 @@
+/**
+ * @file captureprofile.h
+ * @brief Déclaration de la structure CaptureProfile.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef CAPTUREPROFILE_H
+#define CAPTUREPROFILE_H
+
+#include <opencv2/videoio.hpp>
+#include <QString>
+#include <vector>
+
+/**
+ * @struct CaptureProfile
+ * @brief Mode de capture d'une caméra : format de pixels, résolution, cadence et profondeur du tampon pilote.
+ *
+ * OpenCV ne permet pas d'énumérer les modes d'une caméra : probe() essaie une liste de modes courants
+ * et ne garde que ceux que le backend accepte réellement (relecture des propriétés après réglage).
+ * selectLowestLatency() choisit ensuite le mode de plus faible latence qui satisfait une cible minimale.
+ */
+struct CaptureProfile
+{
+    QString fourcc;         ///< Format de pixels ("MJPG", "YUYV"...), vide pour le format par défaut du backend.
+    int width = 0;          ///< Largeur en pixels (0 : valeur par défaut du backend).
+    int height = 0;         ///< Hauteur en pixels (0 : valeur par défaut du backend).
+    double fps = 0.0;       ///< Cadence demandée en images par seconde (0 : valeur par défaut du backend).
+    int bufferSize = 1;     ///< Nombre d'images mises en tampon par le pilote (1 : latence minimale).
+
+    /**
+     * @brief Indique s'il s'agit du profil automatique (aucun réglage imposé).
+     * @return true si aucun format, ni résolution, ni cadence n'est imposé.
+     */
+    bool isAuto() const { return fourcc.isEmpty() && width == 0 && height == 0 && fps <= 0.0; }
+
+    /**
+     * @brief Représentation textuelle du profil, par exemple "MJPG 640x480 @30".
+     * @return "auto" pour le profil automatique.
+     */
+    QString toString() const;
+
+    /**
+     * @brief Analyse une chaîne produite par toString().
+     * @param text Chaîne à analyser.
+     * @return Le profil correspondant, ou le profil automatique si la chaîne n'est pas reconnue.
+     */
+    static CaptureProfile fromString(const QString &text);
+
+    /**
+     * @brief Essaie une liste de modes courants et retourne ceux que le backend accepte.
+     * @param cap Capture ouverte sur la caméra à interroger (son mode est modifié pendant le test).
+     * @return Modes acceptés, sans doublon.
+     */
+    static std::vector<CaptureProfile> probe(cv::VideoCapture &cap);
+
+    /**
+     * @brief Choisit le mode de plus faible latence satisfaisant une cible minimale.
+     * La cadence la plus élevée l'emporte (intervalle entre images le plus court), puis la plus petite
+     * résolution (moins de données à transférer), puis le format non compressé (pas de décodage).
+     * Si aucun mode ne satisfait la cible, le mode le plus rapide est retenu.
+     * @param profiles Modes acceptés par la caméra.
+     * @param minWidth Largeur minimale souhaitée.
+     * @param minHeight Hauteur minimale souhaitée.
+     * @param minFps Cadence minimale souhaitée.
+     * @return Le mode retenu, ou le profil automatique si la liste est vide.
+     */
+    static CaptureProfile selectLowestLatency(const std::vector<CaptureProfile> &profiles,
+                                              int minWidth = 640, int minHeight = 480, double minFps = 30.0);
+
+    /**
+     * @brief Applique le profil à une capture ouverte.
+     * @param cap Capture ouverte.
+     * @return Le mode effectivement obtenu, relu auprès du backend.
+     */
+    CaptureProfile applyTo(cv::VideoCapture &cap) const;
+
+    /**
+     * @brief Lit le mode courant d'une capture ouverte.
+     * @param cap Capture ouverte.
+     * @return Le mode rapporté par le backend.
+     */
+    static CaptureProfile readFrom(cv::VideoCapture &cap);
+
+    /**
+     * @brief Profil choisi par l'utilisateur dans la fenêtre de paramètres (QSettings).
+     * @return Le profil enregistré, ou le profil automatique.
+     */
+    static CaptureProfile preferred();
+
+    /**
+     * @brief Enregistre le profil choisi par l'utilisateur (QSettings).
+     * @param profile Profil à utiliser lors des prochaines ouvertures de caméra.
+     */
+    static void setPreferred(const CaptureProfile &profile);
+};
+
+#endif // CAPTUREPROFILE_H
@@ -0,0 +1,136 @@
+#include "framescheduler.h"
+#include "gamelog.h"
+#include "samplestats.h"
+#include <QOpenGLWidget>
+#include <QScreen>
+#include <algorithm>
+
+// Constants
+const double LATE_FRAME_FACTOR = 1.5; // An interval longer than this many refresh periods is a missed vsync
+const int STATS_LOG_INTERVAL = 300;   // Frames between two pacing log lines (BIBLIO_LOG=frames)
+
+FrameScheduler::FrameScheduler(QOpenGLWidget *widget, double stepRate, QObject *parent)
+    : QObject(parent), widget(widget), stepSeconds(1.0 / stepRate)
+{
+    intervals.reserve(INTERVAL_HISTORY);
+    connect(widget, &QOpenGLWidget::frameSwapped, this, &FrameScheduler::frameSwapped);
+}
+
+void FrameScheduler::start()
+{
+    startTime = QTime::currentTime();
+    clock.start();
+    simulatedSeconds = 0.0;
+    accumulatedSeconds = 0.0;
+    lastAdvanceNs = 0;
+    lastSwapNs = -1;
+    widget->update();
+}
+
+QTime FrameScheduler::stepTime() const
+{
+    return timeAt(simulatedSeconds);
+}
+
+double FrameScheduler::interpolation() const
+{
+    return accumulatedSeconds / stepSeconds;
+}
+
+QTime FrameScheduler::renderTime() const
+{
+    // Between the previous step and the last one, so that interpolated state is never extrapolated
+    return timeAt(simulatedSeconds - stepSeconds + accumulatedSeconds);
+}
+
+QTime FrameScheduler::timeAt(double seconds) const
+{
+    return startTime.addMSecs(qRound64(seconds * 1000.0));
+}
+
+void FrameScheduler::advance()
+{
+    const qint64 nowNs = clock.nsecsElapsed();
+    accumulatedSeconds += (nowNs - lastAdvanceNs) / 1e9;
+    lastAdvanceNs = nowNs;
+
+    int steps = 0;
+    while (accumulatedSeconds >= stepSeconds)
+    {
+        if (steps == MAX_STEPS_PER_FRAME)
+        {
+            // Do not replay a long stall: jump the clock forward instead
+            const int skipped = static_cast<int>(accumulatedSeconds / stepSeconds);
+            simulatedSeconds += skipped * stepSeconds;
+            accumulatedSeconds -= skipped * stepSeconds;
+            totals.skippedSteps += skipped;
+            break;
+        }
+        simulatedSeconds += stepSeconds;
+        accumulatedSeconds -= stepSeconds;
+        ++steps;
+        ++totals.steps;
+        emit step(timeAt(simulatedSeconds));
+    }
+}
+
+void FrameScheduler::frameSwapped()
+{
+    if (!clock.isValid())
+    {
+        return;
+    }
+
+    const qint64 nowNs = clock.nsecsElapsed();
+    if (lastSwapNs >= 0)
+    {
+        const double intervalMs = (nowNs - lastSwapNs) / 1e6;
+        if (static_cast<int>(intervals.size()) < INTERVAL_HISTORY)
+        {
+            intervals.push_back(intervalMs);
+        }
+        else
+        {
+            intervals[nextInterval] = intervalMs;
+        }
+        nextInterval = (nextInterval + 1) % INTERVAL_HISTORY;
+
+        ++totals.frames;
+        totalIntervalMs += intervalMs;
+        totals.maxMs = std::max(totals.maxMs, intervalMs);
+        const double refreshRate = widget->screen() ? widget->screen()->refreshRate() : 60.0;
+        if (intervalMs > LATE_FRAME_FACTOR * 1000.0 / refreshRate)
+        {
+            ++totals.lateFrames;
+        }
+
+#ifdef BIBLIO_ENABLE_LOGGING
+        if (totals.frames % STATS_LOG_INTERVAL == 0 && GameLog::isEnabled(GameLog::Frames))
+        {
+            const Stats current = stats();
+            BIBLIO_LOG(Frames, "Frames: %d, mean %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms, %d late, %d skipped steps",
+                       current.frames, current.meanMs, current.p95Ms, current.p99Ms, current.maxMs, current.lateFrames, current.skippedSteps);
+        }
+#endif
+    }
+    lastSwapNs = nowNs;
+
+    advance();
+    widget->update();
+}
+
+FrameScheduler::Stats FrameScheduler::stats() const
+{
+    Stats result = totals;
+    result.refreshRate = widget->screen() ? widget->screen()->refreshRate() : 0.0;
+    if (totals.frames > 0)
+    {
+        result.meanMs = totalIntervalMs / totals.frames;
+    }
+    if (!intervals.empty())
+    {
+        result.p95Ms = SampleStats::percentile(intervals, 0.95);
+        result.p99Ms = SampleStats::percentile(intervals, 0.99);
+    }
+    return result;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file framescheduler.h
+ * @brief Déclaration de la classe FrameScheduler.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTime>
+#include <vector>
+
+class QOpenGLWidget;
+
+/**
+ * @class FrameScheduler
+ * @brief Boucle de rendu cadencée par la synchronisation verticale, avec une logique de jeu à pas fixe.
+ *
+ * Chaque image présentée (signal QOpenGLWidget::frameSwapped) fait avancer l'horloge de
+ * simulation : le signal step() est émis autant de fois que nécessaire, à pas fixe, puis une
+ * nouvelle image est demandée. Le jeu tourne ainsi à la fréquence de l'écran, sans minuterie.
+ *
+ * L'image est dessinée entre les deux derniers pas : renderTime() et interpolation() donnent
+ * l'instant et la fraction de pas à utiliser pour interpoler l'état dessiné.
+ *
+ * Les intervalles entre images sont mesurés pour contrôler la régularité (stats()).
+ */
+class FrameScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @struct Stats
+     * @brief Régularité des images depuis le démarrage.
+     */
+    struct Stats
+    {
+        int frames = 0;             ///< Images présentées.
+        double meanMs = 0.0;        ///< Intervalle moyen entre deux images (ms).
+        double p95Ms = 0.0;         ///< 95e centile des intervalles récents (ms).
+        double p99Ms = 0.0;         ///< 99e centile des intervalles récents (ms).
+        double maxMs = 0.0;         ///< Plus long intervalle (ms).
+        int lateFrames = 0;         ///< Images présentées plus d'une période et demie d'écran après la précédente.
+        int steps = 0;              ///< Pas de simulation exécutés.
+        int skippedSteps = 0;       ///< Pas abandonnés après une longue interruption (fenêtre cachée, blocage).
+        double refreshRate = 0.0;   ///< Fréquence de rafraîchissement de l'écran (Hz).
+    };
+
+    /**
+     * @brief Construit l'ordonnanceur d'un widget OpenGL.
+     * @param widget Widget dessiné à chaque image.
+     * @param stepRate Fréquence des pas de simulation (Hz).
+     * @param parent Objet parent.
+     */
+    explicit FrameScheduler(QOpenGLWidget *widget, double stepRate = 60.0, QObject *parent = nullptr);
+
+    /**
+     * @brief Démarre la boucle : l'horloge de simulation part de l'heure courante.
+     */
+    void start();
+
+    /**
+     * @brief Instant du dernier pas de simulation.
+     */
+    QTime stepTime() const;
+
+    /**
+     * @brief Fraction du pas écoulée depuis le dernier pas, dans [0, 1).
+     */
+    double interpolation() const;
+
+    /**
+     * @brief Instant à dessiner, interpolé entre les deux derniers pas.
+     * Il peut précéder d'au plus un pas le lancement d'un objet créé au dernier pas : Fruit ramène cet instant à son lancement.
+     */
+    QTime renderTime() const;
+
+    /**
+     * @brief Statistiques de régularité des images.
+     */
+    Stats stats() const;
+
+signals:
+    /**
+     * @brief Pas de simulation à fréquence fixe.
+     * @param time Instant simulé de ce pas.
+     */
+    void step(QTime time);
+
+private slots:
+    /**
+     * @brief Appelé après chaque présentation : mesure l'intervalle, avance la simulation et demande l'image suivante.
+     */
+    void frameSwapped();
+
+private:
+    /**
+     * @brief Exécute les pas de simulation dus à l'instant courant.
+     */
+    void advance();
+
+    /**
+     * @brief Instant correspondant à un temps de simulation.
+     * @param seconds Secondes depuis start().
+     */
+    QTime timeAt(double seconds) const;
+
+    static constexpr int MAX_STEPS_PER_FRAME = 5;  ///< Au-delà, le retard est abandonné plutôt que rattrapé.
+    static constexpr int INTERVAL_HISTORY = 600;   ///< Intervalles conservés pour les centiles.
+
+    QOpenGLWidget *widget;              ///< Widget redessiné à chaque image.
+    double stepSeconds;                 ///< Durée d'un pas (s).
+    QTime startTime;                    ///< Heure de start().
+    QElapsedTimer clock;                ///< Horloge monotone depuis start().
+    double simulatedSeconds = 0.0;      ///< Temps du dernier pas depuis start() (s).
+    double accumulatedSeconds = 0.0;    ///< Temps écoulé pas encore simulé (s).
+    qint64 lastAdvanceNs = 0;           ///< Horloge au dernier advance() (ns).
+    qint64 lastSwapNs = -1;             ///< Horloge à la dernière présentation (ns), -1 avant la première.
+
+    std::vector<double> intervals;      ///< Derniers intervalles entre images (ms), tampon circulaire.
+    int nextInterval = 0;               ///< Prochaine case de intervals.
+    Stats totals;                       ///< Compteurs cumulés.
+    double totalIntervalMs = 0.0;       ///< Somme des intervalles (ms).
+};
+
+#endif // FRAMESCHEDULER_H
@@ -0,0 +1,156 @@
+#include "framesource.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <opencv2/imgcodecs.hpp>
+#include <thread>
+
+std::unique_ptr<FrameSource> FrameSource::create(const QString &location, double rate, bool loop, double sequenceFps)
+{
+    QFileInfo info(location);
+    if (info.isDir())
+    {
+        auto sequence = std::make_unique<ImageSequenceSource>(location, sequenceFps, rate, loop);
+        if (sequence->isOpened())
+        {
+            return sequence;
+        }
+        qDebug() << "Error: no images found in" << location;
+        return nullptr;
+    }
+
+    auto video = std::make_unique<VideoFileSource>(location, rate, loop);
+    if (video->isOpened())
+    {
+        return video;
+    }
+    qDebug() << "Error: could not open video file" << location;
+    return nullptr;
+}
+
+void FrameSource::pace(double timestampMs)
+{
+    if (rate <= 0.0)
+    {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (!pacingStarted)
+    {
+        pacingStart = now;
+        firstTimestampMs = timestampMs;
+        pacingStarted = true;
+        return;
+    }
+
+    // Deliver on the source's own timeline, compressed by the rate; never try to catch up on late frames
+    auto offset = std::chrono::duration<double, std::milli>((timestampMs - firstTimestampMs) / rate);
+    auto due = pacingStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+    if (due > now)
+    {
+        std::this_thread::sleep_until(due);
+    }
+}
+
+VideoFileSource::VideoFileSource(const QString &path, double rate, bool loop)
+    : FrameSource(rate, loop), path(path)
+{
+    video.open(path.toStdString());
+    if (video.isOpened())
+    {
+        double declared = video.get(cv::CAP_PROP_FPS);
+        if (declared > 0.0)
+        {
+            fps = declared;
+        }
+        size = cv::Size(static_cast<int>(video.get(cv::CAP_PROP_FRAME_WIDTH)),
+                        static_cast<int>(video.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    }
+}
+
+bool VideoFileSource::grab()
+{
+    if (!video.grab())
+    {
+        if (!loop)
+        {
+            return false;
+        }
+        video.set(cv::CAP_PROP_POS_FRAMES, 0);
+        frameIndex = 0;
+        restartPacing();
+        if (!video.grab())
+        {
+            return false;
+        }
+    }
+
+    // Container timestamps handle variable frame rate files; fall back to the declared rate
+    double timestampMs = video.get(cv::CAP_PROP_POS_MSEC);
+    if (timestampMs <= 0.0 && frameIndex > 0)
+    {
+        timestampMs = frameIndex * 1000.0 / fps;
+    }
+    ++frameIndex;
+    pace(timestampMs);
+    return true;
+}
+
+bool VideoFileSource::retrieve(cv::Mat &frame)
+{
+    return video.retrieve(frame) && !frame.empty();
+}
+
+QString VideoFileSource::description() const
+{
+    return QString("video %1 (%2 fps)").arg(path).arg(fps);
+}
+
+ImageSequenceSource::ImageSequenceSource(const QString &directory, double fps, double rate, bool loop)
+    : FrameSource(rate, loop), directory(directory), fps(fps > 0.0 ? fps : 30.0)
+{
+    QDir dir(directory);
+    const QStringList filters = {"*.png", "*.jpg", "*.jpeg", "*.bmp", "*.pgm", "*.ppm"};
+    for (const QString &name : dir.entryList(filters, QDir::Files, QDir::Name))
+    {
+        files << dir.filePath(name);
+    }
+
+    if (!files.isEmpty())
+    {
+        cv::Mat first = cv::imread(files.first().toStdString(), cv::IMREAD_COLOR);
+        size = first.size();
+    }
+}
+
+bool ImageSequenceSource::grab()
+{
+    if (next >= files.size())
+    {
+        if (!loop || files.isEmpty())
+        {
+            return false;
+        }
+        next = 0;
+        restartPacing();
+    }
+
+    current = cv::imread(files[next].toStdString(), cv::IMREAD_COLOR);
+    pace(next * 1000.0 / fps);
+    ++next;
+    return !current.empty();
+}
+
+bool ImageSequenceSource::retrieve(cv::Mat &frame)
+{
+    // Hand over the decoded image; the next grab() decodes into a fresh buffer
+    frame = current;
+    current.release();
+    return !frame.empty();
+}
+
+QString ImageSequenceSource::description() const
+{
+    return QString("image sequence %1 (%2 images, %3 fps)").arg(directory).arg(files.size()).arg(fps);
+}
@@ -0,0 +1,171 @@
+/**
+ * @file framesource.h
+ * @brief Déclaration des sources d'images rejouées (fichier vidéo, séquence d'images).
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include <QString>
+#include <QStringList>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @class FrameSource
+ * @brief Source d'images remplaçant la caméra, rejouée à la cadence enregistrée ou accélérée.
+ *
+ * L'interface reprend grab()/retrieve() de cv::VideoCapture pour que le thread de capture de
+ * CameraHandler traite une caméra et une source rejouée de la même façon. grab() attend l'instant
+ * auquel l'image doit être livrée : cadence d'origine multipliée par rate. Avec rate = 0 la source
+ * n'attend pas ; CameraHandler livre alors chaque image une à une (aucune n'est perdue), ce qui
+ * rend l'exécution reproductible.
+ */
+class FrameSource
+{
+public:
+    virtual ~FrameSource() = default;
+
+    /**
+     * @brief Crée la source adaptée à un chemin : dossier d'images ou fichier vidéo.
+     * @param location Chemin du fichier vidéo ou du dossier contenant les images (triées par nom).
+     * @param rate Multiplicateur de cadence (1 : temps réel, 2 : deux fois plus vite, 0 : sans attente).
+     * @param loop true pour reprendre au début une fois la fin atteinte.
+     * @param sequenceFps Cadence d'origine attribuée aux séquences d'images.
+     * @return La source ouverte, ou nullptr si le chemin ne peut pas être lu.
+     */
+    static std::unique_ptr<FrameSource> create(const QString &location, double rate, bool loop, double sequenceFps = 30.0);
+
+    /**
+     * @brief Passe à l'image suivante, en attendant l'instant de sa livraison.
+     * @return false si la fin est atteinte (hors boucle) ou en cas d'erreur de lecture.
+     */
+    virtual bool grab() = 0;
+
+    /**
+     * @brief Récupère l'image obtenue par le dernier grab().
+     * @param frame Image couleur (BGR). (paramètre de sortie)
+     * @return true si une image est disponible.
+     */
+    virtual bool retrieve(cv::Mat &frame) = 0;
+
+    /**
+     * @brief Dimensions des images de la source.
+     */
+    virtual cv::Size frameSize() const = 0;
+
+    /**
+     * @brief Cadence d'origine de la source, en images par seconde.
+     */
+    virtual double frameRate() const = 0;
+
+    /**
+     * @brief Description lisible de la source, pour les journaux.
+     */
+    virtual QString description() const = 0;
+
+    /**
+     * @brief Indique si grab() respecte une cadence (rate > 0).
+     * @return false si les images sont livrées sans attente.
+     */
+    bool isPaced() const { return rate > 0.0; }
+
+protected:
+    /**
+     * @brief Constructeur commun.
+     * @param rate Multiplicateur de cadence.
+     * @param loop Lecture en boucle.
+     */
+    FrameSource(double rate, bool loop) : rate(rate), loop(loop) {}
+
+    /**
+     * @brief Attend l'instant de livraison d'une image.
+     * @param timestampMs Horodatage de l'image dans la source, en millisecondes.
+     */
+    void pace(double timestampMs);
+
+    /**
+     * @brief Repart de zéro pour la cadence (début de lecture ou retour au début en boucle).
+     */
+    void restartPacing() { pacingStarted = false; }
+
+    double rate;    ///< Multiplicateur de cadence (0 : sans attente).
+    bool loop;      ///< Reprise au début une fois la fin atteinte.
+
+private:
+    bool pacingStarted = false;                             ///< Indique qu'une première image a fixé l'origine des temps.
+    std::chrono::steady_clock::time_point pacingStart;      ///< Instant de livraison de la première image.
+    double firstTimestampMs = 0.0;                          ///< Horodatage de la première image dans la source.
+};
+
+/**
+ * @class VideoFileSource
+ * @brief Rejoue un fichier vidéo, au rythme de ses horodatages.
+ */
+class VideoFileSource : public FrameSource
+{
+public:
+    /**
+     * @brief Ouvre le fichier vidéo.
+     * @param path Chemin du fichier.
+     * @param rate Multiplicateur de cadence.
+     * @param loop Lecture en boucle.
+     */
+    VideoFileSource(const QString &path, double rate, bool loop);
+
+    /** @brief Indique si le fichier a pu être ouvert. */
+    bool isOpened() const { return video.isOpened(); }
+
+    bool grab() override;
+    bool retrieve(cv::Mat &frame) override;
+    cv::Size frameSize() const override { return size; }
+    double frameRate() const override { return fps; }
+    QString description() const override;
+
+private:
+    QString path;               ///< Chemin du fichier vidéo.
+    cv::VideoCapture video;     ///< Décodeur du fichier.
+    double fps = 30.0;          ///< Cadence déclarée par le fichier.
+    cv::Size size;              ///< Dimensions déclarées par le fichier.
+    int64_t frameIndex = 0;     ///< Indice de l'image courante depuis le début (ou le dernier retour au début).
+};
+
+/**
+ * @class ImageSequenceSource
+ * @brief Rejoue les images d'un dossier, dans l'ordre de leurs noms, à cadence fixe.
+ */
+class ImageSequenceSource : public FrameSource
+{
+public:
+    /**
+     * @brief Liste les images du dossier (png, jpg, bmp, pgm, ppm).
+     * @param directory Dossier contenant les images.
+     * @param fps Cadence d'origine attribuée à la séquence.
+     * @param rate Multiplicateur de cadence.
+     * @param loop Lecture en boucle.
+     */
+    ImageSequenceSource(const QString &directory, double fps, double rate, bool loop);
+
+    /** @brief Indique si le dossier contient au moins une image. */
+    bool isOpened() const { return !files.isEmpty(); }
+
+    bool grab() override;
+    bool retrieve(cv::Mat &frame) override;
+    cv::Size frameSize() const override { return size; }
+    double frameRate() const override { return fps; }
+    QString description() const override;
+
+private:
+    QString directory;      ///< Dossier de la séquence.
+    QStringList files;      ///< Chemins des images, triés par nom.
+    double fps;             ///< Cadence d'origine attribuée à la séquence.
+    int next = 0;           ///< Indice de la prochaine image à lire.
+    cv::Mat current;        ///< Image lue par le dernier grab().
+    cv::Size size;          ///< Dimensions de la première image.
+};
+
+#endif // FRAMESOURCE_H
@@ -12,11 +12,12 @@
 #include <QVector3D>
 #include <QTime>
 #include <QVector4D> // Added for QVector4D
-#ifdef __APPLE__
-#include <OpenGL/glu.h>
-#else
-#include <GL/glu.h>
-#endif
+#include <QMatrix4x4>
+#include <memory>
+
+class FruitMeshLibrary;
+class RenderQueue;
+struct FruitSlice;
 
 /**
  * @class Fruit
@@ -64,12 +65,6 @@ public:
      */
     Fruit(GLuint* textures, QTime currentTime);
 
-    /**
-     * @brief Destructeur de la classe Fruit.
-     * Libère les ressources allouées (par exemple, l'objet quadrique GLU).
-     */
-    ~Fruit();
-
     /**
      * @brief Vérifie si le fruit est une bombe.
      * @return true si le type actuel est BOMB, false sinon.
@@ -83,11 +78,13 @@ public:
     void setType(FruitType type);
 
     /**
-     * @brief Dessine le fruit à sa position actuelle.
+     * @brief Soumet les parties du fruit à sa position actuelle à la file de rendu (passe opaque).
+     * @param queue File de rendu de l'image.
      * @param currentTime Temps actuel, utilisé pour calculer la position et gérer les animations.
-     * @note Appelle la méthode de dessin spécifique au type de fruit.
+     * @param meshes Maillages des fruits, déjà envoyés au GPU dans le contexte courant.
+     * @note Un fruit coupé est soumis en deux moitiés fermées, découpées une seule fois dans son maillage.
      */
-    void draw(QTime currentTime);
+    void submit(RenderQueue &queue, QTime currentTime, FruitMeshLibrary &meshes);
 
     /**
      * @brief Calcule et retourne la position du fruit à un temps donné.
@@ -99,98 +96,91 @@ public:
     QVector3D getPosition(QTime currentTime, float firstPart = 1.f);
 
     /**
-     * @brief Retourne la direction (vitesse) initiale du fruit.
-     * @return QVector3D représentant la vitesse initiale.
+     * @brief Calcule la transformation du fruit (position puis rotation dans le temps).
+     * @param currentTime Temps actuel.
+     * @param firstPart Moitié du fruit coupé (1 ou -1), comme pour getPosition().
+     * @return Matrice modèle, de l'espace du maillage vers la scène.
      */
-    QVector3D getInitialDirection() { return initalSpeed; }
+    QMatrix4x4 getModelMatrix(QTime currentTime, float firstPart = 1.f);
 
     /**
-     * @brief Marque le fruit comme coupé et définit le plan de coupe.
-     * @param cutOriginPoint Point d'origine sur le plan de coupe.
-     * @param cutNormalVector Vecteur normal au plan de coupe.
-     * @param currentTime Temps actuel auquel le fruit est coupé.
+     * @brief Retourne le type du fruit.
      */
-    void cut(const QVector3D& cutOriginPoint, const QVector3D& cutNormalVector, QTime currentTime);
+    FruitType getType() const { return currentFruit; }
 
     /**
-     * @brief Vérifie si le fruit a été coupé.
-     * @return true si le fruit est coupé, false sinon.
+     * @brief Choisit le niveau de détail du maillage dessiné (FruitMeshLibrary::levelFor()).
+     * @param level Niveau de détail, 0 pour le maillage complet. Un fruit coupé garde ses moitiés découpées dans le maillage complet.
      */
-    bool isCut() const;
-    
-private :
-    FruitType currentFruit; ///< Type actuel du fruit (pomme, bombe, etc.).
+    void setDetailLevel(int level) { m_detailLevel = level; }
 
     /**
-     * @brief Dessine une pomme.
-     * @param currentTime Temps actuel pour le calcul de la position.
-     * @param firstPart Facteur pour dessiner une partie du fruit (utilisé si coupé).
+     * @brief Retourne le niveau de détail du maillage dessiné.
      */
-    void drawApple(QTime currentTime, float firstPart = 1.f);
+    int getDetailLevel() const { return m_detailLevel; }
 
     /**
-     * @brief Dessine une fraise.
-     * @param currentTime Temps actuel pour le calcul de la position.
-     * @param firstPart Facteur pour dessiner une partie du fruit (utilisé si coupé).
+     * @brief Retourne les deux moitiés du fruit coupé, découpées à la première demande.
+     * @param meshes Maillages des fruits (et cache des coupes).
+     * @return Moitiés du fruit, nullptr s'il n'est pas coupé.
      */
-    void drawStrawberry(QTime currentTime, float firstPart = 1.f);
+    FruitSlice *getSlice(FruitMeshLibrary &meshes);
 
     /**
-     * @brief Dessine une banane.
-     * @param currentTime Temps actuel pour le calcul de la position.
-     * @param firstPart Facteur pour dessiner une partie du fruit (utilisé si coupé).
+     * @brief Retourne la direction (vitesse) initiale du fruit.
+     * @return QVector3D représentant la vitesse initiale.
      */
-    void drawBanana(QTime currentTime, float firstPart = 1.f);
+    QVector3D getInitialDirection() { return initalSpeed; }
 
     /**
-     * @brief Dessine une poire.
-     * @param currentTime Temps actuel pour le calcul de la position.
-     * @param firstPart Facteur pour dessiner une partie du fruit (utilisé si coupé).
+     * @brief Marque le fruit comme coupé et définit le plan de coupe.
+     * @param cutOriginPoint Point d'origine sur le plan de coupe.
+     * @param cutNormalVector Vecteur normal au plan de coupe.
+     * @param currentTime Temps actuel auquel le fruit est coupé.
      */
-    void drawPear(QTime currentTime, float firstPart = 1.f);
+    void cut(const QVector3D& cutOriginPoint, const QVector3D& cutNormalVector, QTime currentTime);
 
     /**
-     * @brief Dessine une bombe.
-     * @param currentTime Temps actuel pour le calcul de la position.
-     * @param firstPart Facteur pour dessiner une partie de la bombe (utilisé si coupée).
+     * @brief Vérifie si le fruit a été coupé.
+     * @return true si le fruit est coupé, false sinon.
      */
-    void drawBomb(QTime currentTime, float firstPart = 1.f);
+    bool isCut() const;
+    
+private :
+    FruitType currentFruit; ///< Type actuel du fruit (pomme, bombe, etc.).
 
     /**
-     * @brief Applique une texture à l'objet.
-     * @param textureID Identifiant de la texture OpenGL à appliquer.
+     * @brief Soumet les parties d'un maillage du fruit, chacune avec sa texture ou son matériau.
+     * @param queue File de rendu de l'image.
+     * @param meshes Maillages des fruits.
+     * @param slice Moitiés du fruit coupé dont le tampon contient les parties, nullptr pour le fruit entier.
+     * @param currentTime Temps actuel pour le calcul de la position et de la rotation.
+     * @param firstPart Moitié à soumettre si le fruit est coupé (1 ou -1).
      */
-    void setTexture(GLuint textureID);
+    void submitMesh(RenderQueue &queue, FruitMeshLibrary &meshes, FruitSlice *slice, QTime currentTime, float firstPart = 1.f);
 
     /**
-     * @brief Définit les propriétés matérielles pour l'éclairage OpenGL.
-     * @param ambient Composante ambiante du matériau.
-     * @param diffuse Composante diffuse du matériau.
-     * @param specular Composante spéculaire du matériau.
-     * @param shininess Exposant de brillance spéculaire.
+     * @brief Temps écoulé depuis le lancement, nul pour un instant antérieur au lancement.
+     * @param currentTime Instant évalué.
+     * @return Millisecondes écoulées, au moins 0.
      */
-    void setMaterial(const GLfloat* ambient, const GLfloat* diffuse, const GLfloat* specular, const  GLfloat* shininess);
+    int elapsedMs(QTime currentTime) const;
     
     /**
      * @brief Sélectionne un type de fruit aléatoire (excluant la bombe).
      * @return FruitType aléatoire.
      */
     FruitType getRandomFruitType();
-
-    /**
-     * @brief Génère une vitesse initiale aléatoire pour le fruit.
-     * @return QVector3D représentant la vitesse initiale aléatoire.
-     */
-    QVector3D getRandomInitSpeed();
     
     QVector3D initalSpeed;      ///< Vitesse initiale du fruit lors de son lancement.
     QVector3D initialPosition;  ///< Position initiale du fruit lors de son lancement.
-    GLUquadric* quadric;        ///< Objet quadrique GLU utilisé pour dessiner des formes (sphères, cylindres).
     GLuint* textures;           ///< Pointeur vers le tableau global de textures OpenGL.
     QTime startTime;            ///< Temps auquel le fruit a été créé ou lancé.
 
     bool m_isCut;               ///< Indicateur booléen : true si le fruit a été coupé, false sinon.
-    QVector4D m_clipPlaneEquation; ///< Équation du plan de coupe (Ax + By + Cz + D = 0) sous forme de QVector4D (A, B, C, D).
+    QVector4D m_clipPlaneEquation; ///< Équation du plan de coupe (Ax + By + Cz + D = 0) dans l'espace du maillage, sous forme de QVector4D (A, B, C, D).
+    std::shared_ptr<FruitSlice> m_slice; ///< Moitiés du fruit coupé (partagées avec le cache de FruitMeshLibrary).
+    int m_detailLevel = 0;      ///< Niveau de détail du maillage entier dessiné.
     QVector3D normal;           ///< Vecteur normal au plan de coupe (redondant avec m_clipPlaneEquation.toVector3D() ?).
     QTime cutTime;              ///< Temps auquel le fruit a été coupé.
 
@@ -0,0 +1,847 @@
+#include "fruitmeshlibrary.h"
+#include "gamelog.h"
+#include "glresourceregistry.h"
+#include <QDebug>
+#include <QMatrix4x4>
+#include <QPointF>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+namespace
+{
+
+using MeshVertex = FruitMeshLibrary::Vertex;
+
+struct Material
+{
+    GLfloat ambient[4];
+    GLfloat diffuse[4];
+    GLfloat specular[4];
+    GLfloat shininess;
+};
+
+// Constants
+const Material STEM_MATERIAL = {{0.4f, 0.2f, 0.0f, 1.0f}, {0.5f, 0.25f, 0.0f, 1.0f}, {0.1f, 0.05f, 0.0f, 1.0f}, 10.0f};
+const Material CALYX_MATERIAL = {{0.1f, 0.1f, 0.0f, 1.0f}, {0.2f, 0.2f, 0.0f, 1.0f}, {0.05f, 0.05f, 0.0f, 1.0f}, 5.0f};
+const Material FUSE_MATERIAL = {{0.2f, 0.2f, 0.1f, 1.0f}, {0.4f, 0.4f, 0.2f, 1.0f}, {0.1f, 0.1f, 0.05f, 1.0f}, 5.0f};
+
+// Inside of each type, for the faces left by a cut through a textured part
+const Material FLESH_MATERIALS[] = {
+    {{0.45f, 0.42f, 0.3f, 1.0f}, {0.95f, 0.9f, 0.65f, 1.0f}, {0.2f, 0.2f, 0.2f, 1.0f}, 20.0f},   // APPLE
+    {{0.45f, 0.1f, 0.1f, 1.0f}, {0.95f, 0.35f, 0.35f, 1.0f}, {0.3f, 0.2f, 0.2f, 1.0f}, 30.0f},   // STRAWBERRY
+    {{0.45f, 0.45f, 0.35f, 1.0f}, {0.98f, 0.95f, 0.75f, 1.0f}, {0.1f, 0.1f, 0.1f, 1.0f}, 10.0f}, // BANANA
+    {{0.45f, 0.45f, 0.3f, 1.0f}, {0.95f, 0.95f, 0.7f, 1.0f}, {0.2f, 0.2f, 0.2f, 1.0f}, 20.0f},   // PEAR
+    {{0.05f, 0.05f, 0.05f, 1.0f}, {0.15f, 0.15f, 0.15f, 1.0f}, {0.05f, 0.05f, 0.05f, 1.0f}, 5.0f}, // BOMB
+};
+
+// Cut planes are rounded so that close cuts share their halves
+const float SLICE_NORMAL_STEPS = 32.0f;
+const float SLICE_DISTANCE_STEPS = 200.0f;
+const float OUTLINE_WELD_DISTANCE = 1e-4f; // Cut outline points closer than this are the same point
+const int SLICE_CACHE_SIZE = 32;
+
+// Tessellation of each level of detail relative to the full meshes, and the projected radius
+// (device pixels) from which a level is used; below the last threshold the coarsest level is drawn
+const float LEVEL_DETAIL[FruitMeshLibrary::LEVEL_COUNT] = {1.0f, 0.5f, 0.3f, 0.18f};
+const float LEVEL_MIN_RADIUS[FruitMeshLibrary::LEVEL_COUNT - 1] = {48.0f, 24.0f, 12.0f};
+const int MIN_SEGMENTS = 3;
+
+FruitMeshLibrary::Part materialPart(const Material &material)
+{
+    FruitMeshLibrary::Part part;
+    std::copy(material.ambient, material.ambient + 4, part.ambient);
+    std::copy(material.diffuse, material.diffuse + 4, part.diffuse);
+    std::copy(material.specular, material.specular + 4, part.specular);
+    part.shininess = material.shininess;
+    return part;
+}
+
+// Appends transformed GLU-style primitives as triangles, grouped into parts
+class MeshBuilder
+{
+public:
+    MeshBuilder(std::vector<MeshVertex> &vertices, float detail) : vertices(vertices), detail(detail) {}
+
+    void beginTexturedPart(std::vector<FruitMeshLibrary::Part> &parts, int textureIndex)
+    {
+        FruitMeshLibrary::Part part;
+        part.textureIndex = textureIndex;
+        beginPart(parts, part);
+    }
+
+    void beginMaterialPart(std::vector<FruitMeshLibrary::Part> &parts, const Material &material)
+    {
+        FruitMeshLibrary::Part part = materialPart(material);
+        beginPart(parts, part);
+    }
+
+    void endPart()
+    {
+        currentParts->back().count = static_cast<GLsizei>(vertices.size()) - currentParts->back().first;
+    }
+
+    // gluSphere: poles on the z axis, s = 1 - slice/slices, t = 1 at +z
+    void sphere(const QMatrix4x4 &transform, float radius, int slices, int stacks)
+    {
+        slices = subdivisions(slices);
+        stacks = subdivisions(stacks);
+        for (int j = 0; j < stacks; ++j)
+        {
+            for (int i = 0; i < slices; ++i)
+            {
+                quad(transform,
+                     sphereVertex(radius, slices, stacks, i, j), sphereVertex(radius, slices, stacks, i + 1, j),
+                     sphereVertex(radius, slices, stacks, i + 1, j + 1), sphereVertex(radius, slices, stacks, i, j + 1));
+            }
+        }
+    }
+
+    // gluCylinder: along +z from 0 to height, s = 1 - slice/slices, t = stack/stacks
+    void cylinder(const QMatrix4x4 &transform, float baseRadius, float topRadius, float height, int slices, int stacks)
+    {
+        slices = subdivisions(slices);
+        stacks = subdivisions(stacks);
+        for (int j = 0; j < stacks; ++j)
+        {
+            for (int i = 0; i < slices; ++i)
+            {
+                quad(transform,
+                     cylinderVertex(baseRadius, topRadius, height, slices, stacks, i, j),
+                     cylinderVertex(baseRadius, topRadius, height, slices, stacks, i + 1, j),
+                     cylinderVertex(baseRadius, topRadius, height, slices, stacks, i + 1, j + 1),
+                     cylinderVertex(baseRadius, topRadius, height, slices, stacks, i, j + 1));
+            }
+        }
+    }
+
+    // gluDisk with no hole: in the z = 0 plane, facing +z
+    void disk(const QMatrix4x4 &transform, float radius, int slices)
+    {
+        slices = subdivisions(slices);
+        MeshVertex center = {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.5f, 0.5f}};
+        for (int i = 0; i < slices; ++i)
+        {
+            triangle(transform, center, diskVertex(radius, slices, i), diskVertex(radius, slices, i + 1));
+        }
+    }
+
+    // Surface of revolution around y from (height, radius) profile points, as the strawberry body
+    void lathe(const QMatrix4x4 &transform, const float (*profile)[2], int profilePoints, int segments)
+    {
+        segments = subdivisions(segments);
+        for (int j = 0; j < profilePoints - 1; ++j)
+        {
+            float y1 = profile[j][0], r1 = profile[j][1];
+            float y2 = profile[j + 1][0], r2 = profile[j + 1][1];
+            float v1 = static_cast<float>(j) / (profilePoints - 1);
+            float v2 = static_cast<float>(j + 1) / (profilePoints - 1);
+
+            // Outward normal of this band in the (radial, y) plane
+            float normalLength = std::sqrt((y2 - y1) * (y2 - y1) + (r2 - r1) * (r2 - r1));
+            float radialNormal = (y2 - y1) / normalLength;
+            float axialNormal = -(r2 - r1) / normalLength;
+
+            for (int i = 0; i < segments; ++i)
+            {
+                float angle1 = (2.0f * M_PI * i) / segments;
+                float angle2 = (2.0f * M_PI * (i + 1)) / segments;
+                float u1 = static_cast<float>(i) / segments;
+                float u2 = static_cast<float>(i + 1) / segments;
+
+                auto vertex = [&](float radius, float y, float angle, float u, float v) {
+                    return MeshVertex{{radius * std::cos(angle), y, radius * std::sin(angle)},
+                                      {radialNormal * std::cos(angle), axialNormal, radialNormal * std::sin(angle)},
+                                      {u, v}};
+                };
+                quad(transform, vertex(r1, y1, angle1, u1, v1), vertex(r1, y1, angle2, u2, v1),
+                     vertex(r2, y2, angle2, u2, v2), vertex(r2, y2, angle1, u1, v2));
+            }
+        }
+    }
+
+private:
+    std::vector<MeshVertex> &vertices;
+    float detail;
+    std::vector<FruitMeshLibrary::Part> *currentParts = nullptr;
+
+    // Subdivisions at this builder's level of detail; single bands stay single
+    int subdivisions(int full) const
+    {
+        return full <= 1 ? full : std::max(MIN_SEGMENTS, qRound(full * detail));
+    }
+
+    void beginPart(std::vector<FruitMeshLibrary::Part> &parts, FruitMeshLibrary::Part &part)
+    {
+        part.first = static_cast<GLint>(vertices.size());
+        parts.push_back(part);
+        currentParts = &parts;
+    }
+
+    static MeshVertex sphereVertex(float radius, int slices, int stacks, int i, int j)
+    {
+        float theta = 2.0f * M_PI * i / slices;
+        float phi = M_PI * j / stacks;
+        QVector3D normal(std::sin(phi) * std::sin(theta), std::sin(phi) * std::cos(theta), std::cos(phi));
+        return {{radius * normal.x(), radius * normal.y(), radius * normal.z()},
+                {normal.x(), normal.y(), normal.z()},
+                {1.0f - static_cast<float>(i) / slices, 1.0f - static_cast<float>(j) / stacks}};
+    }
+
+    static MeshVertex cylinderVertex(float baseRadius, float topRadius, float height, int slices, int stacks, int i, int j)
+    {
+        float theta = 2.0f * M_PI * i / slices;
+        float t = static_cast<float>(j) / stacks;
+        float radius = baseRadius + (topRadius - baseRadius) * t;
+        QVector3D normal = QVector3D(std::sin(theta) * height, std::cos(theta) * height, baseRadius - topRadius).normalized();
+        return {{radius * std::sin(theta), radius * std::cos(theta), height * t},
+                {normal.x(), normal.y(), normal.z()},
+                {1.0f - static_cast<float>(i) / slices, t}};
+    }
+
+    static MeshVertex diskVertex(float radius, int slices, int i)
+    {
+        float theta = 2.0f * M_PI * i / slices;
+        return {{radius * std::sin(theta), radius * std::cos(theta), 0.0f},
+                {0.0f, 0.0f, 1.0f},
+                {0.5f + 0.5f * std::sin(theta), 0.5f + 0.5f * std::cos(theta)}};
+    }
+
+    void quad(const QMatrix4x4 &transform, const MeshVertex &a, const MeshVertex &b, const MeshVertex &c, const MeshVertex &d)
+    {
+        triangle(transform, a, b, c);
+        triangle(transform, a, c, d);
+    }
+
+    void triangle(const QMatrix4x4 &transform, MeshVertex a, MeshVertex b, MeshVertex c)
+    {
+        const QMatrix3x3 normalMatrix = transform.normalMatrix();
+        for (MeshVertex *vertex : {&a, &b, &c})
+        {
+            QVector3D position = transform.map(QVector3D(vertex->position[0], vertex->position[1], vertex->position[2]));
+            QVector3D normal(
+                normalMatrix(0, 0) * vertex->normal[0] + normalMatrix(0, 1) * vertex->normal[1] + normalMatrix(0, 2) * vertex->normal[2],
+                normalMatrix(1, 0) * vertex->normal[0] + normalMatrix(1, 1) * vertex->normal[1] + normalMatrix(1, 2) * vertex->normal[2],
+                normalMatrix(2, 0) * vertex->normal[0] + normalMatrix(2, 1) * vertex->normal[1] + normalMatrix(2, 2) * vertex->normal[2]);
+            normal.normalize();
+            vertex->position[0] = position.x();
+            vertex->position[1] = position.y();
+            vertex->position[2] = position.z();
+            vertex->normal[0] = normal.x();
+            vertex->normal[1] = normal.y();
+            vertex->normal[2] = normal.z();
+        }
+
+        // Counter-clockwise when seen from the side the normals point to
+        QVector3D pa(a.position[0], a.position[1], a.position[2]);
+        QVector3D pb(b.position[0], b.position[1], b.position[2]);
+        QVector3D pc(c.position[0], c.position[1], c.position[2]);
+        QVector3D faceNormal = QVector3D::crossProduct(pb - pa, pc - pa);
+        if (faceNormal.lengthSquared() == 0.0f)
+        {
+            return; // Degenerate triangle at a pole
+        }
+        if (QVector3D::dotProduct(faceNormal, QVector3D(a.normal[0], a.normal[1], a.normal[2])) < 0.0f)
+        {
+            std::swap(b, c);
+        }
+        vertices.push_back(a);
+        vertices.push_back(b);
+        vertices.push_back(c);
+    }
+};
+
+// Same transform stack as the former immediate-mode drawing code, starting from the fruit's own frame
+QMatrix4x4 placed(float x, float y, float z, float rotateX = 0.0f)
+{
+    QMatrix4x4 transform;
+    transform.translate(x, y, z);
+    transform.rotate(rotateX, 1.0f, 0.0f, 0.0f);
+    return transform;
+}
+
+void buildApple(MeshBuilder &builder, std::vector<FruitMeshLibrary::Part> &parts)
+{
+    builder.beginTexturedPart(parts, Fruit::APPLE);
+    builder.sphere(placed(0.0f, 0.0f, 0.0f, 90.0f), 0.3f, 32, 32);
+    builder.endPart();
+
+    builder.beginMaterialPart(parts, STEM_MATERIAL);
+    builder.cylinder(placed(0.0f, 0.3f, 0.0f, -90.0f), 0.02f, 0.015f, 0.15f, 16, 16);
+    builder.endPart();
+
+    builder.beginMaterialPart(parts, CALYX_MATERIAL);
+    builder.sphere(placed(0.0f, -0.28f, 0.0f), 0.05f, 16, 16);
+    builder.endPart();
+}
+
+void buildStrawberry(MeshBuilder &builder, std::vector<FruitMeshLibrary::Part> &parts)
+{
+    const float profile[][2] = {
+        {-0.25f, 0.0f}, // Bottom tip
+        {-0.1f, 0.25f}, // Middle widest part
+        {0.15f, 0.2f},  // Tapering towards top
+        {0.2f, 0.0f}    // Top tip
+    };
+
+    builder.beginTexturedPart(parts, Fruit::STRAWBERRY);
+    builder.lathe(QMatrix4x4(), profile, 4, 12);
+    builder.endPart();
+}
+
+void buildBanana(MeshBuilder &builder, std::vector<FruitMeshLibrary::Part> &parts)
+{
+    const int numSegments = 8;
+    const float bananaLength = 0.8f;
+    const float maxRadius = 0.07f;
+    const float curvature = 0.2f;
+
+    builder.beginTexturedPart(parts, Fruit::BANANA);
+    for (int i = 0; i < numSegments - 1; i++)
+    {
+        float t1 = (float)i / (numSegments - 1);
+        float t2 = (float)(i + 1) / (numSegments - 1);
+
+        // Curved path, thicker in the middle
+        float x1 = curvature * sin(t1 * M_PI);
+        float z1 = t1 * bananaLength;
+        float x2 = curvature * sin(t2 * M_PI);
+        float z2 = t2 * bananaLength;
+        float r1 = maxRadius * sin(t1 * M_PI * 0.8f + 0.1f * M_PI);
+        float r2 = maxRadius * sin(t2 * M_PI * 0.8f + 0.1f * M_PI);
+
+        float dx = x2 - x1;
+        float dz = z2 - z1;
+        float length = sqrt(dx * dx + dz * dz);
+
+        // Banana lies along y once rotated upright, then each segment is aligned with the curve
+        QMatrix4x4 segment;
+        segment.rotate(-90.0f, 1.0f, 0.0f, 0.0f);
+        segment.translate(x1, 0.0f, z1);
+        segment.rotate(atan2(dx, dz) * 180.0f / M_PI, 0.0f, 1.0f, 0.0f);
+
+        builder.cylinder(segment, r1, r2, length, 16, 1);
+        if (i == 0)
+        {
+            builder.disk(segment, r1, 16);
+        }
+        if (i == numSegments - 2)
+        {
+            QMatrix4x4 end = segment;
+            end.translate(0.0f, 0.0f, length);
+            builder.disk(end, r2, 16);
+        }
+    }
+    builder.endPart();
+}
+
+void buildPear(MeshBuilder &builder, std::vector<FruitMeshLibrary::Part> &parts)
+{
+    builder.beginTexturedPart(parts, Fruit::PEAR);
+    // Main body, then the narrower and taller neck
+    builder.sphere(placed(0.0f, -0.05f, 0.0f, 90.0f), 0.22f, 32, 32);
+    QMatrix4x4 neck;
+    neck.translate(0.0f, 0.18f, 0.0f);
+    neck.scale(0.75f, 1.3f, 0.75f);
+    neck.rotate(90.0f, 1.0f, 0.0f, 0.0f);
+    builder.sphere(neck, 0.15f, 32, 32);
+    builder.endPart();
+
+    builder.beginMaterialPart(parts, STEM_MATERIAL);
+    builder.cylinder(placed(0.0f, 0.37f, 0.0f, -90.0f), 0.02f, 0.015f, 0.12f, 16, 16);
+    builder.endPart();
+
+    builder.beginMaterialPart(parts, CALYX_MATERIAL);
+    builder.sphere(placed(0.0f, -0.27f, 0.0f), 0.05f, 16, 16);
+    builder.endPart();
+}
+
+void buildBomb(MeshBuilder &builder, std::vector<FruitMeshLibrary::Part> &parts)
+{
+    builder.beginTexturedPart(parts, Fruit::BOMB);
+    builder.sphere(placed(0.0f, 0.0f, 0.0f, 90.0f), 0.3f, 32, 32);
+    builder.endPart();
+
+    builder.beginMaterialPart(parts, FUSE_MATERIAL);
+    builder.cylinder(placed(0.0f, 0.3f, 0.0f, -90.0f), 0.02f, 0.02f, 0.2f, 16, 16);
+    builder.endPart();
+}
+
+MeshVertex interpolate(const MeshVertex &a, const MeshVertex &b, float t)
+{
+    MeshVertex vertex;
+    QVector3D normal;
+    for (int i = 0; i < 3; ++i)
+    {
+        vertex.position[i] = a.position[i] + (b.position[i] - a.position[i]) * t;
+        normal[i] = a.normal[i] + (b.normal[i] - a.normal[i]) * t;
+    }
+    normal.normalize();
+    vertex.normal[0] = normal.x();
+    vertex.normal[1] = normal.y();
+    vertex.normal[2] = normal.z();
+    vertex.texCoord[0] = a.texCoord[0] + (b.texCoord[0] - a.texCoord[0]) * t;
+    vertex.texCoord[1] = a.texCoord[1] + (b.texCoord[1] - a.texCoord[1]) * t;
+    return vertex;
+}
+
+// Splits a part's triangles along a plane, and collects the cross-section outline of the kept side
+class PartSlicer
+{
+public:
+    PartSlicer(const QVector3D &normal, float distance, float side) : normal(normal), distance(distance), side(side) {}
+
+    // Appends the triangles of [first, first + count) on the kept side, in their original winding
+    void clip(const std::vector<MeshVertex> &source, GLint first, GLsizei count, std::vector<MeshVertex> &output)
+    {
+        outline.clear();
+        for (GLint v = first; v + 2 < first + count; v += 3)
+        {
+            const MeshVertex *triangle = &source[v];
+            float distances[3];
+            for (int i = 0; i < 3; ++i)
+            {
+                distances[i] = side * (normal.x() * triangle[i].position[0] + normal.y() * triangle[i].position[1] +
+                                       normal.z() * triangle[i].position[2] + distance);
+            }
+
+            // Sutherland-Hodgman against a single plane: 0, 3 or 4 vertices
+            MeshVertex polygon[4];
+            int polygonSize = 0;
+            int crossings = 0;
+            for (int i = 0; i < 3; ++i)
+            {
+                const int j = (i + 1) % 3;
+                if (distances[i] >= 0.0f)
+                {
+                    polygon[polygonSize++] = triangle[i];
+                }
+                if ((distances[i] >= 0.0f) != (distances[j] >= 0.0f))
+                {
+                    polygon[polygonSize] = interpolate(triangle[i], triangle[j], distances[i] / (distances[i] - distances[j]));
+                    outline.push_back(QVector3D(polygon[polygonSize].position[0], polygon[polygonSize].position[1], polygon[polygonSize].position[2]));
+                    ++polygonSize;
+                    ++crossings;
+                }
+            }
+            if (crossings == 1)
+            {
+                outline.pop_back();
+            }
+            for (int i = 1; i + 1 < polygonSize; ++i)
+            {
+                output.push_back(polygon[0]);
+                output.push_back(polygon[i]);
+                output.push_back(polygon[i + 1]);
+            }
+        }
+    }
+
+    // Closes the kept side: the outline segments are chained into closed loops (a curved part such as the banana
+    // can be cut into several), and each loop is triangulated by ear clipping, facing out of the half
+    void cap(std::vector<MeshVertex> &output) const
+    {
+        const QVector3D capNormal = -side * normal;
+        QVector3D axisU = QVector3D::crossProduct(capNormal, std::fabs(capNormal.x()) < 0.9f ? QVector3D(1, 0, 0) : QVector3D(0, 1, 0)).normalized();
+        QVector3D axisV = QVector3D::crossProduct(capNormal, axisU);
+
+        for (std::vector<QVector3D> &loop : loops())
+        {
+            // Counter-clockwise around the cap normal, so every ear keeps the front-facing winding
+            std::vector<QPointF> points;
+            double area = 0.0;
+            for (const QVector3D &point : loop)
+            {
+                points.emplace_back(QVector3D::dotProduct(point, axisU), QVector3D::dotProduct(point, axisV));
+            }
+            for (size_t i = 0; i < points.size(); ++i)
+            {
+                const QPointF &a = points[i];
+                const QPointF &b = points[(i + 1) % points.size()];
+                area += a.x() * b.y() - b.x() * a.y();
+            }
+            if (area < 0.0)
+            {
+                std::reverse(loop.begin(), loop.end());
+                std::reverse(points.begin(), points.end());
+            }
+
+            auto addTriangle = [&](int a, int b, int c) {
+                for (int index : {a, b, c})
+                {
+                    const QVector3D &point = loop[index];
+                    output.push_back(MeshVertex{{point.x(), point.y(), point.z()}, {capNormal.x(), capNormal.y(), capNormal.z()}, {0.0f, 0.0f}});
+                }
+            };
+
+            std::vector<int> remaining(loop.size());
+            for (size_t i = 0; i < remaining.size(); ++i)
+            {
+                remaining[i] = static_cast<int>(i);
+            }
+            while (remaining.size() > 3)
+            {
+                const size_t count = remaining.size();
+                size_t ear = count;
+                for (size_t i = 0; i < count && ear == count; ++i)
+                {
+                    const int a = remaining[(i + count - 1) % count];
+                    const int b = remaining[i];
+                    const int c = remaining[(i + 1) % count];
+                    if (cross(points[a], points[b], points[c]) <= 0.0)
+                    {
+                        continue; // Reflex or flat corner
+                    }
+                    bool empty = true;
+                    for (int other : remaining)
+                    {
+                        if (other != a && other != b && other != c && inTriangle(points[other], points[a], points[b], points[c]))
+                        {
+                            empty = false;
+                            break;
+                        }
+                    }
+                    if (empty)
+                    {
+                        ear = i;
+                    }
+                }
+                if (ear == count)
+                {
+                    break; // Degenerate outline: the rest is fanned below
+                }
+                addTriangle(remaining[(ear + count - 1) % count], remaining[ear], remaining[(ear + 1) % count]);
+                remaining.erase(remaining.begin() + ear);
+            }
+            for (size_t i = 1; i + 1 < remaining.size(); ++i)
+            {
+                addTriangle(remaining[0], remaining[i], remaining[i + 1]);
+            }
+        }
+    }
+
+private:
+    QVector3D normal;
+    float distance;
+    float side;
+    std::vector<QVector3D> outline; // Segment end points, two by two
+
+    // Chains the outline segments end to end; an open chain (a hole in the mesh) is closed on itself
+    std::vector<std::vector<QVector3D>> loops() const
+    {
+        std::vector<std::vector<QVector3D>> result;
+        std::vector<bool> used(outline.size() / 2, false);
+        for (size_t start = 0; start < used.size(); ++start)
+        {
+            if (used[start])
+            {
+                continue;
+            }
+            used[start] = true;
+            std::vector<QVector3D> loop = {outline[2 * start], outline[2 * start + 1]};
+            bool extended = true;
+            while (extended && !samePoint(loop.back(), loop.front()))
+            {
+                extended = false;
+                for (size_t segment = start + 1; segment < used.size(); ++segment)
+                {
+                    if (used[segment])
+                    {
+                        continue;
+                    }
+                    // Neighbouring triangles interpolate the shared edge from either end
+                    for (int end = 0; end < 2; ++end)
+                    {
+                        if (samePoint(outline[2 * segment + end], loop.back()))
+                        {
+                            loop.push_back(outline[2 * segment + 1 - end]);
+                            used[segment] = true;
+                            extended = true;
+                            break;
+                        }
+                    }
+                    if (extended)
+                    {
+                        break;
+                    }
+                }
+            }
+            if (samePoint(loop.back(), loop.front()))
+            {
+                loop.pop_back();
+            }
+            if (loop.size() >= 3)
+            {
+                result.push_back(std::move(loop));
+            }
+        }
+        return result;
+    }
+
+    static bool samePoint(const QVector3D &a, const QVector3D &b)
+    {
+        return (a - b).lengthSquared() < OUTLINE_WELD_DISTANCE * OUTLINE_WELD_DISTANCE;
+    }
+
+    // Twice the signed area of the triangle abc
+    static double cross(const QPointF &a, const QPointF &b, const QPointF &c)
+    {
+        return (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x());
+    }
+
+    static bool inTriangle(const QPointF &p, const QPointF &a, const QPointF &b, const QPointF &c)
+    {
+        return cross(a, b, p) >= 0.0 && cross(b, c, p) >= 0.0 && cross(c, a, p) >= 0.0;
+    }
+};
+
+void uploadSlice(FruitSlice &slice)
+{
+    if (slice.buffer.isCreated() || !slice.buffer.create())
+    {
+        return;
+    }
+    slice.buffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    slice.buffer.bind();
+    slice.buffer.allocate(slice.vertices.data(), static_cast<int>(slice.vertices.size() * sizeof(MeshVertex)));
+    slice.buffer.release();
+    std::vector<MeshVertex>().swap(slice.vertices);
+}
+
+void setVertexPointers()
+{
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(MeshVertex), reinterpret_cast<const void *>(offsetof(MeshVertex, position)));
+    glNormalPointer(GL_FLOAT, sizeof(MeshVertex), reinterpret_cast<const void *>(offsetof(MeshVertex, normal)));
+    glTexCoordPointer(2, GL_FLOAT, sizeof(MeshVertex), reinterpret_cast<const void *>(offsetof(MeshVertex, texCoord)));
+}
+
+void setAttributeBuffers(QOpenGLShaderProgram &program, int positionLocation, int normalLocation, int texCoordLocation)
+{
+    program.enableAttributeArray(positionLocation);
+    program.enableAttributeArray(normalLocation);
+    program.enableAttributeArray(texCoordLocation);
+    program.setAttributeBuffer(positionLocation, GL_FLOAT, offsetof(MeshVertex, position), 3, sizeof(MeshVertex));
+    program.setAttributeBuffer(normalLocation, GL_FLOAT, offsetof(MeshVertex, normal), 3, sizeof(MeshVertex));
+    program.setAttributeBuffer(texCoordLocation, GL_FLOAT, offsetof(MeshVertex, texCoord), 2, sizeof(MeshVertex));
+}
+
+} // namespace
+
+bool FruitMeshLibrary::create(const QRectF *textureRegions)
+{
+    // Part ranges are cheap to rebuild; the upload only happens once per context group.
+    // The vertices are kept on the CPU to slice cut fruits.
+    // Every level of detail of every type shares the one buffer.
+    vertices.clear();
+    for (int level = 0; level < LEVEL_COUNT; ++level)
+    {
+        MeshBuilder builder(vertices, LEVEL_DETAIL[level]);
+        for (std::vector<Part> &parts : typeParts)
+        {
+            parts[level].clear();
+        }
+        buildApple(builder, typeParts[Fruit::APPLE][level]);
+        buildStrawberry(builder, typeParts[Fruit::STRAWBERRY][level]);
+        buildBanana(builder, typeParts[Fruit::BANANA][level]);
+        buildPear(builder, typeParts[Fruit::PEAR][level]);
+        buildBomb(builder, typeParts[Fruit::BOMB][level]);
+    }
+
+    // Textured parts sample their region of the atlas; slicing interpolates the remapped coordinates as well
+    for (const auto &levels : typeParts)
+    {
+        for (const std::vector<Part> &parts : levels)
+        {
+            for (const Part &part : parts)
+            {
+                if (part.textureIndex < 0)
+                {
+                    continue;
+                }
+                const QRectF &region = textureRegions[part.textureIndex];
+                for (GLint v = part.first; v < part.first + part.count; ++v)
+                {
+                    vertices[v].texCoord[0] = region.x() + vertices[v].texCoord[0] * region.width();
+                    vertices[v].texCoord[1] = region.y() + vertices[v].texCoord[1] * region.height();
+                }
+            }
+        }
+    }
+
+    // Bounding spheres around the mesh origin, from the full meshes
+    for (int type = 0; type < TYPE_COUNT; ++type)
+    {
+        float radius = 0.0f;
+        for (const Part &part : typeParts[type][0])
+        {
+            for (GLint v = part.first; v < part.first + part.count; ++v)
+            {
+                radius = std::max(radius, QVector3D(vertices[v].position[0], vertices[v].position[1], vertices[v].position[2]).length());
+            }
+        }
+        boundingRadii[type] = radius;
+    }
+
+    bool created = false;
+    vertexBuffer = GLResourceRegistry::current().buffer("fruit.meshes", &created);
+    if (!vertexBuffer)
+    {
+        return false;
+    }
+    totalVertices = static_cast<int>(vertices.size());
+    if (created)
+    {
+        vertexBuffer->setUsagePattern(QOpenGLBuffer::StaticDraw);
+        vertexBuffer->bind();
+        vertexBuffer->allocate(vertices.data(), static_cast<int>(vertices.size() * sizeof(MeshVertex)));
+        vertexBuffer->release();
+        qDebug() << "Fruit meshes uploaded:" << totalVertices << "vertices in" << LEVEL_COUNT << "levels of detail";
+    }
+    return true;
+}
+
+void FruitMeshLibrary::bind()
+{
+    vertexBuffer->bind();
+    setVertexPointers();
+}
+
+void FruitMeshLibrary::bind(FruitSlice &slice)
+{
+    uploadSlice(slice);
+    slice.buffer.bind();
+    setVertexPointers();
+}
+
+void FruitMeshLibrary::release()
+{
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    QOpenGLBuffer::release(QOpenGLBuffer::VertexBuffer);
+}
+
+void FruitMeshLibrary::bindAttributes(QOpenGLShaderProgram &program, int positionLocation, int normalLocation, int texCoordLocation)
+{
+    vertexBuffer->bind();
+    setAttributeBuffers(program, positionLocation, normalLocation, texCoordLocation);
+}
+
+void FruitMeshLibrary::bindAttributes(FruitSlice &slice, QOpenGLShaderProgram &program, int positionLocation, int normalLocation, int texCoordLocation)
+{
+    uploadSlice(slice);
+    slice.buffer.bind();
+    setAttributeBuffers(program, positionLocation, normalLocation, texCoordLocation);
+}
+
+void FruitMeshLibrary::releaseAttributes(QOpenGLShaderProgram &program, int positionLocation, int normalLocation, int texCoordLocation)
+{
+    program.disableAttributeArray(texCoordLocation);
+    program.disableAttributeArray(normalLocation);
+    program.disableAttributeArray(positionLocation);
+    QOpenGLBuffer::release(QOpenGLBuffer::VertexBuffer);
+}
+
+std::shared_ptr<FruitSlice> FruitMeshLibrary::slice(Fruit::FruitType type, const QVector4D &plane)
+{
+    QVector3D normal = plane.toVector3D();
+    const float length = normal.length();
+    float distance = 0.0f;
+    if (length > 0.0f)
+    {
+        normal /= length;
+        distance = plane.w() / length;
+    }
+    else
+    {
+        normal = QVector3D(0.0f, 1.0f, 0.0f);
+    }
+
+    // Same rounded plane and type, same halves
+    const int nx = qRound(normal.x() * SLICE_NORMAL_STEPS);
+    const int ny = qRound(normal.y() * SLICE_NORMAL_STEPS);
+    const int nz = qRound(normal.z() * SLICE_NORMAL_STEPS);
+    const int d = std::clamp(qRound(distance * SLICE_DISTANCE_STEPS), -32768, 32767);
+    const quint64 key = (static_cast<quint64>(type) << 48) | (static_cast<quint64>(static_cast<quint8>(nx)) << 40) |
+                        (static_cast<quint64>(static_cast<quint8>(ny)) << 32) | (static_cast<quint64>(static_cast<quint8>(nz)) << 24) |
+                        static_cast<quint64>(static_cast<quint16>(d));
+    std::shared_ptr<FruitSlice> &cached = slices[key];
+    if (cached)
+    {
+        return cached;
+    }
+
+    cached = std::make_shared<FruitSlice>();
+    const QVector3D roundedNormal = QVector3D(nx, ny, nz).normalized();
+    const float roundedDistance = d / SLICE_DISTANCE_STEPS;
+    for (int side = 0; side < 2; ++side)
+    {
+        PartSlicer slicer(roundedNormal, roundedDistance, side == 0 ? 1.0f : -1.0f);
+        std::vector<Part> &half = cached->halves[side];
+        std::vector<Part> caps;
+        for (const Part &part : typeParts[type][0])
+        {
+            Part kept = part;
+            kept.first = static_cast<GLint>(cached->vertices.size());
+            slicer.clip(vertices, part.first, part.count, cached->vertices);
+            kept.count = static_cast<GLsizei>(cached->vertices.size()) - kept.first;
+            if (kept.count > 0)
+            {
+                half.push_back(kept);
+            }
+
+            // Textured skins show the flesh of the fruit, stems and fuses their own material
+            Part cap = part.textureIndex >= 0 ? materialPart(FLESH_MATERIALS[type]) : part;
+            cap.textureIndex = -1;
+            cap.first = static_cast<GLint>(cached->vertices.size());
+            slicer.cap(cached->vertices);
+            cap.count = static_cast<GLsizei>(cached->vertices.size()) - cap.first;
+            if (cap.count > 0)
+            {
+                caps.push_back(cap);
+            }
+        }
+        half.insert(half.end(), caps.begin(), caps.end());
+    }
+    BIBLIO_LOG(Fruits, "Fruit sliced: type %d, %zu vertices, %d cached", static_cast<int>(type), cached->vertices.size(), static_cast<int>(slices.size()));
+    return cached;
+}
+
+void FruitMeshLibrary::releaseUnusedSlices()
+{
+    for (auto it = slices.begin(); it != slices.end() && slices.size() > SLICE_CACHE_SIZE;)
+    {
+        if (it.value().use_count() == 1)
+        {
+            it.value()->buffer.destroy();
+            it = slices.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void FruitMeshLibrary::destroySlices()
+{
+    for (const std::shared_ptr<FruitSlice> &slice : std::as_const(slices))
+    {
+        slice->buffer.destroy();
+    }
+    slices.clear();
+}
+
+int FruitMeshLibrary::levelFor(float projectedRadius)
+{
+    int level = 0;
+    while (level < LEVEL_COUNT - 1 && projectedRadius < LEVEL_MIN_RADIUS[level])
+    {
+        ++level;
+    }
+    return level;
+}
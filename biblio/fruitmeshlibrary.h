@@ -0,0 +1,197 @@
+/**
+ * @file fruitmeshlibrary.h
+ * @brief Déclaration de la classe FruitMeshLibrary.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef FRUITMESHLIBRARY_H
+#define FRUITMESHLIBRARY_H
+
+#include <qopengl.h>
+#include <QOpenGLBuffer>
+#include <QOpenGLShaderProgram>
+#include <QHash>
+#include <QRectF>
+#include <QVector4D>
+#include <memory>
+#include <vector>
+#include "fruit.h"
+
+struct FruitSlice;
+
+/**
+ * @class FruitMeshLibrary
+ * @brief Maillages des fruits et de la bombe, construits une fois dans un tampon de sommets (VBO).
+ *
+ * Chaque type de fruit est décrit par une liste de parties (corps texturé, tige, calice, mèche...)
+ * dont la géométrie (positions, normales, coordonnées de texture) est calculée une seule fois
+ * à l'initialisation OpenGL, au lieu d'être retessellée par GLU à chaque image.
+ * Les sphères, cylindres et disques reprennent exactement la paramétrisation de GLU, de sorte
+ * que les textures restent alignées comme avant. Le tampon appartient au GLResourceRegistry du
+ * contexte : il n'est envoyé qu'une fois pour toutes les parties.
+ *
+ * Chaque type est construit à LEVEL_COUNT niveaux de détail, du maillage complet (niveau 0) au
+ * plus grossier ; levelFor() choisit le niveau d'après la taille du fruit à l'écran.
+ */
+class FruitMeshLibrary
+{
+public:
+    static constexpr int LEVEL_COUNT = 4; ///< Nombre de niveaux de détail par type de fruit.
+
+    /**
+     * @struct Part
+     * @brief Partie d'un fruit dessinée avec un même état (texture ou matériau).
+     */
+    struct Part
+    {
+        GLint first = 0;            ///< Premier sommet de la partie dans le tampon.
+        GLsizei count = 0;          ///< Nombre de sommets (triangles).
+        int textureIndex = -1;      ///< Indice de la texture dans le tableau des textures du jeu, -1 pour un matériau.
+        GLfloat ambient[4] = {};    ///< Composante ambiante du matériau (partie non texturée).
+        GLfloat diffuse[4] = {};    ///< Composante diffuse du matériau, utilisée aussi comme couleur.
+        GLfloat specular[4] = {};   ///< Composante spéculaire du matériau.
+        GLfloat shininess = 0.0f;   ///< Exposant de brillance spéculaire.
+    };
+
+    /**
+     * @struct Vertex
+     * @brief Sommet entrelacé des tampons de maillages.
+     */
+    struct Vertex
+    {
+        GLfloat position[3];    ///< Position dans l'espace du fruit.
+        GLfloat normal[3];      ///< Normale unitaire.
+        GLfloat texCoord[2];    ///< Coordonnées de texture.
+    };
+
+    /**
+     * @brief Construit les maillages de tous les types de fruits et les envoie au GPU s'ils n'y sont pas déjà.
+     * @param textureRegions Région de chaque texture du jeu dans sa texture OpenGL (atlas), indexée comme Part::textureIndex :
+     * les coordonnées de texture des parties texturées y sont ramenées.
+     * @return true si le tampon de sommets est disponible. Nécessite un contexte OpenGL courant.
+     */
+    bool create(const QRectF *textureRegions);
+
+    /**
+     * @brief Indique si les maillages ont été envoyés au GPU.
+     */
+    bool isCreated() const { return vertexBuffer != nullptr; }
+
+    /**
+     * @brief Active le tampon et les tableaux de sommets, normales et coordonnées de texture.
+     */
+    void bind();
+
+    /**
+     * @brief Active le tampon d'un fruit coupé, envoyé au GPU à sa première utilisation.
+     * @param slice Moitiés retournées par slice().
+     */
+    void bind(FruitSlice &slice);
+
+    /**
+     * @brief Désactive les tableaux de sommets activés par bind().
+     */
+    void release();
+
+    /**
+     * @brief Active le tampon comme attributs de sommets d'un programme de shaders (pipeline programmable).
+     * @param program Programme lié.
+     * @param positionLocation Emplacement de l'attribut de position (vec3).
+     * @param normalLocation Emplacement de l'attribut de normale (vec3).
+     * @param texCoordLocation Emplacement de l'attribut de coordonnées de texture (vec2).
+     */
+    void bindAttributes(QOpenGLShaderProgram &program, int positionLocation, int normalLocation, int texCoordLocation);
+
+    /**
+     * @brief Active le tampon d'un fruit coupé comme attributs de sommets, comme bindAttributes().
+     * @param slice Moitiés retournées par slice().
+     */
+    void bindAttributes(FruitSlice &slice, QOpenGLShaderProgram &program, int positionLocation, int normalLocation, int texCoordLocation);
+
+    /**
+     * @brief Désactive les attributs activés par bindAttributes().
+     */
+    void releaseAttributes(QOpenGLShaderProgram &program, int positionLocation, int normalLocation, int texCoordLocation);
+
+    /**
+     * @brief Parties à dessiner pour un type de fruit, dans l'ordre.
+     * @param type Type de fruit.
+     * @param level Niveau de détail, de 0 (complet) à LEVEL_COUNT - 1.
+     * @return Liste des parties, chacune à dessiner avec glDrawArrays(GL_TRIANGLES, first, count).
+     */
+    const std::vector<Part> &parts(Fruit::FruitType type, int level = 0) const { return typeParts[type][level]; }
+
+    /**
+     * @brief Rayon de la sphère englobante d'un type de fruit, centrée sur l'origine de son maillage.
+     * @param type Type de fruit.
+     */
+    float boundingRadius(Fruit::FruitType type) const { return boundingRadii[type]; }
+
+    /**
+     * @brief Choisit le niveau de détail d'un fruit d'après sa taille à l'écran.
+     * @param projectedRadius Rayon du fruit à l'écran, en pixels physiques (ViewFrustum::projectedRadius()).
+     * @return Niveau de détail, 0 pour les fruits proches.
+     */
+    static int levelFor(float projectedRadius);
+
+    /**
+     * @brief Nombre total de sommets dans le tampon.
+     */
+    int vertexCount() const { return totalVertices; }
+
+    /**
+     * @brief Coupe le maillage d'un type de fruit en deux moitiés fermées par leur face de coupe.
+     *
+     * Le calcul est fait sur le CPU à partir du maillage complet, une seule fois par type et par plan : le plan est arrondi
+     * (normale au 1/32, distance au 1/200) et les moitiés déjà calculées pour ce plan sont réutilisées.
+     * Ne nécessite pas de contexte OpenGL ; le tampon des moitiés est envoyé au premier bind().
+     * @param type Type de fruit.
+     * @param plane Plan de coupe (A, B, C, D) dans l'espace du maillage ; la première moitié est du côté positif.
+     * @return Moitiés partagées avec le cache.
+     */
+    std::shared_ptr<FruitSlice> slice(Fruit::FruitType type, const QVector4D &plane);
+
+    /**
+     * @brief Libère les moitiés qu'aucun fruit n'utilise quand le cache dépasse sa taille. Nécessite le contexte OpenGL courant.
+     */
+    void releaseUnusedSlices();
+
+    /**
+     * @brief Libère toutes les moitiés du cache et leurs tampons. Nécessite le contexte OpenGL courant.
+     */
+    void destroySlices();
+
+    /**
+     * @brief Nombre de coupes dans le cache.
+     */
+    int sliceCount() const { return slices.size(); }
+
+private:
+    static constexpr int TYPE_COUNT = Fruit::BOMB + 1; ///< Nombre de types de fruits (bombe comprise).
+
+    QOpenGLBuffer *vertexBuffer = nullptr;      ///< Sommets de tous les maillages (possédé par GLResourceRegistry).
+    std::vector<Part> typeParts[TYPE_COUNT][LEVEL_COUNT]; ///< Parties de chaque type de fruit, par niveau de détail.
+    float boundingRadii[TYPE_COUNT] = {};       ///< Rayon englobant de chaque type.
+    std::vector<Vertex> vertices;               ///< Copie CPU des sommets, pour couper les maillages.
+    int totalVertices = 0;                      ///< Nombre de sommets dans le tampon.
+    QHash<quint64, std::shared_ptr<FruitSlice>> slices; ///< Coupes par type et plan arrondi.
+};
+
+/**
+ * @struct FruitSlice
+ * @brief Les deux moitiés d'un fruit coupé, avec leur face de coupe, dans un tampon de sommets à part.
+ */
+struct FruitSlice
+{
+    std::vector<FruitMeshLibrary::Vertex> vertices; ///< Sommets des deux moitiés, libérés une fois envoyés au GPU.
+    std::vector<FruitMeshLibrary::Part> halves[2];  ///< Parties de la moitié positive (0) et négative (1), faces de coupe comprises.
+    QOpenGLBuffer buffer;                           ///< Tampon des sommets, créé au premier FruitMeshLibrary::bind().
+
+    /**
+     * @brief Parties d'une moitié.
+     * @param side 1 pour la moitié du côté positif du plan, -1 pour l'autre (comme firstPart dans Fruit).
+     */
+    const std::vector<FruitMeshLibrary::Part> &half(float side) const { return halves[side > 0.0f ? 0 : 1]; }
+};
+
+#endif // FRUITMESHLIBRARY_H
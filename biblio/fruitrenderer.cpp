@@ -0,0 +1,275 @@
+#include "fruitrenderer.h"
+#include "launchoptions.h"
+#include <QDebug>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <algorithm>
+
+// Constants
+const int POSITION_LOCATION = 0;
+const int NORMAL_LOCATION = 1;
+const int TEXCOORD_LOCATION = 2;
+const int MODEL_LOCATION = 3; // Four consecutive vec4 columns
+
+static const char *const VERTEX_SHADER = R"(
+#version 330
+in vec3 position;
+in vec3 normal;
+in vec2 texCoord;
+in vec4 modelColumn0;
+in vec4 modelColumn1;
+in vec4 modelColumn2;
+in vec4 modelColumn3;
+
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+out vec3 eyePosition;
+out vec3 eyeNormal;
+out vec2 uv;
+
+void main()
+{
+    mat4 model = mat4(modelColumn0, modelColumn1, modelColumn2, modelColumn3);
+    vec4 worldPosition = model * vec4(position, 1.0);
+    vec4 eye = viewMatrix * worldPosition;
+    eyePosition = eye.xyz;
+    // Fruit and view transforms are rigid, no inverse transpose needed
+    eyeNormal = mat3(viewMatrix) * mat3(model) * normal;
+    uv = texCoord;
+    gl_Position = projectionMatrix * eye;
+}
+)";
+
+static const char *const FRAGMENT_SHADER = R"(
+#version 330
+in vec3 eyePosition;
+in vec3 eyeNormal;
+in vec2 uv;
+
+uniform sampler2D diffuseTexture;
+uniform bool textured;
+uniform vec4 diffuseColor;
+uniform vec4 specularColor;
+uniform float shininess;
+uniform vec3 lightPosition;
+
+out vec4 fragColor;
+
+// Global ambient (0.2) plus GL_LIGHT0 ambient (0.2), see GameWidget::initializeGL
+const float AMBIENT = 0.4;
+
+void main()
+{
+    vec3 n = normalize(eyeNormal);
+    vec3 l = normalize(lightPosition - eyePosition);
+    vec3 h = normalize(l + normalize(-eyePosition));
+    float diffuse = max(dot(n, l), 0.0);
+    float specular = diffuse > 0.0 ? pow(max(dot(n, h), 0.0), shininess) : 0.0;
+
+    // GL_COLOR_MATERIAL: ambient and diffuse follow the color, white under textures (GL_MODULATE)
+    vec4 base = textured ? texture(diffuseTexture, uv) : diffuseColor;
+    fragColor = vec4(base.rgb * min(AMBIENT + diffuse, 1.0) + specularColor.rgb * specular, base.a);
+}
+)";
+
+bool FruitRenderer::initialize()
+{
+    if (program)
+    {
+        return true;
+    }
+    if (LaunchOptions::get().renderer == "fixed")
+    {
+        return false;
+    }
+
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context || context->isOpenGLES() || context->format().version() < qMakePair(3, 3))
+    {
+        qDebug() << "Instanced fruit rendering needs OpenGL 3.3, using the fixed pipeline";
+        return false;
+    }
+
+    auto shaders = std::make_unique<QOpenGLShaderProgram>();
+    shaders->addShaderFromSourceCode(QOpenGLShader::Vertex, VERTEX_SHADER);
+    shaders->addShaderFromSourceCode(QOpenGLShader::Fragment, FRAGMENT_SHADER);
+    shaders->bindAttributeLocation("position", POSITION_LOCATION);
+    shaders->bindAttributeLocation("normal", NORMAL_LOCATION);
+    shaders->bindAttributeLocation("texCoord", TEXCOORD_LOCATION);
+    for (int column = 0; column < 4; ++column)
+    {
+        shaders->bindAttributeLocation(QByteArray("modelColumn") + QByteArray::number(column), MODEL_LOCATION + column);
+    }
+    if (!shaders->link())
+    {
+        qDebug() << "Could not build the fruit shaders, using the fixed pipeline:" << shaders->log();
+        return false;
+    }
+    if (!instanceBuffer.create())
+    {
+        qDebug() << "Could not create the fruit instance buffer, using the fixed pipeline";
+        return false;
+    }
+    instanceBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+
+    program = std::move(shaders);
+    qDebug() << "Instanced fruit rendering enabled";
+    return true;
+}
+
+void FruitRenderer::destroy()
+{
+    program.reset();
+    instanceBuffer.destroy();
+}
+
+void FruitRenderer::setPartUniforms(const FruitMeshLibrary::Part &part, const GLuint *textures)
+{
+    const bool textured = part.textureIndex >= 0;
+    program->setUniformValue("textured", textured);
+    if (textured)
+    {
+        // Fruit textures share the atlas: bind it once per frame
+        if (textures[part.textureIndex] != boundTexture)
+        {
+            boundTexture = textures[part.textureIndex];
+            glBindTexture(GL_TEXTURE_2D, boundTexture);
+        }
+        program->setUniformValue("specularColor", QVector4D());
+        program->setUniformValue("shininess", 1.0f);
+    }
+    else
+    {
+        program->setUniformValue("diffuseColor", QVector4D(part.diffuse[0], part.diffuse[1], part.diffuse[2], part.diffuse[3]));
+        program->setUniformValue("specularColor", QVector4D(part.specular[0], part.specular[1], part.specular[2], part.specular[3]));
+        program->setUniformValue("shininess", part.shininess);
+    }
+}
+
+void FruitRenderer::draw(const std::vector<Fruit *> &fruits, QTime currentTime, FruitMeshLibrary &meshes, const GLuint *textures)
+{
+    drawCalls = 0;
+    boundTexture = 0;
+    if (fruits.empty())
+    {
+        return;
+    }
+
+    // Gather whole fruits grouped by type and level of detail (counting sort); cut fruits have their own halves
+    int groupFirst[GROUP_COUNT] = {};
+    int groupCount[GROUP_COUNT] = {};
+    for (Fruit *fruit : fruits)
+    {
+        if (!fruit->isCut())
+        {
+            ++groupCount[fruit->getType() * FruitMeshLibrary::LEVEL_COUNT + fruit->getDetailLevel()];
+        }
+    }
+    int total = 0;
+    for (int group = 0; group < GROUP_COUNT; ++group)
+    {
+        groupFirst[group] = total;
+        total += groupCount[group];
+    }
+    instances.resize(total);
+    int groupNext[GROUP_COUNT];
+    std::copy(groupFirst, groupFirst + GROUP_COUNT, groupNext);
+    for (Fruit *fruit : fruits)
+    {
+        if (!fruit->isCut())
+        {
+            const QMatrix4x4 model = fruit->getModelMatrix(currentTime);
+            Instance &instance = instances[groupNext[fruit->getType() * FruitMeshLibrary::LEVEL_COUNT + fruit->getDetailLevel()]++];
+            std::copy(model.constData(), model.constData() + 16, instance.model);
+        }
+    }
+
+    // Same view, projection and light as the fixed-function scene around it
+    GLfloat view[16];
+    GLfloat projection[16];
+    GLfloat lightPosition[4];
+    glGetFloatv(GL_MODELVIEW_MATRIX, view);
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+    glGetLightfv(GL_LIGHT0, GL_POSITION, lightPosition);
+
+    QOpenGLExtraFunctions *gl = QOpenGLContext::currentContext()->extraFunctions();
+    program->bind();
+    program->setUniformValue("viewMatrix", QMatrix4x4(view).transposed());
+    program->setUniformValue("projectionMatrix", QMatrix4x4(projection).transposed());
+    program->setUniformValue("lightPosition", QVector3D(lightPosition[0], lightPosition[1], lightPosition[2]));
+    program->setUniformValue("diffuseTexture", 0);
+
+    if (!instances.empty())
+    {
+        instanceBuffer.bind();
+        instanceBuffer.allocate(instances.data(), static_cast<int>(instances.size() * sizeof(Instance)));
+
+        meshes.bindAttributes(*program, POSITION_LOCATION, NORMAL_LOCATION, TEXCOORD_LOCATION);
+        instanceBuffer.bind();
+        for (int column = 0; column < 4; ++column)
+        {
+            program->enableAttributeArray(MODEL_LOCATION + column);
+            gl->glVertexAttribDivisor(MODEL_LOCATION + column, 1);
+        }
+
+        for (int group = 0; group < GROUP_COUNT; ++group)
+        {
+            if (groupCount[group] == 0)
+            {
+                continue;
+            }
+
+            // Instance attributes start at this group's first instance
+            const int base = groupFirst[group] * static_cast<int>(sizeof(Instance));
+            for (int column = 0; column < 4; ++column)
+            {
+                program->setAttributeBuffer(MODEL_LOCATION + column, GL_FLOAT, base + column * 4 * sizeof(GLfloat), 4, sizeof(Instance));
+            }
+
+            const Fruit::FruitType type = static_cast<Fruit::FruitType>(group / FruitMeshLibrary::LEVEL_COUNT);
+            for (const FruitMeshLibrary::Part &part : meshes.parts(type, group % FruitMeshLibrary::LEVEL_COUNT))
+            {
+                setPartUniforms(part, textures);
+                gl->glDrawArraysInstanced(GL_TRIANGLES, part.first, part.count, groupCount[group]);
+                ++drawCalls;
+            }
+        }
+
+        for (int column = 0; column < 4; ++column)
+        {
+            gl->glVertexAttribDivisor(MODEL_LOCATION + column, 0);
+            program->disableAttributeArray(MODEL_LOCATION + column);
+        }
+        meshes.releaseAttributes(*program, POSITION_LOCATION, NORMAL_LOCATION, TEXCOORD_LOCATION);
+    }
+
+    // Cut fruits: each half is a plain draw, the model matrix is a constant attribute
+    for (Fruit *fruit : fruits)
+    {
+        FruitSlice *slice = fruit->getSlice(meshes);
+        if (!slice)
+        {
+            continue;
+        }
+        meshes.bindAttributes(*slice, *program, POSITION_LOCATION, NORMAL_LOCATION, TEXCOORD_LOCATION);
+        for (float side : {1.f, -1.f})
+        {
+            const QMatrix4x4 model = fruit->getModelMatrix(currentTime, side);
+            for (int column = 0; column < 4; ++column)
+            {
+                program->setAttributeValue(MODEL_LOCATION + column, model.column(column));
+            }
+            for (const FruitMeshLibrary::Part &part : slice->half(side))
+            {
+                setPartUniforms(part, textures);
+                glDrawArrays(GL_TRIANGLES, part.first, part.count);
+                ++drawCalls;
+            }
+        }
+        meshes.releaseAttributes(*program, POSITION_LOCATION, NORMAL_LOCATION, TEXCOORD_LOCATION);
+    }
+
+    program->release();
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
@@ -0,0 +1,94 @@
+/**
+ * @file fruitrenderer.h
+ * @brief Déclaration de la classe FruitRenderer.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef FRUITRENDERER_H
+#define FRUITRENDERER_H
+
+#include <qopengl.h>
+#include <QOpenGLBuffer>
+#include <QOpenGLShaderProgram>
+#include <QTime>
+#include <memory>
+#include <vector>
+#include "fruit.h"
+#include "fruitmeshlibrary.h"
+
+/**
+ * @class FruitRenderer
+ * @brief Dessin instancié des fruits avec des shaders : un appel de dessin par partie de chaque type de fruit et niveau de détail.
+ *
+ * La transformation de chaque fruit entier est rassemblée dans un tampon d'instances envoyé une
+ * fois par image ; tous les fruits d'un même type et niveau de détail sont ensuite dessinés par glDrawArraysInstanced.
+ * Le coût CPU d'une image ne dépend donc presque plus du nombre de fruits. Les fruits coupés,
+ * peu nombreux, sont dessinés moitié par moitié à partir de leur FruitSlice.
+ *
+ * Le renderer nécessite OpenGL 3.3 ; sinon (ou avec --renderer fixed), isAvailable() retourne
+ * false et le jeu garde le pipeline fixe de Fruit::submit(). L'éclairage reproduit celui du
+ * pipeline fixe (GL_LIGHT0, GL_COLOR_MATERIAL).
+ */
+class FruitRenderer
+{
+public:
+    FruitRenderer() = default;
+
+    /**
+     * @brief Compile les shaders et crée le tampon d'instances.
+     * @return true si le rendu instancié est disponible. Nécessite un contexte OpenGL courant.
+     */
+    bool initialize();
+
+    /**
+     * @brief Libère les shaders et le tampon d'instances. Nécessite le contexte OpenGL de initialize().
+     */
+    void destroy();
+
+    /**
+     * @brief Indique si le rendu instancié peut être utilisé.
+     */
+    bool isAvailable() const { return program != nullptr; }
+
+    /**
+     * @brief Dessine tous les fruits, avec les matrices de vue et de projection et la lumière courantes du pipeline fixe.
+     * @param fruits Fruits à dessiner, hors champ déjà écartés, avec leur niveau de détail choisi.
+     * @param currentTime Temps actuel.
+     * @param meshes Maillages des fruits.
+     * @param textures Tableau des textures du jeu (indexé par FruitMeshLibrary::Part::textureIndex).
+     */
+    void draw(const std::vector<Fruit *> &fruits, QTime currentTime, FruitMeshLibrary &meshes, const GLuint *textures);
+
+    /**
+     * @brief Nombre d'appels de dessin de la dernière image.
+     */
+    int lastDrawCalls() const { return drawCalls; }
+
+private:
+    /**
+     * @struct Instance
+     * @brief Données d'une instance de fruit dans le tampon d'instances.
+     */
+    struct Instance
+    {
+        GLfloat model[16];      ///< Matrice modèle (colonnes).
+    };
+
+    static constexpr int TYPE_COUNT = Fruit::BOMB + 1; ///< Nombre de types de fruits (bombe comprise).
+    static constexpr int GROUP_COUNT = TYPE_COUNT * FruitMeshLibrary::LEVEL_COUNT; ///< Groupes d'instances : un par type et niveau de détail.
+
+    std::unique_ptr<QOpenGLShaderProgram> program;             ///< Shaders du rendu instancié.
+    QOpenGLBuffer instanceBuffer{QOpenGLBuffer::VertexBuffer};  ///< Tampon d'instances, réécrit à chaque image.
+    std::vector<Instance> instances;                            ///< Instances de l'image, regroupées par type et niveau de détail.
+    int drawCalls = 0;                                          ///< Appels de dessin de la dernière image.
+    GLuint boundTexture = 0;                                    ///< Texture liée pendant draw(), pour ne pas la relier à chaque partie.
+
+    /**
+     * @brief Active la texture ou le matériau d'une partie de maillage.
+     * @param part Partie à dessiner.
+     * @param textures Tableau des textures du jeu.
+     */
+    void setPartUniforms(const FruitMeshLibrary::Part &part, const GLuint *textures);
+};
+
+#endif // FRUITRENDERER_H
@@ -0,0 +1,73 @@
+#include "gamegeometry.h"
+#include <cmath>
+#include <cstdlib>
+
+// Constants
+const float BLADE_TIP_OFFSET = 2.5f;    // Blade tip above the projected point
+const float BLADE_BASE_OFFSET = 0.8f;   // Blade base below the projected point
+const float BLADE_HEIGHT_MARGIN = 0.8f; // Extra vertical reach at both ends of the blade
+const float HITBOX_RADIUS = 2.0f;       // Horizontal reach of the blade
+const float MIN_FRUIT_HEIGHT = 0.1f;    // Fruits at floor level cannot be cut
+const float SLOWDOWN_FACTOR = 3.0f;     // Fruits move this many times slower than real time
+const float GRAVITY = 9.81f;
+const QVector3D LAUNCH_POSITION(0.0f, 1.0f, 30.0f); // Cannon mouth
+
+QVector3D GameGeometry::projectCameraPoint(const cv::Point &cameraPoint, const cv::Size &frameSize)
+{
+    // Map camera X coordinate to angle around cylinder (0 to π)
+    float angle = M_PI - ((float)cameraPoint.x / frameSize.width) * M_PI;
+
+    // Map camera Y coordinate to height on cylinder (0 to 4)
+    float cylinderHeight = 4.0f * (1.0f - (float)cameraPoint.y / frameSize.height);
+
+    return QVector3D(cos(angle), cylinderHeight, sin(angle));
+}
+
+bool GameGeometry::isKatanaHit(const QVector3D &katanaPosition, const QVector3D &fruitPosition)
+{
+    float bladeTipY = katanaPosition.y() + BLADE_TIP_OFFSET;
+    float bladeBaseY = katanaPosition.y() - BLADE_BASE_OFFSET;
+
+    // Horizontal distance between the fruit and the blade
+    float dx = katanaPosition.x() - fruitPosition.x();
+    float dz = katanaPosition.z() - fruitPosition.z();
+    float horizontalDist = std::sqrt(dx * dx + dz * dz);
+
+    bool isInBladeHeight = fruitPosition.y() >= (bladeBaseY - BLADE_HEIGHT_MARGIN)
+                           && fruitPosition.y() <= (bladeTipY + BLADE_HEIGHT_MARGIN);
+
+    return isInBladeHeight && horizontalDist < HITBOX_RADIUS && fruitPosition.y() > MIN_FRUIT_HEIGHT;
+}
+
+float GameGeometry::gameSeconds(double elapsedMs)
+{
+    return static_cast<float>(elapsedMs / 1000.0 / SLOWDOWN_FACTOR);
+}
+
+float GameGeometry::gravity()
+{
+    return GRAVITY;
+}
+
+QVector3D GameGeometry::fruitTrajectory(const QVector3D &initialPosition, const QVector3D &initialSpeed, int elapsedMs)
+{
+    float deltaT = gameSeconds(elapsedMs);
+
+    float x = initialSpeed.x() * deltaT + initialPosition.x();
+    float y = initialSpeed.y() * deltaT + initialPosition.y() - (0.5f * GRAVITY * deltaT * deltaT);
+    float z = initialSpeed.z() * deltaT + initialPosition.z();
+    return QVector3D(x, y, z);
+}
+
+QVector3D GameGeometry::launchPosition()
+{
+    return LAUNCH_POSITION;
+}
+
+QVector3D GameGeometry::randomLaunchSpeed()
+{
+    float x = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 2.f - 1.f;  // Random value between -1 and 1
+    float y = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 1.2f + 5.6f; // Random value between 5.6 and 6.8
+    float z = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 8.0f - 32.0f; // Random value between -32 and -24
+    return QVector3D(x, y, z);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file gamegeometry.h
+ * @brief Déclaration de la classe GameGeometry.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef GAMEGEOMETRY_H
+#define GAMEGEOMETRY_H
+
+#include <QVector3D>
+#include <opencv2/core/types.hpp>
+
+/**
+ * @class GameGeometry
+ * @brief Calculs de projection et de collision du jeu, sans état ni dépendance à OpenGL.
+ *
+ * Partagés par GameWidget, Fruit, la vérification de sessions enregistrées (SessionReplay)
+ * et le banc de mesure (biblio_bench), qui refont ainsi exactement les mêmes calculs hors
+ * de l'interface graphique.
+ */
+class GameGeometry
+{
+public:
+    /**
+     * @brief Projette un point de l'image caméra sur le cylindre entourant le joueur.
+     * L'abscisse donne l'angle autour du cylindre (0 à π), l'ordonnée la hauteur (0 à 4).
+     * @param cameraPoint Point dans l'image de la caméra.
+     * @param frameSize Dimensions de l'image de la caméra.
+     * @return Position 3D du katana dans l'espace de jeu.
+     */
+    static QVector3D projectCameraPoint(const cv::Point &cameraPoint, const cv::Size &frameSize);
+
+    /**
+     * @brief Teste si le katana, placé à une position donnée, touche un fruit.
+     * La lame couvre une hauteur allant de 1,6 sous le point projeté à 3,3 au-dessus,
+     * avec un rayon horizontal de 2.
+     * @param katanaPosition Position projetée du katana.
+     * @param fruitPosition Position du fruit.
+     * @return true si le fruit est touché.
+     */
+    static bool isKatanaHit(const QVector3D &katanaPosition, const QVector3D &fruitPosition);
+
+    /**
+     * @brief Convertit un temps écoulé en temps de jeu : les fruits et les particules évoluent trois fois plus lentement que le temps réel.
+     * @param elapsedMs Temps écoulé en millisecondes.
+     * @return Temps de jeu en secondes.
+     */
+    static float gameSeconds(double elapsedMs);
+
+    /**
+     * @brief Accélération de la pesanteur, en unités par seconde de jeu au carré.
+     */
+    static float gravity();
+
+    /**
+     * @brief Calcule la position d'un fruit sur sa trajectoire parabolique.
+     * @param initialPosition Position au lancement.
+     * @param initialSpeed Vitesse au lancement.
+     * @param elapsedMs Temps écoulé depuis le lancement, en millisecondes.
+     * @return Position du fruit.
+     */
+    static QVector3D fruitTrajectory(const QVector3D &initialPosition, const QVector3D &initialSpeed, int elapsedMs);
+
+    /**
+     * @brief Position de départ des fruits tirés par le canon.
+     */
+    static QVector3D launchPosition();
+
+    /**
+     * @brief Tire une vitesse de lancement aléatoire (rand()), vers le joueur.
+     * @return Vitesse initiale d'un fruit.
+     */
+    static QVector3D randomLaunchSpeed();
+};
+
+#endif // GAMEGEOMETRY_H
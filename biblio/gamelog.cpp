@@ -0,0 +1,186 @@
+#include "gamelog.h"
+#include <QByteArray>
+#include <QList>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <thread>
+
+// Constants
+const size_t RING_CAPACITY = 1024;                                  // Pending messages (power of two)
+const std::chrono::milliseconds WRITER_IDLE_WAIT(5);                // Writer sleep when the ring is empty
+const char *const CATEGORY_NAMES[GameLog::CategoryCount] = {"detection", "projection", "collision", "fruit", "frames"};
+
+namespace
+{
+
+// Bounded multi-producer ring (sequence-numbered slots): producers never lock, a single writer thread drains it
+class LogRing
+{
+public:
+    LogRing()
+    {
+        for (size_t i = 0; i < RING_CAPACITY; ++i)
+        {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enabledMask = parseEnabledCategories();
+        if (enabledMask != 0)
+        {
+            writer = std::thread(&LogRing::run, this);
+        }
+    }
+
+    ~LogRing()
+    {
+        if (!writer.joinable())
+        {
+            return;
+        }
+        stopping.store(true, std::memory_order_release);
+        writer.join();
+        if (dropped.load(std::memory_order_relaxed) > 0)
+        {
+            std::fprintf(stderr, "[log] %llu messages dropped\n", static_cast<unsigned long long>(dropped.load()));
+        }
+    }
+
+    bool isEnabled(GameLog::Category category) const { return (enabledMask & (1u << category)) != 0; }
+
+    void push(GameLog::Category category, const char *format, va_list arguments)
+    {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;)
+        {
+            slot = &slots[position & (RING_CAPACITY - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0)
+            {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                // Ring full: drop rather than wait for the writer
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            else
+            {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->category = category;
+        std::vsnprintf(slot->text, sizeof(slot->text), format, arguments);
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence{0};
+        GameLog::Category category = GameLog::Detection;
+        char text[GameLog::MAX_MESSAGE_LENGTH + 1];
+    };
+
+    std::array<Slot, RING_CAPACITY> slots;
+    std::atomic<size_t> enqueuePosition{0};
+    size_t dequeuePosition = 0; // Writer thread only
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> stopping{false};
+    uint32_t enabledMask = 0;
+    std::thread writer;
+
+    static uint32_t parseEnabledCategories()
+    {
+        uint32_t mask = 0;
+        const QList<QByteArray> names = qgetenv("BIBLIO_LOG").toLower().split(',');
+        for (const QByteArray &name : names)
+        {
+            const QByteArray trimmed = name.trimmed();
+            if (trimmed == "all")
+            {
+                return (1u << GameLog::CategoryCount) - 1;
+            }
+            for (int category = 0; category < GameLog::CategoryCount; ++category)
+            {
+                if (trimmed == CATEGORY_NAMES[category])
+                {
+                    mask |= 1u << category;
+                }
+            }
+        }
+        return mask;
+    }
+
+    // Writes every published message; returns false if the ring was empty
+    bool drain()
+    {
+        bool wroteAny = false;
+        for (;;)
+        {
+            Slot &slot = slots[dequeuePosition & (RING_CAPACITY - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1)
+            {
+                break;
+            }
+            std::fprintf(stderr, "[%s] %s\n", CATEGORY_NAMES[slot.category], slot.text);
+            slot.sequence.store(dequeuePosition + RING_CAPACITY, std::memory_order_release);
+            ++dequeuePosition;
+            wroteAny = true;
+        }
+        if (wroteAny)
+        {
+            std::fflush(stderr);
+        }
+        return wroteAny;
+    }
+
+    void run()
+    {
+        while (!stopping.load(std::memory_order_acquire))
+        {
+            if (!drain())
+            {
+                std::this_thread::sleep_for(WRITER_IDLE_WAIT);
+            }
+        }
+        drain();
+    }
+};
+
+LogRing &ring()
+{
+    // Created on first use; the writer is flushed and joined at exit
+    static LogRing instance;
+    return instance;
+}
+
+} // namespace
+
+bool GameLog::isEnabled(Category category)
+{
+    return ring().isEnabled(category);
+}
+
+void GameLog::write(Category category, const char *format, ...)
+{
+    va_list arguments;
+    va_start(arguments, format);
+    ring().push(category, format, arguments);
+    va_end(arguments);
+}
+
+uint64_t GameLog::droppedCount()
+{
+    return ring().droppedCount();
+}
@@ -0,0 +1,87 @@
+/**
+ * @file gamelog.h
+ * @brief Déclaration de la classe GameLog et de la macro BIBLIO_LOG.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef GAMELOG_H
+#define GAMELOG_H
+
+#include <cstdint>
+
+/**
+ * @class GameLog
+ * @brief Journal par catégories pour les chemins exécutés à chaque image (détection, collisions, fruits).
+ *
+ * Les messages sont formatés par l'appelant dans une file circulaire sans verrou, puis écrits
+ * sur la sortie d'erreur par un thread dédié : journaliser ne bloque jamais la boucle de jeu.
+ * Si la file est pleine, le message est abandonné (et compté).
+ *
+ * Les catégories actives sont lues dans la variable d'environnement BIBLIO_LOG :
+ * @code
+ * BIBLIO_LOG=collision,fruit biblio
+ * BIBLIO_LOG=all biblio
+ * @endcode
+ *
+ * La macro BIBLIO_LOG n'est compilée qu'avec BIBLIO_ENABLE_LOGGING (défini en Debug) ;
+ * sinon elle ne produit aucun code et ses arguments ne sont pas évalués.
+ */
+class GameLog
+{
+public:
+    /**
+     * @enum Category
+     * @brief Catégories de messages, activables séparément.
+     */
+    enum Category
+    {
+        Detection,  ///< Mains détectées par CameraHandler.
+        Projection, ///< Projection des points de la caméra dans la scène.
+        Collision,  ///< Tests de collision entre le katana et les fruits.
+        Fruits,     ///< Création et découpe des fruits.
+        Frames,     ///< Régularité des images (FrameScheduler).
+        CategoryCount
+    };
+
+    /**
+     * @brief Indique si une catégorie est active (BIBLIO_LOG).
+     * @param category Catégorie testée.
+     */
+    static bool isEnabled(Category category);
+
+    /**
+     * @brief Ajoute un message à la file, sans bloquer.
+     * @param category Catégorie du message.
+     * @param format Format printf ; le message est tronqué à MAX_MESSAGE_LENGTH caractères.
+     */
+    static void write(Category category, const char *format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+
+    /**
+     * @brief Nombre de messages abandonnés faute de place dans la file.
+     */
+    static uint64_t droppedCount();
+
+    static constexpr int MAX_MESSAGE_LENGTH = 240; ///< Longueur maximale d'un message.
+};
+
+#ifdef BIBLIO_ENABLE_LOGGING
+#define BIBLIO_LOG(category, ...)                           \
+    do                                                      \
+    {                                                       \
+        if (GameLog::isEnabled(GameLog::category))          \
+        {                                                   \
+            GameLog::write(GameLog::category, __VA_ARGS__); \
+        }                                                   \
+    } while (0)
+#else
+#define BIBLIO_LOG(category, ...) \
+    do                            \
+    {                             \
+    } while (0)
+#endif
+
+#endif // GAMELOG_H
@@ -6,6 +6,13 @@
 
 #include "gamewidget.h"
 #include "ui_gamewidget.h"
+#include "gamegeometry.h"
+#include "gamelog.h"
+#include "glresourceregistry.h"
+#include "launchoptions.h"
+#include "framescheduler.h"
+#include "textureatlas.h"
+#include "assetregistry.h"
 #include <QFontDatabase>
 #include <QTimer>
 #include <iostream>
@@ -14,17 +21,32 @@
 #include <QCoreApplication>
 #include <QPainter>
 #include <QDebug>
+#include <QOpenGLContext>
 #include <QOpenGLWidget>
 #include <opencv2/imgproc.hpp>
 #include <QKeyEvent>
 #include <QSoundEffect>
 #include <QUrl>
+#include <algorithm>
 
 // Constants
 const float MAX_DIMENSION = 33.0f;
-
-GameWidget::GameWidget(QWidget *parent)
-    : QWidget(parent), ui(new Ui::GameWidget), m_fruit(std::vector<Fruit *>()), m_cameraTextureId(0) // Initialize camera texture ID
+const double SIMULATION_RATE = 60.0; // Game logic steps per second
+// Fixed camera, shared by gluLookAt and the culling frustum
+const QVector3D CAMERA_EYE(0.0f, 1.8f, -1.0f);
+const QVector3D CAMERA_CENTER(0.0f, 1.0f, 25.0f);
+const QVector3D CAMERA_UP(0.0f, 1.0f, 0.0f);
+const float CAMERA_FOVY = 45.0f;
+const float CAMERA_NEAR = 0.1f;
+const float CAMERA_FAR = 100.0f;
+const int VELOCITY_PROBE_MS = 10; // Time step of the finite difference giving a fruit's velocity
+const GLfloat ARENA_SHININESS = 50.0f;
+const int FLOOR_TEXTURE = AssetLoader::FLOOR_TEXTURE; // Repeated over the ground, kept out of the atlas
+const char *const ATLAS_TEXTURE_NAME = "atlas";        // GLResourceRegistry name of the object texture atlas
+static_assert(GameWidget::TEXTURE_COUNT == AssetLoader::TEXTURE_COUNT, "One texture slot per loaded texture");
+
+GameWidget::GameWidget(AssetLoader *assetLoader, QWidget *parent)
+    : QWidget(parent), ui(new Ui::GameWidget), assetLoader(assetLoader), m_fruit(std::vector<Fruit *>())
       ,
       m_sliceSound(new QSoundEffect(this)) // Initialize sound effect
       ,
@@ -34,11 +56,6 @@ GameWidget::GameWidget(QWidget *parent)
     displayCamera = true;            // Enable camera display for demonstration
     setFocusPolicy(Qt::StrongFocus); // Ensure the widget can receive key press events
 
-    // Set up a timer for animation updates
-    QTimer *timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, &GameWidget::updateFruitDisplay);
-    timer->start(50); // ~60 FPS
-
     if (ui->openGLWidget)
     {
         class CustomGLWidget : public QOpenGLWidget
@@ -67,11 +84,16 @@ GameWidget::GameWidget(QWidget *parent)
 
         ui->openGLWidget = customWidget;
         delete oldWidget;
+
+        // Game logic runs at a fixed rate, frames are paced by the display's vsync
+        frameScheduler = new FrameScheduler(ui->openGLWidget, SIMULATION_RATE, this);
+        connect(frameScheduler, &FrameScheduler::step, this, &GameWidget::simulationStep);
+        frameScheduler->start();
     }
 
     label = new QLabel("Fruit Ninja", this);
 
-    int fontId = QFontDatabase::addApplicationFont("./../../../biblio/assets/NinjaStrike.otf");
+    int fontId = QFontDatabase::addApplicationFont(AssetRegistry::get().path("NinjaStrike.otf"));
     QStringList fontFamilies = QFontDatabase::applicationFontFamilies(fontId);
     if (!fontFamilies.isEmpty())
     {
@@ -94,73 +116,78 @@ GameWidget::GameWidget(QWidget *parent)
     // Initialize camera
     initializeCamera();
 
-    // Initialize sounds
-    QStringList possibleSoundPaths = {
-        QCoreApplication::applicationDirPath() + "/../../../biblio/assets/sounds/",
-        "./assets/sounds/",
-        "../assets/sounds/",
-        "../../assets/sounds/",
-        "../../../assets/sounds/"
-    };
-
-    QString soundBasePath;
-    bool foundSoundPath = false;
-
-    for (const auto &path : possibleSoundPaths) {
-        QDir dir(path);
-        if (dir.exists("fruit_slice.wav") && dir.exists("cannon-shot.wav")) {
-            soundBasePath = path;
-            foundSoundPath = true;
-            qDebug() << "Found sound path: " << soundBasePath;
-            break;
+    // Textures, cascades and sounds are loaded on the AssetLoader's threads during the countdown
+    connect(assetLoader, &AssetLoader::assetLoaded, this, &GameWidget::onAssetLoaded);
+    for (int asset = 0; asset < AssetLoader::AssetCount; ++asset)
+    {
+        if (assetLoader->isLoaded(static_cast<AssetLoader::Asset>(asset)))
+        {
+            onAssetLoaded(static_cast<AssetLoader::Asset>(asset));
         }
     }
+}
 
-    if (!foundSoundPath) {
-        qCritical() << "Cannot find sound directory. Tried paths:";
-        for (const auto &path : possibleSoundPaths) {
-            qCritical() << " - " << path;
-        }
-        // Fallback or error handling if sounds are critical
+GameWidget::~GameWidget()
+{
+    if (frameScheduler)
+    {
+        const FrameScheduler::Stats pacing = frameScheduler->stats();
+        qDebug() << "Frame pacing:" << pacing.frames << "frames at" << pacing.refreshRate << "Hz," << pacing.meanMs << "ms avg,"
+                 << pacing.p95Ms << "ms p95," << pacing.p99Ms << "ms p99," << pacing.maxMs << "ms max," << pacing.lateFrames << "late,"
+                 << pacing.steps << "steps," << pacing.skippedSteps << "skipped";
     }
 
-    if (foundSoundPath) {
-        m_sliceSound->setSource(QUrl::fromLocalFile(soundBasePath + "fruit_slice.wav"));
-        m_sliceSound->setVolume(1.f);
-
-        m_shootSound->setSource(QUrl::fromLocalFile(soundBasePath + "cannon-shot.wav"));
-        m_shootSound->setVolume(1.f);
-    } else {
-        qWarning() << "Sound files not found. Sounds will not play.";
+    const RenderQueue::Stats &renderStats = renderQueue.totals();
+    if (renderStats.frames > 0)
+    {
+        const double frames = static_cast<double>(renderStats.frames);
+        qDebug() << "Render queue:" << renderStats.frames << "frames," << renderStats.draws / frames << "draws,"
+                 << renderStats.stateChanges / frames << "state changes," << renderStats.skippedChanges / frames << "skipped changes,"
+                 << renderStats.bufferBinds / frames << "buffer binds per frame";
     }
-}
 
-GameWidget::~GameWidget()
-{
-    // Stop camera timer before destruction
-    if (cameraTimer)
+    const ParticleSystem::Stats particleStats = particles.stats();
+    qDebug() << "Particles:" << particleStats.emitted << "emitted," << particleStats.dropped << "dropped," << particleStats.peak << "peak,"
+             << particleStats.meanUpdateMs << "ms avg update," << particleStats.maxUpdateMs << "ms max";
+
+    // The detection thread uses cameraHandler, stop it first
+    delete detectionWorker;
+    // Flushes the frames still queued for writing
+    delete sessionRecorder;
+
+    if (cameraInitialized)
+    {
+        CameraHandler::DetectionStats fullStats = cameraHandler->getDetectionStats(CameraHandler::DetectionMode::FullFrame);
+        CameraHandler::DetectionStats roiStats = cameraHandler->getDetectionStats(CameraHandler::DetectionMode::RoiTracking);
+        qDebug() << "Detection full-frame:" << fullStats.scans << "scans," << fullStats.averageMs() << "ms avg," << fullStats.hitRate() * 100.0 << "% hits";
+        CameraHandler::DetectionStats flowStats = cameraHandler->getDetectionStats(CameraHandler::DetectionMode::OpticalFlow);
+        qDebug() << "Detection ROI:" << roiStats.scans << "scans," << roiStats.averageMs() << "ms avg," << roiStats.hitRate() * 100.0 << "% hits";
+        qDebug() << "Detection optical flow:" << flowStats.scans << "updates," << flowStats.averageMs() << "ms avg," << flowStats.hitRate() * 100.0 << "% tracked";
+        qDebug() << "Capture mode:" << cameraHandler->getActiveProfile().toString() << "," << cameraHandler->getFrameIntervalMs() << "ms between frames,"
+                 << cameraHandler->capturedFrameCount() << "captured," << cameraHandler->droppedFrameCount() << "dropped";
+    }
+
+    // Shared textures, meshes, display lists and quadrics are released by GLResourceRegistry with the last context;
+    // the camera texture, the fruit shaders and the cut fruit halves are this widget's own
+    if (ui->openGLWidget && ui->openGLWidget->context())
     {
-        cameraTimer->stop();
-        delete cameraTimer;
+        ui->openGLWidget->makeCurrent();
+        m_cameraTexture.destroy();
+        fruitRenderer.destroy();
+        fruitMeshes.destroySlices();
+        const GLResourceRegistry &resources = GLResourceRegistry::current();
+        qDebug() << "Live GL resources:" << resources.textureCount() << "textures," << resources.bufferCount() << "buffers,"
+                 << resources.displayListCount() << "display lists," << resources.quadricCount() << "quadrics";
+        ui->openGLWidget->doneCurrent();
     }
 
     delete ui;
     delete label;
-    delete[] textures; // Note: This deletes the array, not GL textures. Consider glDeleteTextures for 'textures' array.
     for (auto fruit : m_fruit)
     {
         delete fruit;
     }
     m_fruit.clear();
-    if (cylinder)
-    {
-        gluDeleteQuadric(cylinder);
-    }
-
-    if (m_cameraTextureId != 0)
-    {
-        glDeleteTextures(1, &m_cameraTextureId);
-    }
 
     delete cameraHandler;
 
@@ -171,14 +198,35 @@ GameWidget::~GameWidget()
     }
 }
 
-void GameWidget::updateFruitDisplay()
+void GameWidget::simulationStep(QTime time)
 {
-    // Update time for animation
+    // The katana is drawn between its last two step positions
+    previousProjectedPoint = projectedPoint;
 
-    if (ui->openGLWidget)
+    updateFrame(time);
+
+    // Particles live in the same slowed-down game time as the fruits
+    particles.update(GameGeometry::gameSeconds(1000.0 / SIMULATION_RATE));
+    BIBLIO_LOG(Fruits, "Particles: %d alive, updated in %.3f ms", particles.count(), particles.lastUpdateMs());
+
+    // Replace the fruits that fell below the floor
+    for (size_t i = 0; i < m_fruit.size();)
     {
-        // Force an update to the OpenGL widget, which should trigger paintGL
-        ui->openGLWidget->update();
+        Fruit *fruit = m_fruit[i];
+        if (fruit->getPosition(time).y() >= 0)
+        {
+            ++i;
+            continue;
+        }
+        if (!fruit->isCut() && !fruit->isBomb())
+        {
+            emit lifeDecrease();
+        }
+        delete fruit;
+        m_fruit.erase(m_fruit.begin() + i);
+
+        // The new fruit is appended and checked later in this loop
+        createFruit(time);
     }
 }
 
@@ -206,205 +254,149 @@ void GameWidget::initializeGL()
 
     initializeTextures();
 
-    // Initialize camera texture
-    if (m_cameraTextureId == 0)
-    {
-        glGenTextures(1, &m_cameraTextureId);
-        glBindTexture(GL_TEXTURE_2D, m_cameraTextureId);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glBindTexture(GL_TEXTURE_2D, 0); // Unbind
-    }
+    // Fruit geometry is built once, fruits only bind and draw it
+    fruitMeshes.create(textureRegions);
+    fruitRenderer.initialize();
+    initializeSceneLists();
+
+    // The camera texture is allocated with the first frame, at the camera resolution
 }
 
 void GameWidget::initializeTextures()
 {
-    // Increase array size to include cannon texture
-    textures = new GLuint[10];
-    glGenTextures(10, textures);
-
-    // Get the application directory and build absolute paths
-    QDir appDir(QCoreApplication::applicationDirPath());
-    qDebug() << "Application directory: " << appDir.absolutePath();
-
-    // Try multiple possible texture locations
-    QStringList possibleBasePaths = {
-        appDir.absolutePath() + "/../../../biblio/assets/textures/",
-        // Relative to current directory
-        "./assets/textures/",
-        // Try going up directories
-        "../assets/textures/",
-        "../../assets/textures/",
-        "../../../assets/textures/",
-        // Absolute path
-        "/Users/ismail/projet-biblio-multimedia/biblio/assets/textures/"};
-
-    QString base_path;
-    bool foundPath = false;
-
-    // Find the first valid path that contains at least one texture
-    for (const auto &path : possibleBasePaths)
-    {
-        QDir dir(path);
-        if (dir.exists("apple.jpg") || dir.exists("strawberry.jpg"))
-        {
-            base_path = path;
-            foundPath = true;
-            qDebug() << "Found texture path: " << base_path;
-            break;
-        }
+    GLResourceRegistry &resources = GLResourceRegistry::current();
+
+    // Every object texture is a region of one atlas, only the floor has its own texture
+    int slot = 0;
+    for (int i = 0; i < TEXTURE_COUNT; ++i)
+    {
+        textureRegions[i] = i == FLOOR_TEXTURE ? QRectF(0.0, 0.0, 1.0, 1.0) : TextureAtlas::region(slot++, TEXTURE_COUNT - 1);
     }
 
-    if (!foundPath)
+    // Textures are shared by every game window, only the first one uploads them. They are only registered once
+    // filled, so a window closed before its atlas was loaded leaves nothing blank behind for the next ones
+    GLuint atlasTexture = resources.texture(ATLAS_TEXTURE_NAME);
+    GLuint floorTexture = resources.texture(AssetLoader::textureName(FLOOR_TEXTURE));
+    if (atlasTexture != 0 && floorTexture != 0)
     {
-        qCritical() << "Cannot find texture directory. Tried paths:";
-        for (const auto &path : possibleBasePaths)
+        applyTextures(atlasTexture, floorTexture);
+    }
+    else
+    {
+        // Drawn untextured until the atlas is loaded
+        texturesPending = true;
+        if (assetLoader->isLoaded(AssetLoader::Textures))
         {
-            qCritical() << " - " << path;
+            uploadTextures(resources);
         }
     }
 
-    // Load images
-    QImage appleImage(base_path + "apple.jpg");
-    QImage strawberryImage(base_path + "strawberry.jpg");
-    QImage bananaImage(base_path + "banana.jpg");
-    QImage pearImage(base_path + "pear.jpg");
-    QImage bombImage(base_path + "bomb.jpg");
-    QImage floorImage(base_path + "floor.jpg");
-    QImage cannonImage(base_path + "cannon.jpg");
-    QImage bladeImage(base_path + "blade.jpg");
-    QImage handleImage(base_path + "handle.jpg");
-    QImage chainImage(base_path + "chain.jpg");
-
-    // Try loading backup textures if original textures failed
-    if (appleImage.isNull())
-    {
-        qWarning() << "Failed to load apple.jpg, trying backup red.jpg";
-        appleImage = QImage(base_path + "red.jpg");
-    }
-    if (strawberryImage.isNull())
-    {
-        qWarning() << "Failed to load orange.jpg, trying backup orange_alt.jpg";
-        strawberryImage = QImage(base_path + "orange_alt.jpg");
-    }
-
-    appleImage = appleImage.convertToFormat(QImage::Format_RGBA8888);
-    strawberryImage = strawberryImage.convertToFormat(QImage::Format_RGBA8888);
-    bananaImage = bananaImage.convertToFormat(QImage::Format_RGBA8888);
-    pearImage = pearImage.convertToFormat(QImage::Format_RGBA8888);
-    bombImage = bombImage.convertToFormat(QImage::Format_RGBA8888);
-    floorImage = floorImage.convertToFormat(QImage::Format_RGBA8888);
-    cannonImage = cannonImage.convertToFormat(QImage::Format_RGBA8888);
-    bladeImage = bladeImage.convertToFormat(QImage::Format_RGBA8888);
-    handleImage = handleImage.convertToFormat(QImage::Format_RGBA8888);
-    chainImage = chainImage.convertToFormat(QImage::Format_RGBA8888);
-
-    // check if images are loaded correctly
-    if (appleImage.isNull() || strawberryImage.isNull() || bananaImage.isNull() ||
-        pearImage.isNull() || bombImage.isNull() || floorImage.isNull() ||
-        cannonImage.isNull() || bladeImage.isNull() || handleImage.isNull() || chainImage.isNull())
-    {
-        qCritical() << "Error loading texture images";
-
-        // Create fallback colored textures
-        appleImage = createColorTexture(QColor(255, 0, 0));        // Red for apple
-        strawberryImage = createColorTexture(QColor(255, 165, 0)); // Orange
-        bananaImage = createColorTexture(QColor(255, 255, 0));     // Yellow for banana
-        pearImage = createColorTexture(QColor(0, 255, 0));         // Green for pear
-        bombImage = createColorTexture(QColor(50, 50, 50));        // Dark gray for bomb
-        floorImage = createColorTexture(QColor(0, 0, 255));        // Blue for floor
-        cannonImage = createColorTexture(QColor(100, 100, 100));   // Gray for cannon
-        bladeImage = createColorTexture(QColor(255, 255, 255));    // White for blade
-        handleImage = createColorTexture(QColor(150, 75, 0));      // Brown for handle
-        chainImage = createColorTexture(QColor(128, 128, 128));    // Gray for chain
-    }
-
-    // Apple Texture
-    glBindTexture(GL_TEXTURE_2D, textures[0]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, appleImage.width(), appleImage.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, appleImage.bits());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Strawberry Texture
-    glBindTexture(GL_TEXTURE_2D, textures[1]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, strawberryImage.width(), strawberryImage.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, strawberryImage.bits());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Banana Texture
-    glBindTexture(GL_TEXTURE_2D, textures[2]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, bananaImage.width(), bananaImage.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, bananaImage.bits());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Pear Texture
-    glBindTexture(GL_TEXTURE_2D, textures[3]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, pearImage.width(), pearImage.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, pearImage.bits());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Bomb Texture
-    glBindTexture(GL_TEXTURE_2D, textures[4]); // Use index 4 for bomb (was using 4 even though array was sized 4)
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, bombImage.width(), bombImage.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, bombImage.bits());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Floor Texture
-    glBindTexture(GL_TEXTURE_2D, textures[5]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, floorImage.width(), floorImage.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, floorImage.bits());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Cannon Texture
-    glBindTexture(GL_TEXTURE_2D, textures[6]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, cannonImage.width(), cannonImage.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, cannonImage.bits());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Blade Texture
-    glBindTexture(GL_TEXTURE_2D, textures[7]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, bladeImage.width(), bladeImage.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, bladeImage.bits());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Handle Texture
-    glBindTexture(GL_TEXTURE_2D, textures[8]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, handleImage.width(), handleImage.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, handleImage.bits());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Chain Texture
-    glBindTexture(GL_TEXTURE_2D, textures[9]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, chainImage.width(), chainImage.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, chainImage.bits());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    m_katana->setTextureRegions(textureRegions[7], textureRegions[8], textureRegions[9]);
+}
+
+void GameWidget::uploadTextures(GLResourceRegistry &resources)
+{
+    const TextureAtlas &atlas = assetLoader->textureAtlas();
+    if (atlas.pageCount() < 2)
+    {
+        qWarning() << "No texture atlas to upload";
+        return;
+    }
+
+    bool created = false;
+    const GLuint atlasTexture = resources.createTexture(ATLAS_TEXTURE_NAME, &created);
+    if (created)
+    {
+        atlas.upload(0, atlasTexture, false);
+    }
+    const GLuint floorTexture = resources.createTexture(AssetLoader::textureName(FLOOR_TEXTURE), &created);
+    if (created)
+    {
+        atlas.upload(1, floorTexture, true);
+    }
+    texturesPending = false;
+    applyTextures(atlasTexture, floorTexture);
 
     glFlush(); // Ensure texture uploads are finished
-    qDebug() << "Texture IDs: " << textures[0] << " " << textures[1] << " " << textures[2] << " "
-             << textures[3] << " " << textures[4] << " " << textures[5] << " " << textures[6]
-             << " " << textures[7] << " " << textures[8] << " " << textures[9];
+}
+
+void GameWidget::applyTextures(GLuint atlasTexture, GLuint floorTexture)
+{
+    // Fruits read this array, they pick up the textures on their next frame
+    for (int i = 0; i < TEXTURE_COUNT; ++i)
+    {
+        textures[i] = i == FLOOR_TEXTURE ? floorTexture : atlasTexture;
+    }
+    qDebug() << "Texture IDs: atlas" << atlasTexture << ", floor" << floorTexture;
 
     // Set the cannon texture
-    cannon.setTexture(textures[6]);
+    cannon.setTexture(textures[6], textureRegions[6]);
 
     // Set the katana texture
     m_katana->setTextures(textures[7], textures[8], textures[9]);
 }
 
-// Add helper method to create fallback textures
-QImage GameWidget::createColorTexture(const QColor &color)
+bool GameWidget::sharedTexturesUploaded()
 {
-    QImage img(256, 256, QImage::Format_RGBA8888);
-    img.fill(color);
-    return img;
+    // With Qt::AA_ShareOpenGLContexts every game window joins the group of Qt's global share context
+    const GLResourceRegistry *resources = GLResourceRegistry::find(QOpenGLContext::globalShareContext());
+    return resources && resources->texture(ATLAS_TEXTURE_NAME) != 0 && resources->texture(AssetLoader::textureName(FLOOR_TEXTURE)) != 0;
+}
+
+void GameWidget::onAssetLoaded(AssetLoader::Asset asset)
+{
+    switch (asset)
+    {
+    case AssetLoader::Textures:
+        // Before initializeGL() the upload is left to initializeTextures()
+        if (texturesPending && ui->openGLWidget && ui->openGLWidget->context())
+        {
+            ui->openGLWidget->makeCurrent();
+            uploadTextures(GLResourceRegistry::current());
+            ui->openGLWidget->doneCurrent();
+            ui->openGLWidget->update();
+        }
+        break;
+    case AssetLoader::Cascades:
+        // The detection thread reads the cascades: it must not run while they are replaced
+        if (detectionWorker)
+        {
+            detectionWorker->stop();
+            cameraHandler->setCascades(assetLoader->takeCascades());
+            detectionWorker->start();
+        }
+        else
+        {
+            cameraHandler->setCascades(assetLoader->takeCascades());
+            startDetection();
+        }
+        break;
+    case AssetLoader::Sounds:
+    {
+        // QSoundEffect decodes its source in the background
+        if (assetLoader->hasSounds())
+        {
+            m_sliceSound->setSource(AssetRegistry::get().url("sounds/fruit_slice.wav"));
+            m_sliceSound->setVolume(1.f);
+
+            m_shootSound->setSource(AssetRegistry::get().url("sounds/cannon-shot.wav"));
+            m_shootSound->setVolume(1.f);
+        }
+        else
+        {
+            qWarning() << "Sound files not found. Sounds will not play.";
+        }
+        break;
+    }
+    default:
+        break;
+    }
 }
 
 // Add new createFruit function
-Fruit *GameWidget::createFruit()
+Fruit *GameWidget::createFruit(QTime time)
 {
-    Fruit *newFruit = new Fruit(textures, QTime::currentTime());
+    Fruit *newFruit = new Fruit(textures, time);
     m_fruit.push_back(newFruit);
     if (m_shootSound->isLoaded())
     {
@@ -429,15 +421,28 @@ void GameWidget::startCountdown(int seconds)
                     seconds--;
                 } else {
                     countdownTimer->stop();
-                    delete countdownTimer;
-                    delete label; // Delete the label after countdown
-
-                    // Use the new createFruit function instead of direct creation
-                    createFruit();
+                    countdownTimer->deleteLater();
+
+                    // The countdown normally covers the loading; otherwise wait for the last asset
+                    if (assetLoader->isFinished()) {
+                        launchFirstFruit();
+                    } else {
+                        label->setText("...");
+                        connect(assetLoader, &AssetLoader::finished, this, &GameWidget::launchFirstFruit);
+                    }
                 } });
     countdownTimer->start(1000); // Update every second
 }
 
+void GameWidget::launchFirstFruit()
+{
+    delete label; // Delete the label after countdown
+    label = nullptr;
+
+    // Use the new createFruit function instead of direct creation
+    createFruit(frameScheduler ? frameScheduler->stepTime() : QTime::currentTime());
+}
+
 void GameWidget::resizeGL(int width, int height)
 {
     // Definition du viewport (zone d'affichage)
@@ -449,11 +454,112 @@ void GameWidget::resizeGL(int width, int height)
 
     // Use perspective projection instead of orthographic
     GLfloat aspect = width > 0 ? (GLfloat)width / (GLfloat)height : 1.0f;
-    gluPerspective(45.0f, aspect, 0.1f, 100.0f);
+    gluPerspective(CAMERA_FOVY, aspect, CAMERA_NEAR, CAMERA_FAR);
 
     // Return to modelview matrix
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
+
+    // Same projection and view on the CPU, to cull fruits and pick their level of detail.
+    // The size is in logical pixels: the detail thresholds are in device pixels, as rasterized on high-DPI screens.
+    QMatrix4x4 projection;
+    projection.perspective(CAMERA_FOVY, aspect, CAMERA_NEAR, CAMERA_FAR);
+    QMatrix4x4 view;
+    view.lookAt(CAMERA_EYE, CAMERA_CENTER, CAMERA_UP);
+    const qreal pixelRatio = ui->openGLWidget ? ui->openGLWidget->devicePixelRatioF() : devicePixelRatioF();
+    viewFrustum = ViewFrustum(projection, view, qRound(height * pixelRatio));
+}
+
+void GameWidget::initializeSceneLists()
+{
+    GLResourceRegistry &resources = GLResourceRegistry::current();
+
+    bool created = false;
+    arenaList = resources.displayList("scene.arena", &created);
+    if (created)
+    {
+        GLUquadric *cylinder = resources.quadric("scene.cylinder");
+        glNewList(arenaList, GL_COMPILE);
+        // Draw a cylinder around the player (in 0,y,0)
+        glPushMatrix();
+        glTranslatef(0.0f, 4.0f, 0.0f);
+        glRotatef(90.0f, 1.0f, 0.0f, 0.0f); // Rotate to align with the Z-axis
+        gluQuadricDrawStyle(cylinder, GLU_LINE);
+        gluCylinder(cylinder, 1.0f, 1.0f, 4.0f, 32, 32);
+        glPopMatrix();
+        glEndList();
+    }
+
+    // The list enables texturing, the floor texture itself is bound before each call
+    groundList = resources.displayList("scene.ground", &created);
+    if (created)
+    {
+        glNewList(groundList, GL_COMPILE);
+        // Draw the ground with a grid pattern and texture
+        glPushMatrix();
+
+        // Set material properties for the floor - adjust for texture
+        GLfloat floor_ambient[] = {0.7f, 0.7f, 0.7f, 1.0f};
+        GLfloat floor_diffuse[] = {1.0f, 1.0f, 1.0f, 1.0f};
+        GLfloat floor_specular[] = {0.2f, 0.2f, 0.2f, 1.0f};
+        glMaterialfv(GL_FRONT, GL_AMBIENT, floor_ambient);
+        glMaterialfv(GL_FRONT, GL_DIFFUSE, floor_diffuse);
+        glMaterialfv(GL_FRONT, GL_SPECULAR, floor_specular);
+        glMaterialf(GL_FRONT, GL_SHININESS, 10.0f);
+
+        // Use the floor texture, bound by paintGL(): the list may be compiled before the texture exists
+        glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        glEnable(GL_TEXTURE_2D);
+
+        // Draw the main ground plane with texture
+        glBegin(GL_QUADS);
+        glNormal3f(0.0f, 1.0f, 0.0f);
+
+        const float textureRepetition = 20.0f;
+
+        // Add texture coordinates to the ground quad
+        glTexCoord2f(0.0f, 0.0f);
+        glVertex3f(-MAX_DIMENSION, 0.0f, -MAX_DIMENSION);
+        glTexCoord2f(textureRepetition, 0.0f);
+        glVertex3f(MAX_DIMENSION, 0.0f, -MAX_DIMENSION);
+        glTexCoord2f(textureRepetition, textureRepetition);
+        glVertex3f(MAX_DIMENSION, 0.0f, MAX_DIMENSION);
+        glTexCoord2f(0.0f, textureRepetition);
+        glVertex3f(-MAX_DIMENSION, 0.0f, MAX_DIMENSION);
+        glEnd();
+
+        // Disable texturing before drawing the grid
+        glDisable(GL_TEXTURE_2D);
+
+        // Add a grid pattern on top of the ground
+        GLfloat grid_diffuse[] = {0.1f, 0.4f, 0.1f, 1.0f}; // Darker green for grid lines
+        glMaterialfv(GL_FRONT, GL_DIFFUSE, grid_diffuse);
+
+        // Draw grid lines
+        const float gridSize = 1.0f;
+        const float gridY = 0.01f; // Slightly above the ground to prevent z-fighting
+
+        glBegin(GL_LINES);
+        // Draw lines along the Z axis
+        for (float x = -MAX_DIMENSION; x <= MAX_DIMENSION; x += gridSize)
+        {
+            glVertex3f(x, gridY, -MAX_DIMENSION);
+            glVertex3f(x, gridY, MAX_DIMENSION);
+        }
+
+        // Draw lines along the X axis
+        for (float z = -MAX_DIMENSION; z <= MAX_DIMENSION; z += gridSize)
+        {
+            glVertex3f(-MAX_DIMENSION, gridY, z);
+            glVertex3f(MAX_DIMENSION, gridY, z);
+        }
+        glEnd();
+
+        glPopMatrix();
+        glEndList();
+    }
+
+    cannon.createDisplayLists();
 }
 
 void GameWidget::paintGL()
@@ -466,200 +572,172 @@ void GameWidget::paintGL()
     glLoadIdentity();
 
     // Set camera position with better positioning for perspective view
-    gluLookAt(0.0f, 1.8f, -1.f, // Eye position
-                                // gluLookAt(2.0f, 1.8f, 20.f,        // testing eye position
-              0.0f, 1.0f, 25.0f, // Look at position (center)
-              0.0f, 1.0f, 0.0f); // Up vector
+    gluLookAt(CAMERA_EYE.x(), CAMERA_EYE.y(), CAMERA_EYE.z(),          // Eye position
+              CAMERA_CENTER.x(), CAMERA_CENTER.y(), CAMERA_CENTER.z(), // Look at position (center)
+              CAMERA_UP.x(), CAMERA_UP.y(), CAMERA_UP.z());            // Up vector
 
     GLfloat light_position[] = {5.0f, 5.0f, 5.0f, 1.0f};
     glLightfv(GL_LIGHT0, GL_POSITION, light_position);
 
-    // Draw the cannon
-    cannon.drawCannon();
+    // Static scene, compiled once. The ground list sets its own material, it is drawn right away
+    glBindTexture(GL_TEXTURE_2D, textures[FLOOR_TEXTURE]);
+    glCallList(groundList);
 
-    // Draw a cylinder around the player (in 0,y,0)
-    glPushMatrix();
-    glTranslatef(0.0f, 4.0f, 0.0f);
-    glRotatef(90.0f, 1.0f, 0.0f, 0.0f); // Rotate to align with the Z-axis
-    cylinder = gluNewQuadric();
-    gluQuadricDrawStyle(cylinder, GLU_LINE);
-    gluCylinder(cylinder, 1.0f, 1.0f, 4.0f, 32, 32);
-    glPopMatrix();
+    // Everything else is submitted to the render queue and drawn sorted by state at the end of the frame
+    cannon.submit(renderQueue);
 
-    // Draw the ground with a grid pattern and texture
-    glPushMatrix();
-
-    // Set material properties for the floor - adjust for texture
-    GLfloat floor_ambient[] = {0.7f, 0.7f, 0.7f, 1.0f};
-    GLfloat floor_diffuse[] = {1.0f, 1.0f, 1.0f, 1.0f};
-    GLfloat floor_specular[] = {0.2f, 0.2f, 0.2f, 1.0f};
-    glMaterialfv(GL_FRONT, GL_AMBIENT, floor_ambient);
-    glMaterialfv(GL_FRONT, GL_DIFFUSE, floor_diffuse);
-    glMaterialfv(GL_FRONT, GL_SPECULAR, floor_specular);
-    glMaterialf(GL_FRONT, GL_SHININESS, 10.0f);
-
-    // Use the floor texture
-    glBindTexture(GL_TEXTURE_2D, textures[5]);
-    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-    glEnable(GL_TEXTURE_2D);
-
-    // Draw the main ground plane with texture
-    glBegin(GL_QUADS);
-    glNormal3f(0.0f, 1.0f, 0.0f);
-
-    const float textureRepetition = 20.0f;
-
-    // Add texture coordinates to the ground quad
-    glTexCoord2f(0.0f, 0.0f);
-    glVertex3f(-MAX_DIMENSION, 0.0f, -MAX_DIMENSION);
-    glTexCoord2f(textureRepetition, 0.0f);
-    glVertex3f(MAX_DIMENSION, 0.0f, -MAX_DIMENSION);
-    glTexCoord2f(textureRepetition, textureRepetition);
-    glVertex3f(MAX_DIMENSION, 0.0f, MAX_DIMENSION);
-    glTexCoord2f(0.0f, textureRepetition);
-    glVertex3f(-MAX_DIMENSION, 0.0f, MAX_DIMENSION);
-    glEnd();
+    // The arena is lit like the cannon it used to follow
+    RenderQueue::State arena;
+    std::fill(arena.material.specular, arena.material.specular + 4, 1.0f);
+    arena.material.shininess = ARENA_SHININESS;
+    const GLuint arenaDisplayList = arenaList;
+    renderQueue.submit(RenderQueue::Opaque, QMatrix4x4(), arena, [arenaDisplayList](GLStateCache &) { glCallList(arenaDisplayList); });
 
-    // Disable texturing before drawing the grid
-    glDisable(GL_TEXTURE_2D);
+    // Fruit motion is analytic: draw it at the interpolated time between the last two steps
+    const QTime now = frameScheduler ? frameScheduler->renderTime() : QTime::currentTime();
+    const float alpha = frameScheduler ? static_cast<float>(frameScheduler->interpolation()) : 1.f;
 
-    // Add a grid pattern on top of the ground
-    GLfloat grid_diffuse[] = {0.1f, 0.4f, 0.1f, 1.0f}; // Darker green for grid lines
-    glMaterialfv(GL_FRONT, GL_DIFFUSE, grid_diffuse);
-
-    // Draw grid lines
-    const float gridSize = 1.0f;
-    const float gridY = 0.01f; // Slightly above the ground to prevent z-fighting
-
-    glBegin(GL_LINES);
-    // Draw lines along the Z axis
-    for (float x = -MAX_DIMENSION; x <= MAX_DIMENSION; x += gridSize)
+    // Leave out fruits outside the view before any draw work, and pick the others' level of detail
+    visibleFruits.clear();
+    for (Fruit *fruit : m_fruit)
     {
-        glVertex3f(x, gridY, -MAX_DIMENSION);
-        glVertex3f(x, gridY, MAX_DIMENSION);
+        const float radius = fruitMeshes.boundingRadius(fruit->getType());
+        const QVector3D position = fruit->getPosition(now);
+        bool visible = viewFrustum.intersectsSphere(position, radius);
+        if (fruit->isCut())
+        {
+            // Either half may still be in view; the halves are sliced from the full mesh
+            visible = visible || viewFrustum.intersectsSphere(fruit->getPosition(now, -1.f), radius);
+        }
+        if (visible)
+        {
+            fruit->setDetailLevel(FruitMeshLibrary::levelFor(viewFrustum.projectedRadius(position, radius)));
+            visibleFruits.push_back(fruit);
+        }
     }
+    BIBLIO_LOG(Fruits, "Fruits drawn: %zu of %zu", visibleFruits.size(), m_fruit.size());
 
-    // Draw lines along the X axis
-    for (float z = -MAX_DIMENSION; z <= MAX_DIMENSION; z += gridSize)
+    if (fruitRenderer.isAvailable())
     {
-        glVertex3f(-MAX_DIMENSION, gridY, z);
-        glVertex3f(MAX_DIMENSION, gridY, z);
+        fruitRenderer.draw(visibleFruits, now, fruitMeshes, textures);
     }
-    glEnd();
-
-    glPopMatrix();
-
-    // Draw the fruit after re-enabling lighting
-    for (auto fruit : m_fruit)
+    else
     {
-
-        // if the fruit y coordinate is less than 0, remove it
-        if (fruit->getPosition(QTime::currentTime()).y() < 0)
+        for (Fruit *fruit : visibleFruits)
         {
-            if (!fruit->isCut() && !fruit->isBomb())
-            {
-                emit lifeDecrease();
-            }
-            delete fruit;
-            m_fruit.erase(std::remove(m_fruit.begin(), m_fruit.end(), fruit), m_fruit.end());
-
-            // Use the new createFruit function instead of direct creation
-            createFruit();
-            continue;
-        }
-        else
-        {
-            fruit->draw(QTime::currentTime());
+            fruit->submit(renderQueue, now, fruitMeshes);
         }
     }
+    // Cut fruits keep their halves until they are deleted, so the queued ones stay valid
+    fruitMeshes.releaseUnusedSlices();
+
+    // Juice and debris, one draw for all of them after the opaque objects
+    if (particles.count() > 0)
+    {
+        renderQueue.submit(RenderQueue::Translucent, QMatrix4x4(), RenderQueue::State(), [this](GLStateCache &) { particles.draw(); });
+    }
 
     if (!m_katana)
     {
         m_katana = new Katana();
         m_katana->setTextures(textures[7], textures[8], textures[9]);
+        m_katana->setTextureRegions(textureRegions[7], textureRegions[8], textureRegions[9]);
     }
 
-    // Sauvegarder l'état de la matrice
-    glPushMatrix();
-
-    // Réinitialiser les transformations
-    glLoadIdentity();
-
-    // Appliquer la même vue caméra que pour le reste de la scène
-    gluLookAt(0.0f, 1.8f, -1.f,  // Eye position
-              0.0f, 1.0f, 25.0f, // Look at position
-              0.0f, 1.0f, 0.0f); // Up vector
-
-    // Dessiner le katana
-    m_katana->draw(projectedPoint);
-
-    // Restaurer l'état de la matrice
-    glPopMatrix();
+    // Dessiner le katana, avec la même vue caméra que pour le reste de la scène
+    m_katana->submit(renderQueue, previousProjectedPoint + (projectedPoint - previousProjectedPoint) * alpha);
 
     // Display camera feed in top-left corner
-    if (displayCamera && cameraInitialized && !currentFrame.empty() && ui->openGLWidget)
+    // With luma capture the color image is only rebuilt here, when the feed is actually shown,
+    // and a frame is only uploaded once however many times it is painted
+    bool cameraImage = false;
+    if (displayCamera && cameraInitialized && ui->openGLWidget)
     {
-        glMatrixMode(GL_PROJECTION);
-        glPushMatrix();
-        glLoadIdentity();
-        // Use the QOpenGLWidget's dimensions for ortho projection
-        gluOrtho2D(0, ui->openGLWidget->width(), ui->openGLWidget->height(), 0);
+        cameraImage = m_cameraTexture.isCurrent(currentFrame.sequence) ||
+                      (CameraHandler::ensureColor(currentFrame) && m_cameraTexture.update(currentFrame.image, currentFrame.sequence));
+    }
+    if (cameraImage)
+    {
+        // Unlit, without depth test and untinted: the overlay pass and the default state give all of it
+        RenderQueue::State overlay;
+        overlay.texture = m_cameraTexture.textureId();
+        renderQueue.submit(RenderQueue::Overlay, QMatrix4x4(), overlay, [this](GLStateCache &cache) { drawCameraOverlay(cache); });
+    }
 
-        glMatrixMode(GL_MODELVIEW);
-        glPushMatrix();
-        glLoadIdentity();
+    renderQueue.flush(stateCache);
+    const RenderQueue::Stats &frame = renderQueue.lastFrame();
+    BIBLIO_LOG(Frames, "Render queue: %llu draws, %llu state changes, %llu skipped, %llu buffer binds",
+               static_cast<unsigned long long>(frame.draws), static_cast<unsigned long long>(frame.stateChanges),
+               static_cast<unsigned long long>(frame.skippedChanges), static_cast<unsigned long long>(frame.bufferBinds));
+}
 
-        glDisable(GL_LIGHTING);
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_TEXTURE_2D);
+void GameWidget::drawCameraOverlay(GLStateCache &cache)
+{
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    // Use the QOpenGLWidget's dimensions for ortho projection
+    gluOrtho2D(0, ui->openGLWidget->width(), ui->openGLWidget->height(), 0);
+
+    // The render queue pushed the modelview matrix for this item
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
 
-        cv::Mat displayFrame;
-        // Convert BGR (OpenCV default) to RGBA for OpenGL
-        cv::cvtColor(currentFrame, displayFrame, cv::COLOR_BGR2RGBA);
+    float camFeedWidth = ui->openGLWidget->width() / 4.0f;
+    float camFeedHeight = ui->openGLWidget->height() / 4.0f;
 
-        glBindTexture(GL_TEXTURE_2D, m_cameraTextureId);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, displayFrame.cols, displayFrame.rows, 0, GL_RGBA, GL_UNSIGNED_BYTE, displayFrame.data);
+    // Preserve aspect ratio of the camera feed
+    float camAspectRatio = (float)m_cameraTexture.width() / (float)m_cameraTexture.height();
+    if (camAspectRatio > 0)
+    {
+        // Adjust height based on width to maintain aspect ratio
+        camFeedHeight = camFeedWidth / camAspectRatio;
+    }
 
-        float camFeedWidth = ui->openGLWidget->width() / 4.0f;
-        float camFeedHeight = ui->openGLWidget->height() / 4.0f;
+    glBegin(GL_QUADS);
+    glTexCoord2f(0, 0);
+    glVertex2f(0, 0); // Top-left
+    glTexCoord2f(1, 0);
+    glVertex2f(camFeedWidth, 0); // Top-right
+    glTexCoord2f(1, 1);
+    glVertex2f(camFeedWidth, camFeedHeight); // Bottom-right
+    glTexCoord2f(0, 1);
+    glVertex2f(0, camFeedHeight); // Bottom-left
+    glEnd();
 
-        // Preserve aspect ratio of the camera feed
-        float camAspectRatio = (float)displayFrame.cols / (float)displayFrame.rows;
-        if (camAspectRatio > 0)
+    // Detection runs on its own thread, so outline the latest hands here instead of drawing into the frame
+    if (!m_detection.rects.empty() && m_detection.frameSize.width > 0 && m_detection.frameSize.height > 0)
+    {
+        float scaleX = camFeedWidth / m_detection.frameSize.width;
+        float scaleY = camFeedHeight / m_detection.frameSize.height;
+
+        const GLfloat green[] = {0.0f, 1.0f, 0.0f, 1.0f};
+        cache.bindTexture(0);
+        cache.setColor(green);
+        glLineWidth(2.0f);
+        for (const auto &rect : m_detection.rects)
         {
-            // Adjust height based on width to maintain aspect ratio
-            camFeedHeight = camFeedWidth / camAspectRatio;
+            glBegin(GL_LINE_LOOP);
+            glVertex2f(rect.x * scaleX, rect.y * scaleY);
+            glVertex2f((rect.x + rect.width) * scaleX, rect.y * scaleY);
+            glVertex2f((rect.x + rect.width) * scaleX, (rect.y + rect.height) * scaleY);
+            glVertex2f(rect.x * scaleX, (rect.y + rect.height) * scaleY);
+            glEnd();
         }
-
-        glColor3f(1.0f, 1.0f, 1.0f); // Ensure texture is not tinted
-
-        glBegin(GL_QUADS);
-        glTexCoord2f(0, 0);
-        glVertex2f(0, 0); // Top-left
-        glTexCoord2f(1, 0);
-        glVertex2f(camFeedWidth, 0); // Top-right
-        glTexCoord2f(1, 1);
-        glVertex2f(camFeedWidth, camFeedHeight); // Bottom-right
-        glTexCoord2f(0, 1);
-        glVertex2f(0, camFeedHeight); // Bottom-left
-        glEnd();
-
-        glBindTexture(GL_TEXTURE_2D, 0); // Unbind texture
-
-        // Restore GL state
-        glEnable(GL_DEPTH_TEST); // Re-enable depth testing
-        glEnable(GL_LIGHTING);   // Re-enable lighting (if it was on for 3D scene)
-
-        glMatrixMode(GL_PROJECTION);
-        glPopMatrix();
-        glMatrixMode(GL_MODELVIEW);
-        glPopMatrix();
+        glLineWidth(1.0f);
     }
+
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
 }
 
 void GameWidget::initializeCamera()
 {
-    cameraHandler = new CameraHandler();
+    // The cascades are parsed by the AssetLoader and installed when ready
+    cameraHandler = new CameraHandler(false);
+    // Detection only needs luma; BIBLIO_LUMA_CAPTURE=0 keeps the backend's BGR conversion for comparison
+    cameraHandler->setLumaCapture(qEnvironmentVariable("BIBLIO_LUMA_CAPTURE", "1") != "0");
     // Try to open the camera
     int openStatus = cameraHandler->openCamera();
 
@@ -668,10 +746,42 @@ void GameWidget::initializeCamera()
         // Camera opened successfully
         cameraInitialized = true;
 
-        // Set up timer for camera frame updates
-        cameraTimer = new QTimer(this);
-        connect(cameraTimer, &QTimer::timeout, this, &GameWidget::updateFrame);
-        cameraTimer->start(33); // ~30 fps
+        // Frames are read on a background thread; updateFrame() only picks up the newest one
+        cameraHandler->startCapture();
+
+        // Cascade every few frames and optical flow in between by default; BIBLIO_DETECTION_MODE=full|roi|flow to compare
+        const QString detectionMode = qEnvironmentVariable("BIBLIO_DETECTION_MODE", "flow");
+        if (detectionMode == "full")
+        {
+            cameraHandler->setDetectionMode(CameraHandler::DetectionMode::FullFrame);
+        }
+        else if (detectionMode == "roi")
+        {
+            cameraHandler->setDetectionMode(CameraHandler::DetectionMode::RoiTracking);
+        }
+        else
+        {
+            cameraHandler->setDetectionMode(CameraHandler::DetectionMode::OpticalFlow);
+        }
+        // Run the cascade on a downscaled gray image on high-resolution webcams; results stay in frame coordinates
+        cameraHandler->setDetectionPyramidLevel(CameraHandler::AUTO_DETECTION_LEVEL);
+
+        // Hand detection starts once the AssetLoader has parsed the cascades (startDetection())
+
+        // --record: keep every analyzed frame with its results for later replay
+        const QString recordPath = LaunchOptions::get().recordPath;
+        if (!recordPath.isEmpty())
+        {
+            sessionRecorder = new SessionRecorder();
+            if (!sessionRecorder->open(recordPath, static_cast<int>(cameraHandler->getDetectionMode()), cameraHandler->getDetectionPyramidLevel(),
+                                        CameraHandler::configuredCascadeSet()))
+            {
+                delete sessionRecorder;
+                sessionRecorder = nullptr;
+            }
+        }
+
+        // Camera frames are polled by simulationStep(); nothing in updateFrame() blocks
 
         qDebug() << "Camera initialized successfully";
     }
@@ -682,99 +792,155 @@ void GameWidget::initializeCamera()
     }
 }
 
-void GameWidget::updateFrame()
+void GameWidget::startDetection()
+{
+    if (!cameraInitialized || detectionWorker)
+    {
+        return;
+    }
+
+    // Hand detection runs on its own thread and publishes results as they complete
+    detectionWorker = new HandDetectionWorker(cameraHandler);
+    detectionWorker->start();
+}
+
+void GameWidget::updateFrame(QTime currentTime)
 {
     if (!cameraInitialized || !cameraHandler->isOpened())
     {
         return;
     }
 
-    // Get new frame from camera
-    if (cameraHandler->getFrame(currentFrame))
+    // Get the newest frame from the capture thread (never blocks) and hand it to detection
+    CapturedFrame frame;
+    if (cameraHandler->getLatestFrame(frame))
     {
-        cv::cvtColor(currentFrame, grayFrame, cv::COLOR_BGR2GRAY);
-        std::vector<cv::Point> detectedPoints = cameraHandler->detectFaces(currentFrame, grayFrame, false);
+        currentFrame = frame;
+        // Until the cascades are loaded the feed is only displayed
+        if (detectionWorker)
+        {
+            detectionWorker->submit(frame);
+        }
+    }
 
-        // S'assurer que hasProjectedPoint est mis à false si aucun point n'est détecté
-        hasProjectedPoint = false;
+    // Pick up the latest detection result, if any was published since the last tick
+    DetectionResult result;
+    bool freshDetection = false;
+    if (detectionWorker && detectionWorker->takeResult(result))
+    {
+        m_detection = std::move(result);
+        freshDetection = true;
+    }
 
-        for (const auto &point : detectedPoints)
+    // A new result is recorded once, with the collision tests made against it
+    const bool recording = freshDetection && sessionRecorder;
+    std::vector<SessionFrame::FruitCheck> checks;
+
+    // S'assurer que hasProjectedPoint est mis à false si aucun point n'est détecté
+    hasProjectedPoint = false;
+
+    // Drop the hand if detection has not confirmed it recently
+    const auto detectionAge = std::chrono::steady_clock::now() - m_detection.completedTime;
+    if (m_detection.points.empty() || detectionAge > std::chrono::milliseconds(200))
+    {
+        if (recording)
         {
-            float gameX, gameZ;
-            convertCameraPointToGameSpace(point, gameX, gameZ);
-            hasProjectedPoint = true; // Mettre à true quand un point est détecté et converti
+            recordDetection(checks);
+        }
+        return;
+    }
+
+    for (uint32_t pointIndex = 0; pointIndex < m_detection.points.size(); ++pointIndex)
+    {
+        const cv::Point &point = m_detection.points[pointIndex];
+        float gameX, gameZ;
+        convertCameraPointToGameSpace(point, gameX, gameZ);
+        hasProjectedPoint = true; // Mettre à true quand un point est détecté et converti
+        
+        // Check collision with fruits
+        for (auto it = m_fruit.begin(); it != m_fruit.end();) {
+            Fruit* fruit = *it;
             
-            // Check collision with fruits
-            QTime currentTime = QTime::currentTime();
-            for (auto it = m_fruit.begin(); it != m_fruit.end();) {
-                Fruit* fruit = *it;
-                
-                // Only check collision for fruits that are not already cut
-                if (!fruit->isCut()) {
-                    if (isFruitHit(point, fruit, currentTime)) {
-                        // Calculer un vecteur normal de coupe réaliste basé sur la direction du katana
-                        QVector3D fruitPos = fruit->getPosition(currentTime);
-                        QVector3D katanaToFruit = (fruitPos - projectedPoint).normalized();
-                        
-                        // Créer un vecteur normal de coupe qui dépend de la direction relative
-                        QVector3D normalVector;
-                        if (katanaToFruit.length() > 0.1f) {
-                            // Utiliser une direction de coupe perpendiculaire au mouvement
-                            normalVector = QVector3D(-katanaToFruit.z(), 0.2f, katanaToFruit.x()).normalized();
-                        } else {
-                            // Fallback vers un vecteur normal par défaut
-                            normalVector = QVector3D(1.0f, 0.2f, 0.0f).normalized();
-                        }
-                        
-                        // Cut the fruit using the calculated normal
-                        fruit->cut(projectedPoint, normalVector, currentTime);
-                        
-                        // Play sound and emit signal based on fruit type
-                        if (fruit->isBomb()) {
-                            qDebug() << "BOMB HIT! Life decreased.";
-                            m_shootSound->play();
-                            emit lifeDecrease();
-                        } else {
-                            qDebug() << "FRUIT HIT! Score increased.";
-                            m_sliceSound->play();
-                            emit scoreIncreased();
-                        }
-                        
-                        qDebug() << "Fruit successfully cut with normal:" << normalVector;
-                        break; // Une fois qu'un fruit est touché, on sort de la boucle
+            // Only check collision for fruits that are not already cut
+            if (!fruit->isCut()) {
+                bool hit = isFruitHit(point, fruit, currentTime);
+                if (recording) {
+                    checks.push_back({pointIndex, fruit->getPosition(currentTime), hit});
+                }
+                if (hit) {
+                    // Calculer un vecteur normal de coupe réaliste basé sur la direction du katana
+                    QVector3D fruitPos = fruit->getPosition(currentTime);
+                    QVector3D katanaToFruit = (fruitPos - projectedPoint).normalized();
+                    
+                    // Créer un vecteur normal de coupe qui dépend de la direction relative
+                    QVector3D normalVector;
+                    if (katanaToFruit.length() > 0.1f) {
+                        // Utiliser une direction de coupe perpendiculaire au mouvement
+                        normalVector = QVector3D(-katanaToFruit.z(), 0.2f, katanaToFruit.x()).normalized();
+                    } else {
+                        // Fallback vers un vecteur normal par défaut
+                        normalVector = QVector3D(1.0f, 0.2f, 0.0f).normalized();
                     }
-                } else {
-                    qDebug() << "Skipping already cut fruit";
+                    
+                    // The fruit's velocity per game second, carried over to its juice
+                    const QVector3D fruitVelocity = (fruit->getPosition(currentTime.addMSecs(VELOCITY_PROBE_MS)) - fruitPos) / GameGeometry::gameSeconds(VELOCITY_PROBE_MS);
+
+                    // Cut the fruit using the calculated normal
+                    fruit->cut(projectedPoint, normalVector, currentTime);
+                    particles.emitCut(fruitPos, normalVector, fruitVelocity, fruit->getType());
+                    
+                    // Play sound and emit signal based on fruit type
+                    if (fruit->isBomb()) {
+                        BIBLIO_LOG(Collision, "Bomb hit, life decreased");
+                        m_shootSound->play();
+                        emit lifeDecrease();
+                    } else {
+                        BIBLIO_LOG(Collision, "Fruit hit, score increased");
+                        m_sliceSound->play();
+                        emit scoreIncreased();
+                    }
+                    
+                    BIBLIO_LOG(Collision, "Fruit cut with normal (%.2f, %.2f, %.2f)", normalVector.x(), normalVector.y(), normalVector.z());
+                    break; // Une fois qu'un fruit est touché, on sort de la boucle
                 }
-                ++it;
+            } else {
+                BIBLIO_LOG(Collision, "Skipping already cut fruit");
             }
+            ++it;
         }
+    }
 
-        update();
+    if (recording)
+    {
+        recordDetection(checks);
     }
 }
 
-void GameWidget::convertCameraPointToGameSpace(const cv::Point &cameraPoint, float &gameX, float &gameZ)
+void GameWidget::recordDetection(const std::vector<SessionFrame::FruitCheck> &checks)
 {
-    // Get camera dimensions
-    int camWidth = currentFrame.cols;
-    int camHeight = currentFrame.rows;
-
-    // Map camera X coordinate to angle around cylinder (0 to π)
-    float angle = M_PI - ((float)cameraPoint.x / camWidth) * M_PI;
-
-    // Map camera Y coordinate to height on cylinder (0 to 4)
-    float cylinderHeight = 4.0f * (1.0f - (float)cameraPoint.y / camHeight);
-
-    // Set coordinates based on cylinder projection
-    gameX = cos(angle); // X coordinate on cylinder
-    gameZ = sin(angle); // Z coordinate on cylinder
+    SessionFrame frame;
+    frame.image = m_detection.gray;
+    frame.sequence = m_detection.frameSequence;
+    frame.captureTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(m_detection.captureTime - sessionRecorder->startTime()).count();
+    frame.detectionLatencyUs = std::chrono::duration_cast<std::chrono::microseconds>(m_detection.completedTime - m_detection.captureTime).count();
+    frame.points = m_detection.points;
+    frame.hasKatana = hasProjectedPoint;
+    frame.katanaPosition = projectedPoint;
+    frame.checks = checks;
+    frame.fullScan = m_detection.fullScan;
+    sessionRecorder->record(std::move(frame));
+}
 
+void GameWidget::convertCameraPointToGameSpace(const cv::Point &cameraPoint, float &gameX, float &gameZ)
+{
     // Store the projected point for visualization
-    projectedPoint = QVector3D(gameX, cylinderHeight, gameZ);
+    projectedPoint = GameGeometry::projectCameraPoint(cameraPoint, m_detection.frameSize);
     hasProjectedPoint = true;
 
-    qDebug() << "Projected point:" << projectedPoint.x() << projectedPoint.y() << projectedPoint.z();
+    gameX = projectedPoint.x(); // X coordinate on cylinder
+    gameZ = projectedPoint.z(); // Z coordinate on cylinder
+
+    BIBLIO_LOG(Projection, "Projected point: (%.2f, %.2f, %.2f)", projectedPoint.x(), projectedPoint.y(), projectedPoint.z());
 }
 
 bool GameWidget::isFruitHit(const cv::Point &point, Fruit *fruit, QTime currentTime)
@@ -786,92 +952,12 @@ bool GameWidget::isFruitHit(const cv::Point &point, Fruit *fruit, QTime currentT
     // Get fruit position
     QVector3D fruitPos = fruit->getPosition(currentTime);
 
-    // Position de la lame du katana avec une hitbox plus grande
-    float bladeTipY = projectedPoint.y() + 2.5f;  // Augmenté pour une meilleure portée verticale
-    float bladeBaseY = projectedPoint.y() - 0.8f; // Augmenté pour une meilleure portée vers le bas
-
-    // Distance horizontale entre le fruit et la lame
-    float dx = projectedPoint.x() - fruitPos.x();
-    float dz = projectedPoint.z() - fruitPos.z();
-    float horizontalDist = sqrt(dx * dx + dz * dz);
-
-    // Zone de détection verticale plus généreuse
-    bool isInBladeHeight = fruitPos.y() >= (bladeBaseY - 0.8f) && fruitPos.y() <= (bladeTipY + 0.8f);
-
-    // Hitbox horizontale beaucoup plus large
-    float hitboxRadius = 2.0f; // Augmenté significativement
-
-    // Debug des positions
-    qDebug() << "Fruit position:" << fruitPos;
-    // Get the blade positions in local coordinates
-    std::vector<QVector3D> localBladePoints = m_katana->getBladePosition();
-    
-    // Transform blade points to world coordinates using the same transformations as in draw()
-    std::vector<QVector3D> worldBladePoints;
-    
-    for (const auto& localPoint : localBladePoints) {
-        // Apply the same transformations as in Katana::draw()
-        QVector3D worldPoint = localPoint;
-        
-        // Apply scaling (0.6f from draw method)
-        worldPoint *= 0.6f;
-        
-        // Translate to katana position (projectedPoint)
-        worldPoint += projectedPoint;
-        
-        worldBladePoints.push_back(worldPoint);
-    }
-    
-    // Check collision with any point along the blade
-    const float hitRadius = 0.6f;
-    bool isHit = false;
-    float minDistance = std::numeric_limits<float>::max();
-    
-    // Check collision with blade edges (line segments)
-    for (size_t i = 0; i < worldBladePoints.size(); i++) {
-        QVector3D p1 = worldBladePoints[i];
-        QVector3D p2 = worldBladePoints[(i + 1) % worldBladePoints.size()];
-        
-        // Calculate distance from fruit to line segment
-        QVector3D lineDir = p2 - p1;
-        QVector3D fruitToP1 = fruitPos - p1;
-        
-        float lineLengthSq = QVector3D::dotProduct(lineDir, lineDir);
-        float t = 0.0f;
-        
-        if (lineLengthSq > 0.0001f) { // Avoid division by zero
-            t = QVector3D::dotProduct(fruitToP1, lineDir) / lineLengthSq;
-            t = qBound(0.0f, t, 1.0f); // Clamp to line segment
-        }
-        
-        QVector3D closestPoint = p1 + t * lineDir;
-        float distance = (fruitPos - closestPoint).length();
-        
-        if (distance < minDistance) {
-            minDistance = distance;
-        }
-        
-        if (distance <= hitRadius) {
-            isHit = true;
-            break;
-        }
-    }
-    
-    // Debug output
-    qDebug() << "=== COLLISION DEBUG ===";
-    qDebug() << "Camera point:" << point.x << "," << point.y;
-    qDebug() << "Katana position:" << projectedPoint;
-    qDebug() << "Distance:" << horizontalDist;
-    qDebug() << "Height check:" << isInBladeHeight;
+    // Same test as the session replay check, see GameGeometry
+    bool isHit = GameGeometry::isKatanaHit(projectedPoint, fruitPos);
 
-    // Vérification de la collision avec conditions plus souples
-    isHit = isInBladeHeight && horizontalDist < hitboxRadius && fruitPos.y() > 0.1f;
-
-    if (isHit)
-    {
-        qDebug() << "HIT!";
-    }
-    qDebug() << "========================";
+    BIBLIO_LOG(Collision, "Camera point (%d, %d), katana (%.2f, %.2f, %.2f), fruit (%.2f, %.2f, %.2f)%s",
+               point.x, point.y, projectedPoint.x(), projectedPoint.y(), projectedPoint.z(),
+               fruitPos.x(), fruitPos.y(), fruitPos.z(), isHit ? ": HIT" : "");
 
     return isHit;
 }
@@ -10,6 +10,13 @@
 #include <QWidget>
 #include <QOpenGLWidget>
 #include "fruit.h"
+#include "fruitmeshlibrary.h"
+#include "fruitrenderer.h"
+#include "particlesystem.h"
+#include "renderqueue.h"
+#include "glstatecache.h"
+#include "streamingtexture.h"
+#include "viewfrustum.h"
 #include <qlabel.h>
 #include <vector>
 #include <QColor>
@@ -19,6 +26,9 @@
 #include <QTimer>
 #include <QSoundEffect>
 #include "camerahandler.h"
+#include "assetloader.h"
+#include "handdetectionworker.h"
+#include "sessionrecorder.h"
 #include "cannon.h"
 #include <QKeyEvent>
 #include <QTime>
@@ -33,6 +43,9 @@ namespace Ui
 class GameWidget;
 }
 
+class GLResourceRegistry;
+class FrameScheduler;
+
 /**
  * @class GameWidget
  * @brief Gère la logique principale du jeu, l'affichage 3D et l'interaction avec la caméra.
@@ -48,9 +61,10 @@ class GameWidget : public QWidget
 public:
     /**
      * @brief Constructeur de GameWidget.
+     * @param assetLoader Chargement des textures, classificateurs et sons, déjà lancé. Doit survivre au widget.
      * @param parent Widget parent, nullptr par défaut.
      */
-    explicit GameWidget(QWidget *parent = nullptr);
+    explicit GameWidget(AssetLoader *assetLoader, QWidget *parent = nullptr);
 
     /**
      * @brief Destructeur de GameWidget.
@@ -59,10 +73,17 @@ public:
     ~GameWidget();
 
     /**
-     * @brief Met à jour l'affichage des fruits.
-     * Force l'actualisation de l'affichage des fruits à l'écran.
+     * @brief Pas de logique de jeu à fréquence fixe (FrameScheduler::step).
+     * Lit la caméra, teste les collisions et remplace les fruits tombés sous le sol.
+     * @param time Instant simulé du pas.
+     */
+    void simulationStep(QTime time);
+
+    /**
+     * @brief Indique si une partie précédente a déjà envoyé les textures au GPU, dans le groupe de contextes partagé.
+     * GameWindow ne fait alors pas charger les textures par son AssetLoader.
      */
-    void updateFruitDisplay();
+    static bool sharedTexturesUploaded();
 
 signals:
     /**
@@ -87,10 +108,38 @@ public slots:
 
     /**
      * @brief Initialise les textures utilisées dans le jeu.
-     * Charge les images pour les fruits, bombes, etc., et les prépare pour OpenGL.
+     * Reprend les textures du GLResourceRegistry si une partie précédente les a déjà envoyées, sinon les
+     * crée et les remplit dès que l'AssetLoader a chargé l'atlas : elles n'existent dans le registre qu'une fois remplies.
+     * Les images des objets sont des régions d'un même atlas (TextureAtlas), le sol a sa propre texture.
      */
     void initializeTextures();
 
+    /**
+     * @brief Crée les textures partagées et y envoie l'atlas et la page du sol chargés par l'AssetLoader. Nécessite le contexte OpenGL courant.
+     * @param resources Registre du contexte courant, propriétaire des textures.
+     */
+    void uploadTextures(GLResourceRegistry &resources);
+
+    /**
+     * @brief Donne les textures remplies aux objets de la scène (fruits, canon, katana, sol).
+     * @param atlasTexture Texture de l'atlas.
+     * @param floorTexture Texture du sol.
+     */
+    void applyTextures(GLuint atlasTexture, GLuint floorTexture);
+
+    /**
+     * @brief Reçoit une ressource chargée par l'AssetLoader (AssetLoader::assetLoaded).
+     * Envoie l'atlas dans le contexte OpenGL, installe les classificateurs ou les sons.
+     * @param asset Ressource chargée.
+     */
+    void onAssetLoaded(AssetLoader::Asset asset);
+
+    /**
+     * @brief Compile le décor fixe (sol, grille, cylindre autour du joueur, canon) dans des listes d'affichage.
+     * Les listes sont partagées par le groupe de contextes et compilées une seule fois.
+     */
+    void initializeSceneLists();
+
     /**
      * @brief Démarre un compte à rebours avant le début du jeu pour donner le
      * temps au joueur de se préparer et à OpenGL de s'initialiser.
@@ -115,30 +164,46 @@ public slots:
 
     /**
      * @brief Met à jour la frame de la caméra et traite les interactions.
-     * Ce slot est probablement connecté à un QTimer pour récupérer périodiquement
-     * une nouvelle image de la caméra et la traiter.
+     * Appelé à chaque pas de simulation pour récupérer la dernière image de la caméra et la traiter.
+     * @param currentTime Instant simulé du pas, utilisé pour les collisions.
      */
-    void updateFrame();
+    void updateFrame(QTime currentTime);
 
 private:
     Ui::GameWidget *ui;
+    AssetLoader *assetLoader; ///< Chargement parallèle des ressources, lancé par GameWindow.
+    bool texturesPending = false; ///< true si les textures attendent l'atlas de l'AssetLoader (la scène est dessinée sans texture).
     std::vector<Fruit *> m_fruit; ///< Conteneur pour tous les objets Fruit actifs dans le jeu.
-    GLuint *textures; ///< Tableau d'identifiants de texture OpenGL.
+    std::vector<Fruit *> visibleFruits; ///< Fruits dans le champ de la caméra à l'image courante (sous-ensemble de m_fruit).
+    ViewFrustum viewFrustum; ///< Volume visible de la caméra, mis à jour dans resizeGL().
+    static constexpr int TEXTURE_COUNT = 10; ///< Nombre de textures du jeu (AssetLoader::TEXTURE_COUNT).
+    GLuint textures[TEXTURE_COUNT] = {}; ///< Texture OpenGL de chaque image du jeu : l'atlas, ou la texture du sol (possédées par GLResourceRegistry).
+    QRectF textureRegions[TEXTURE_COUNT]; ///< Région de chaque image dans sa texture (coordonnées de texture).
+    FruitMeshLibrary fruitMeshes; ///< Maillages des fruits, envoyés au GPU dans initializeGL().
+    FruitRenderer fruitRenderer; ///< Dessin instancié des fruits (shaders), si disponible ; sinon Fruit::submit().
+    ParticleSystem particles; ///< Jus et débris projetés par les découpes, avancés à chaque pas de simulation.
+    RenderQueue renderQueue; ///< Éléments de l'image (canon, fruits, katana, particules, retour caméra), dessinés triés à la fin de paintGL().
+    GLStateCache stateCache; ///< État OpenGL connu pendant l'exécution de renderQueue.
     QFont m_font; ///< Police de caractères utilisée pour afficher du texte (ex: score, messages).
     QSoundEffect *m_sliceSound; ///< Effet sonore joué lorsqu'un fruit est coupé.
     QSoundEffect *m_shootSound; ///< Effet sonore joué lors d'un tir.
     QLabel *label; ///< QLabel utilisé pour afficher le score et les vies.
-    GLUquadric *cylinder; ///< Objet quadrique GLU.
+    GLuint groundList = 0; ///< Liste d'affichage du sol texturé et de sa grille (possédée par GLResourceRegistry).
+    GLuint arenaList = 0; ///< Liste d'affichage du cylindre autour du joueur (possédée par GLResourceRegistry).
     CameraHandler *cameraHandler; ///< Gestionnaire pour l'interaction avec la webcam.
-    QTimer *cameraTimer; ///< Timer pour déclencher la mise à jour périodique de la frame de la caméra.
-    cv::Mat currentFrame; ///< Image actuelle capturée par la caméra (en couleur).
+    FrameScheduler *frameScheduler = nullptr; ///< Boucle de rendu cadencée par la synchronisation verticale, avec logique à pas fixe.
+    HandDetectionWorker *detectionWorker = nullptr; ///< Thread de détection de main asynchrone.
+    DetectionResult m_detection; ///< Dernier résultat de détection reçu du thread de détection.
+    SessionRecorder *sessionRecorder = nullptr; ///< Enregistrement de la partie (option --record), nullptr sinon.
+    CapturedFrame currentFrame; ///< Dernière image capturée par la caméra (couleur reconstruite seulement si le flux est affiché).
     cv::Mat grayFrame; ///< Image actuelle capturée par la caméra (convertie en niveaux de gris).
-    bool cameraInitialized; ///< Indicateur de l'état d'initialisation de la caméra.
+    bool cameraInitialized = false; ///< Indicateur de l'état d'initialisation de la caméra.
     QVector3D projectedPoint; ///< Coordonnées 3D d'un point projeté (potentiellement depuis l'espace caméra vers l'espace jeu).
+    QVector3D previousProjectedPoint; ///< projectedPoint au pas précédent, pour interpoler la position dessinée du katana.
     bool hasProjectedPoint; ///< Indicateur de la disponibilité d'un point projeté.
     Cannon cannon; ///< Objet représentant le canon du joueur.
     bool displayCamera; ///< Indicateur pour afficher ou non le flux de la caméra à l'écran.
-    GLuint m_cameraTextureId; ///< Identifiant de texture OpenGL pour le flux vidéo de la caméra.
+    StreamingTexture m_cameraTexture; ///< Texture du flux vidéo de la caméra, envoyée seulement à chaque nouvelle image.
     Katana* m_katana = nullptr; ///< Objet représentant le katana du joueur.
 
     /**
@@ -149,19 +214,23 @@ private:
     void keyPressEvent(QKeyEvent *event) override;
 
     /**
-     * @brief Crée une texture OpenGL à partir d'une couleur unie.
-     * @param color Couleur de la texture à créer.
-     * @return QImage représentant la texture colorée.
-     * Utilisé comme fallback si le chargement d'une texture image échoue.
+     * @brief Termine le compte à rebours : retire le label et lance le premier fruit.
+     */
+    void launchFirstFruit();
+
+    /**
+     * @brief Dessine le retour caméra et les mains détectées en haut à gauche (passe Overlay de renderQueue).
+     * @param cache État OpenGL connu, pour passer au contour des mains sans texture.
      */
-    QImage createColorTexture(const QColor &color);
+    void drawCameraOverlay(GLStateCache &cache);
 
     /**
      * @brief Crée et initialise un nouvel objet Fruit.
+     * @param time Instant de lancement du fruit.
      * @return Pointeur vers le Fruit nouvellement créé.
      * Configure la position initiale, la vitesse, le type (fruit/bombe) du fruit.
      */
-    Fruit *createFruit();
+    Fruit *createFruit(QTime time);
 
     /**
      * @brief Initialise la caméra.
@@ -169,6 +238,11 @@ private:
      */
     void initializeCamera();
 
+    /**
+     * @brief Démarre le thread de détection de main, une fois la caméra ouverte et les classificateurs installés.
+     */
+    void startDetection();
+
     /**
      * @brief Vérifie si un point donné touche un fruit.
      * @param point Coordonnées du point d'interaction.
@@ -187,6 +261,12 @@ private:
      * @param gameZ Référence pour stocker la coordonnée Z résultante dans l'espace de jeu. (paramètre de sortie)
      */
     void convertCameraPointToGameSpace(const cv::Point &cameraPoint, float &gameX, float &gameZ);
+
+    /**
+     * @brief Ajoute le dernier résultat de détection à l'enregistrement de la partie.
+     * @param checks Tests de collision effectués avec ce résultat.
+     */
+    void recordDetection(const std::vector<SessionFrame::FruitCheck> &checks);
 };
 
 #endif // GAMEWIDGET_H
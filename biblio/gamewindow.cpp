@@ -13,11 +13,17 @@ GameWindow::GameWindow(QWidget *parent)
     , ui(new Ui::GameWindow)
 {
     ui->setupUi(this);
+    // Closed games release their camera, detection thread and GL context
+    setAttribute(Qt::WA_DeleteOnClose);
 
     if (!ui->game->layout()) {
         ui->game->setLayout(new QVBoxLayout());
     }
-    gameWidget = new GameWidget(this);
+    // Assets load in the background from now on, the countdown covers it. Textures uploaded by a previous game are reused
+    assetLoader = new AssetLoader(this);
+    assetLoader->start(!GameWidget::sharedTexturesUploaded());
+
+    gameWidget = new GameWidget(assetLoader, this);
     ui->game->layout()->addWidget(gameWidget);
     
     // Connect the scoreIncreased signal to a slot that updates the score
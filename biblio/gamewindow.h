@@ -9,6 +9,7 @@
 
 #include <QMainWindow>
 #include "gamewidget.h" 
+#include "assetloader.h"
 namespace Ui {
 class GameWindow;
 }
@@ -42,6 +43,7 @@ public:
 private:
     int lives = 3;          ///< Nombre de vies restantes pour le joueur. Initialisé à 3.
     int score = 0;          ///< Score actuel du joueur. Initialisé à 0.
+    AssetLoader* assetLoader; ///< Chargement parallèle des textures, classificateurs et sons, lancé à la construction.
     GameWidget* gameWidget; ///< Pointeur vers le widget principal du jeu (où se déroule l'action 3D).
     Ui::GameWindow *ui; ///< Pointeur vers l'objet d'interface utilisateur généré par Qt Designer.
 
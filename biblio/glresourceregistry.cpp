@@ -0,0 +1,205 @@
+#include "glresourceregistry.h"
+#include <QDebug>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <memory>
+#include <utility>
+#include <vector>
+
+QHash<QOpenGLContextGroup *, GLResourceRegistry *> GLResourceRegistry::registries;
+
+GLResourceRegistry::~GLResourceRegistry() = default;
+
+GLResourceRegistry &GLResourceRegistry::current()
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    Q_ASSERT(context);
+
+    GLResourceRegistry *&registry = registries[context->shareGroup()];
+    if (!registry)
+    {
+        registry = new GLResourceRegistry();
+    }
+
+    // Every context of the group keeps the resources alive, including Qt's global share context
+    for (QOpenGLContext *share : context->shareGroup()->shares())
+    {
+        registry->watch(share);
+    }
+    return *registry;
+}
+
+const GLResourceRegistry *GLResourceRegistry::find(QOpenGLContext *context)
+{
+    return context ? registries.value(context->shareGroup(), nullptr) : nullptr;
+}
+
+int GLResourceRegistry::registryCount()
+{
+    return registries.size();
+}
+
+GLuint GLResourceRegistry::createTexture(const QString &name, bool *created)
+{
+    GLuint &id = textures[name];
+    if (created)
+    {
+        *created = (id == 0);
+    }
+    if (id == 0)
+    {
+        glGenTextures(1, &id);
+    }
+    return id;
+}
+
+QOpenGLBuffer *GLResourceRegistry::buffer(const QString &name, bool *created, QOpenGLBuffer::Type type)
+{
+    if (created)
+    {
+        *created = false;
+    }
+    QOpenGLBuffer *existing = buffers.value(name, nullptr);
+    if (existing)
+    {
+        return existing;
+    }
+
+    auto newBuffer = std::make_unique<QOpenGLBuffer>(type);
+    if (!newBuffer->create())
+    {
+        qDebug() << "Could not create OpenGL buffer" << name;
+        return nullptr;
+    }
+    if (created)
+    {
+        *created = true;
+    }
+    buffers.insert(name, newBuffer.get());
+    return newBuffer.release();
+}
+
+GLuint GLResourceRegistry::displayList(const QString &name, bool *created)
+{
+    GLuint &list = displayLists[name];
+    if (created)
+    {
+        *created = (list == 0);
+    }
+    if (list == 0)
+    {
+        list = glGenLists(1);
+    }
+    return list;
+}
+
+GLUquadric *GLResourceRegistry::quadric(const QString &name)
+{
+    GLUquadric *&quadric = quadrics[name];
+    if (!quadric)
+    {
+        quadric = gluNewQuadric();
+        gluQuadricDrawStyle(quadric, GLU_FILL);
+        gluQuadricNormals(quadric, GLU_SMOOTH);
+    }
+    return quadric;
+}
+
+void GLResourceRegistry::watch(QOpenGLContext *context)
+{
+    if (watchedContexts.contains(context))
+    {
+        return;
+    }
+    watchedContexts.insert(context);
+    // Direct connection: the native context still exists while the signal is emitted
+    QObject::connect(context, &QOpenGLContext::aboutToBeDestroyed, context, [context]() {
+        contextAboutToBeDestroyed(context);
+    }, Qt::DirectConnection);
+}
+
+void GLResourceRegistry::contextAboutToBeDestroyed(QOpenGLContext *context)
+{
+    QOpenGLContextGroup *group = context->shareGroup();
+    auto it = registries.find(group);
+    if (it == registries.end())
+    {
+        return;
+    }
+    GLResourceRegistry *registry = it.value();
+    registry->watchedContexts.remove(context);
+
+    // Other contexts of the group still use the resources
+    if (group->shares().size() > 1)
+    {
+        return;
+    }
+
+    // Make the dying context current to delete its objects
+    QOpenGLContext *previousContext = QOpenGLContext::currentContext();
+    QSurface *previousSurface = previousContext ? previousContext->surface() : nullptr;
+    std::unique_ptr<QOffscreenSurface> offscreenSurface;
+    if (previousContext != context)
+    {
+        QSurface *surface = context->surface();
+        if (!surface)
+        {
+            offscreenSurface = std::make_unique<QOffscreenSurface>();
+            offscreenSurface->setFormat(context->format());
+            offscreenSurface->create();
+            surface = offscreenSurface.get();
+        }
+        context->makeCurrent(surface);
+    }
+
+    qDebug() << "Releasing OpenGL resources:" << registry->textureCount() << "textures," << registry->bufferCount() << "buffers,"
+             << registry->displayListCount() << "display lists," << registry->quadricCount() << "quadrics";
+    registry->releaseAll();
+    registries.erase(it);
+    delete registry;
+
+    if (previousContext != context)
+    {
+        context->doneCurrent();
+        if (previousContext && previousSurface)
+        {
+            previousContext->makeCurrent(previousSurface);
+        }
+    }
+}
+
+void GLResourceRegistry::releaseAll()
+{
+    std::vector<GLuint> textureIds;
+    for (GLuint id : std::as_const(textures))
+    {
+        textureIds.push_back(id);
+    }
+    if (!textureIds.empty())
+    {
+        glDeleteTextures(static_cast<GLsizei>(textureIds.size()), textureIds.data());
+    }
+    textures.clear();
+
+    for (QOpenGLBuffer *buffer : std::as_const(buffers))
+    {
+        buffer->destroy();
+        delete buffer;
+    }
+    buffers.clear();
+
+    for (GLuint list : std::as_const(displayLists))
+    {
+        if (list != 0)
+        {
+            glDeleteLists(list, 1);
+        }
+    }
+    displayLists.clear();
+
+    for (GLUquadric *quadric : std::as_const(quadrics))
+    {
+        gluDeleteQuadric(quadric);
+    }
+    quadrics.clear();
+}
@@ -0,0 +1,139 @@
+/**
+ * @file glresourceregistry.h
+ * @brief Déclaration de la classe GLResourceRegistry.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef GLRESOURCEREGISTRY_H
+#define GLRESOURCEREGISTRY_H
+
+#include <qopengl.h>
+#include <QHash>
+#include <QOpenGLBuffer>
+#include <QSet>
+#include <QString>
+#ifdef __APPLE__
+#include <OpenGL/glu.h>
+#else
+#include <GL/glu.h>
+#endif
+
+class QOpenGLContext;
+class QOpenGLContextGroup;
+
+/**
+ * @class GLResourceRegistry
+ * @brief Ressources OpenGL partagées (textures, tampons, listes d'affichage, quadriques GLU), nommées et créées une seule fois par contexte.
+ *
+ * Il existe un registre par groupe de contextes partagés (QOpenGLContextGroup) : avec
+ * Qt::AA_ShareOpenGLContexts, chaque nouvelle partie retrouve les textures et maillages déjà
+ * envoyés au GPU au lieu de les recharger. Toutes les ressources sont libérées, contexte courant,
+ * lorsque le dernier contexte du groupe est détruit.
+ *
+ * Les compteurs textureCount(), bufferCount(), displayListCount() et quadricCount() permettent de vérifier
+ * qu'une longue session ne fait pas grossir la mémoire.
+ */
+class GLResourceRegistry
+{
+public:
+    /**
+     * @brief Registre du groupe du contexte OpenGL courant, créé au premier appel.
+     * @return Référence vers le registre. Nécessite un contexte OpenGL courant.
+     */
+    static GLResourceRegistry &current();
+
+    /**
+     * @brief Registre existant du groupe d'un contexte, sans le créer. Ne nécessite pas de contexte courant.
+     * @param context Contexte OpenGL du groupe.
+     * @return Registre du groupe, nullptr si aucune ressource n'y a encore été créée.
+     */
+    static const GLResourceRegistry *find(QOpenGLContext *context);
+
+    /**
+     * @brief Nombre de registres vivants (un par groupe de contextes).
+     */
+    static int registryCount();
+
+    /**
+     * @brief Texture déjà créée sous ce nom.
+     * @param name Nom de la ressource.
+     * @return Identifiant de la texture, 0 si elle n'existe pas.
+     */
+    GLuint texture(const QString &name) const { return textures.value(name, 0); }
+
+    /**
+     * @brief Crée une texture sous ce nom, ou retourne celle qui existe déjà.
+     * @param name Nom de la ressource.
+     * @param created Mis à true si la texture vient d'être créée et doit être remplie. (paramètre de sortie, optionnel)
+     * @return Identifiant de la texture.
+     */
+    GLuint createTexture(const QString &name, bool *created = nullptr);
+
+    /**
+     * @brief Tampon OpenGL créé (QOpenGLBuffer::create()) sous ce nom, ou celui qui existe déjà.
+     * @param name Nom de la ressource.
+     * @param created Mis à true si le tampon vient d'être créé et doit être rempli. (paramètre de sortie, optionnel)
+     * @param type Type du tampon.
+     * @return Pointeur vers le tampon, possédé par le registre ; nullptr si la création a échoué.
+     */
+    QOpenGLBuffer *buffer(const QString &name, bool *created = nullptr, QOpenGLBuffer::Type type = QOpenGLBuffer::VertexBuffer);
+
+    /**
+     * @brief Liste d'affichage créée sous ce nom, ou celle qui existe déjà.
+     * @param name Nom de la ressource.
+     * @param created Mis à true si la liste vient d'être créée et doit être compilée. (paramètre de sortie, optionnel)
+     * @return Identifiant de la liste, 0 si la création a échoué.
+     */
+    GLuint displayList(const QString &name, bool *created = nullptr);
+
+    /**
+     * @brief Quadrique GLU créée sous ce nom, ou celle qui existe déjà.
+     * Chaque utilisateur qui modifie le style de dessin doit utiliser son propre nom.
+     * @param name Nom de la ressource.
+     * @return Pointeur vers la quadrique, possédée par le registre.
+     */
+    GLUquadric *quadric(const QString &name);
+
+    /** @brief Nombre de textures vivantes. */
+    int textureCount() const { return textures.size(); }
+
+    /** @brief Nombre de tampons vivants. */
+    int bufferCount() const { return buffers.size(); }
+
+    /** @brief Nombre de listes d'affichage vivantes. */
+    int displayListCount() const { return displayLists.size(); }
+
+    /** @brief Nombre de quadriques vivantes. */
+    int quadricCount() const { return quadrics.size(); }
+
+private:
+    GLResourceRegistry() = default;
+    ~GLResourceRegistry();
+
+    /**
+     * @brief Surveille la destruction d'un contexte du groupe.
+     * @param context Contexte à surveiller.
+     */
+    void watch(QOpenGLContext *context);
+
+    /**
+     * @brief Appelé juste avant la destruction d'un contexte du groupe ; libère tout s'il est le dernier.
+     * @param context Contexte sur le point d'être détruit.
+     */
+    static void contextAboutToBeDestroyed(QOpenGLContext *context);
+
+    /**
+     * @brief Libère toutes les ressources. Nécessite un contexte du groupe courant.
+     */
+    void releaseAll();
+
+    QHash<QString, GLuint> textures;            ///< Textures par nom.
+    QHash<QString, QOpenGLBuffer *> buffers;    ///< Tampons par nom.
+    QHash<QString, GLuint> displayLists;        ///< Listes d'affichage par nom.
+    QHash<QString, GLUquadric *> quadrics;      ///< Quadriques GLU par nom.
+    QSet<QOpenGLContext *> watchedContexts;     ///< Contextes du groupe dont la destruction est surveillée.
+
+    static QHash<QOpenGLContextGroup *, GLResourceRegistry *> registries; ///< Registre de chaque groupe de contextes.
+};
+
+#endif // GLRESOURCEREGISTRY_H
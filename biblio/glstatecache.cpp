@@ -0,0 +1,155 @@
+#include "glstatecache.h"
+#include "textureatlas.h"
+#include <algorithm>
+#include <cstring>
+
+// Constants
+const GLenum TRACKED_CAPABILITIES[] = {GL_LIGHTING, GL_DEPTH_TEST, GL_TEXTURE_2D, GL_BLEND, GL_COLOR_MATERIAL};
+
+bool GLStateCache::Material::operator==(const Material &other) const
+{
+    return std::equal(ambient, ambient + 4, other.ambient) && std::equal(diffuse, diffuse + 4, other.diffuse) &&
+           std::equal(specular, specular + 4, other.specular) && shininess == other.shininess;
+}
+
+int GLStateCache::capabilitySlot(GLenum capability)
+{
+    for (int i = 0; i < CAPABILITY_COUNT; ++i)
+    {
+        if (TRACKED_CAPABILITIES[i] == capability)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void GLStateCache::invalidate()
+{
+    std::fill(capabilities, capabilities + CAPABILITY_COUNT, -1);
+    textureKnown = false;
+    textureEnvKnown = false;
+    regionKnown = false;
+    materialKnown = false;
+    colorKnown = false;
+}
+
+void GLStateCache::setEnabled(GLenum capability, bool enabled)
+{
+    const int slot = capabilitySlot(capability);
+    if (slot >= 0 && capabilities[slot] == static_cast<int>(enabled))
+    {
+        ++count.skippedChanges;
+        return;
+    }
+
+    if (enabled)
+    {
+        glEnable(capability);
+    }
+    else
+    {
+        glDisable(capability);
+    }
+    if (slot >= 0)
+    {
+        capabilities[slot] = enabled;
+    }
+    if (capability == GL_COLOR_MATERIAL)
+    {
+        // Ambient and diffuse were following the color, or start to: what was sent for them no longer holds
+        materialKnown = false;
+    }
+    ++count.stateChanges;
+}
+
+void GLStateCache::bindTexture(GLuint texture)
+{
+    if (texture == 0)
+    {
+        // The binding is left as is, texturing is simply turned off
+        setEnabled(GL_TEXTURE_2D, false);
+        return;
+    }
+
+    if (textureKnown && boundTexture == texture)
+    {
+        ++count.skippedChanges;
+    }
+    else
+    {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        boundTexture = texture;
+        textureKnown = true;
+        ++count.stateChanges;
+    }
+
+    // The texture environment belongs to the texture unit, not to the texture
+    if (!textureEnvKnown)
+    {
+        glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        textureEnvKnown = true;
+        ++count.stateChanges;
+    }
+    setEnabled(GL_TEXTURE_2D, true);
+}
+
+void GLStateCache::setTextureRegion(const QRectF &region)
+{
+    if (regionKnown && textureRegion == region)
+    {
+        ++count.skippedChanges;
+        return;
+    }
+    TextureAtlas::loadTextureMatrix(region);
+    textureRegion = region;
+    regionKnown = true;
+    ++count.stateChanges;
+}
+
+void GLStateCache::setMaterialComponent(GLenum name, GLfloat *known, const GLfloat *value)
+{
+    if (materialKnown && std::equal(value, value + 4, known))
+    {
+        ++count.skippedChanges;
+        return;
+    }
+    glMaterialfv(GL_FRONT, name, value);
+    std::memcpy(known, value, 4 * sizeof(GLfloat));
+    ++count.stateChanges;
+}
+
+void GLStateCache::setMaterial(const Material &wanted)
+{
+    // With GL_COLOR_MATERIAL the current color replaces ambient and diffuse: sending them would be ignored
+    if (capabilities[capabilitySlot(GL_COLOR_MATERIAL)] != 1)
+    {
+        setMaterialComponent(GL_AMBIENT, material.ambient, wanted.ambient);
+        setMaterialComponent(GL_DIFFUSE, material.diffuse, wanted.diffuse);
+    }
+    setMaterialComponent(GL_SPECULAR, material.specular, wanted.specular);
+    if (materialKnown && material.shininess == wanted.shininess)
+    {
+        ++count.skippedChanges;
+    }
+    else
+    {
+        glMaterialf(GL_FRONT, GL_SHININESS, wanted.shininess);
+        material.shininess = wanted.shininess;
+        ++count.stateChanges;
+    }
+    materialKnown = true;
+}
+
+void GLStateCache::setColor(const GLfloat *rgba)
+{
+    if (colorKnown && std::equal(rgba, rgba + 4, color))
+    {
+        ++count.skippedChanges;
+        return;
+    }
+    glColor4fv(rgba);
+    std::memcpy(color, rgba, sizeof(color));
+    colorKnown = true;
+    ++count.stateChanges;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file glstatecache.h
+ * @brief Déclaration de la classe GLStateCache.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef GLSTATECACHE_H
+#define GLSTATECACHE_H
+
+#include <qopengl.h>
+#include <QRectF>
+
+/**
+ * @class GLStateCache
+ * @brief Dernier état envoyé au pipeline fixe (capacités, texture, matériau, couleur), pour ne pas renvoyer un état déjà en place.
+ *
+ * Chaque modification passe par le cache : elle n'est transmise à OpenGL que si elle change l'état
+ * connu, sinon elle est seulement comptée comme évitée. Après du code qui touche l'état sans passer
+ * par le cache (listes d'affichage, shaders, QPainter), invalidate() oublie tout ce qui était connu.
+ */
+class GLStateCache
+{
+public:
+    /**
+     * @struct Material
+     * @brief Propriétés du matériau des faces avant (GL_FRONT).
+     */
+    struct Material
+    {
+        GLfloat ambient[4] = {0.2f, 0.2f, 0.2f, 1.0f};  ///< Composante ambiante.
+        GLfloat diffuse[4] = {0.8f, 0.8f, 0.8f, 1.0f};  ///< Composante diffuse.
+        GLfloat specular[4] = {0.0f, 0.0f, 0.0f, 1.0f}; ///< Composante spéculaire.
+        GLfloat shininess = 0.0f;                       ///< Exposant de brillance spéculaire.
+
+        bool operator==(const Material &other) const;
+        bool operator!=(const Material &other) const { return !(*this == other); }
+    };
+
+    /**
+     * @struct Counters
+     * @brief Modifications d'état demandées depuis resetCounters().
+     */
+    struct Counters
+    {
+        int stateChanges = 0;   ///< Appels OpenGL effectivement passés.
+        int skippedChanges = 0; ///< Modifications évitées, l'état étant déjà en place.
+    };
+
+    /**
+     * @brief Oublie l'état connu : la modification suivante de chaque état sera envoyée.
+     */
+    void invalidate();
+
+    /**
+     * @brief Active ou désactive une capacité (glEnable, glDisable).
+     * GL_LIGHTING, GL_DEPTH_TEST, GL_TEXTURE_2D, GL_BLEND et GL_COLOR_MATERIAL sont suivies, les autres sont toujours envoyées.
+     * @param capability Capacité OpenGL.
+     * @param enabled true pour l'activer.
+     */
+    void setEnabled(GLenum capability, bool enabled);
+
+    /**
+     * @brief Lie une texture 2D et active le texturage (mode GL_MODULATE), ou le désactive.
+     * @param texture Texture à lier, 0 pour dessiner sans texture.
+     */
+    void bindTexture(GLuint texture);
+
+    /**
+     * @brief Charge la matrice de texture d'une région de l'atlas (TextureAtlas::loadTextureMatrix()).
+     * @param region Région de l'atlas, ou (0, 0, 1, 1) pour la texture entière.
+     */
+    void setTextureRegion(const QRectF &region);
+
+    /**
+     * @brief Applique un matériau ; seules les composantes qui changent sont envoyées.
+     * Quand GL_COLOR_MATERIAL est connu actif (setEnabled()), la couleur courante remplace les composantes
+     * ambiante et diffuse (GL_AMBIENT_AND_DIFFUSE) : seules la spéculaire et la brillance sont envoyées.
+     * @param material Matériau des faces avant.
+     */
+    void setMaterial(const Material &material);
+
+    /**
+     * @brief Définit la couleur courante (glColor4fv), suivie par le matériau avec GL_COLOR_MATERIAL.
+     * @param rgba Couleur RGBA.
+     */
+    void setColor(const GLfloat *rgba);
+
+    /**
+     * @brief Modifications comptées depuis le dernier resetCounters().
+     */
+    const Counters &counters() const { return count; }
+
+    /**
+     * @brief Remet les compteurs à zéro, au début de chaque image.
+     */
+    void resetCounters() { count = Counters(); }
+
+private:
+    static constexpr int CAPABILITY_COUNT = 5; ///< Capacités suivies.
+
+    int capabilities[CAPABILITY_COUNT] = {-1, -1, -1, -1, -1}; ///< État de chaque capacité suivie : 1 active, 0 inactive, -1 inconnu.
+    GLuint boundTexture = 0;            ///< Texture liée, si textureKnown.
+    bool textureKnown = false;          ///< false tant que la texture liée n'est pas connue.
+    bool textureEnvKnown = false;       ///< true une fois GL_MODULATE choisi depuis invalidate().
+    QRectF textureRegion;               ///< Région de la matrice de texture, si regionKnown.
+    bool regionKnown = false;           ///< false tant que la matrice de texture n'est pas connue.
+    Material material;                  ///< Matériau envoyé, si materialKnown.
+    bool materialKnown = false;         ///< false tant que le matériau n'est pas connu.
+    GLfloat color[4] = {};              ///< Couleur courante, si colorKnown.
+    bool colorKnown = false;            ///< false tant que la couleur courante n'est pas connue.
+    Counters count;                     ///< Modifications de l'image en cours.
+
+    /**
+     * @brief Indice d'une capacité suivie, -1 si elle ne l'est pas.
+     */
+    static int capabilitySlot(GLenum capability);
+
+    /**
+     * @brief Envoie une composante du matériau si elle diffère de celle connue.
+     * @param name GL_AMBIENT, GL_DIFFUSE ou GL_SPECULAR.
+     * @param known Valeur connue, remplacée.
+     * @param value Valeur voulue.
+     */
+    void setMaterialComponent(GLenum name, GLfloat *known, const GLfloat *value);
+};
+
+#endif // GLSTATECACHE_H
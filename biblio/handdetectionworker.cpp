@@ -0,0 +1,109 @@
+#include "handdetectionworker.h"
+#include <opencv2/imgproc.hpp>
+
+HandDetectionWorker::HandDetectionWorker(CameraHandler *cameraHandler)
+    : cameraHandler(cameraHandler)
+{
+}
+
+HandDetectionWorker::~HandDetectionWorker()
+{
+    stop();
+}
+
+void HandDetectionWorker::start()
+{
+    if (thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(inputMutex);
+        stopping = false;
+    }
+    thread = std::thread(&HandDetectionWorker::run, this);
+}
+
+void HandDetectionWorker::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(inputMutex);
+        stopping = true;
+    }
+    inputReady.notify_one();
+
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+void HandDetectionWorker::submit(const CapturedFrame &frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(inputMutex);
+        if (hasPendingFrame)
+        {
+            // The previous frame was never picked up: latest frame wins
+            skippedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+        pendingFrame = frame;
+        hasPendingFrame = true;
+    }
+    inputReady.notify_one();
+}
+
+bool HandDetectionWorker::takeResult(DetectionResult &result)
+{
+    if (!results.update())
+    {
+        return false;
+    }
+    result = results.readBuffer();
+    return true;
+}
+
+void HandDetectionWorker::run()
+{
+    CapturedFrame frame;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(inputMutex);
+            inputReady.wait(lock, [this]() { return stopping || hasPendingFrame; });
+            if (stopping)
+            {
+                return;
+            }
+            frame = std::move(pendingFrame);
+            hasPendingFrame = false;
+        }
+
+        // Luma capture already delivers the Y plane; only BGR frames need converting.
+        // Converted into a fresh buffer each time: the result hands this image out
+        cv::Mat gray = frame.gray;
+        if (gray.empty())
+        {
+            cv::cvtColor(frame.image, gray, cv::COLOR_BGR2GRAY);
+        }
+
+        DetectionResult &result = results.writeBuffer();
+        result.rects = cameraHandler->detectHands(gray);
+        result.fullScan = cameraHandler->lastDetectionWasFullScan();
+        result.points.clear();
+        for (const auto &rect : result.rects)
+        {
+            result.points.emplace_back(rect.x + rect.width / 2, rect.y + rect.height / 2);
+        }
+        result.frameSize = gray.size();
+        result.gray = gray;
+        result.frameSequence = frame.sequence;
+        result.captureTime = frame.captureTime;
+        result.completedTime = std::chrono::steady_clock::now();
+        results.publish();
+
+        processedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+}
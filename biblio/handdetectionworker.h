@@ -0,0 +1,118 @@
+/**
+ * @file handdetectionworker.h
+ * @brief Déclaration de la classe HandDetectionWorker.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef HANDDETECTIONWORKER_H
+#define HANDDETECTIONWORKER_H
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "camerahandler.h"
+#include "triplebuffer.h"
+
+/**
+ * @struct DetectionResult
+ * @brief Résultat d'une détection de main, publié par le thread de détection.
+ */
+struct DetectionResult
+{
+    std::vector<cv::Point> points;                         ///< Centres des mains détectées (coordonnées de l'image source).
+    std::vector<cv::Rect> rects;                           ///< Rectangles englobants des mains détectées.
+    cv::Size frameSize;                                    ///< Dimensions de l'image source.
+    cv::Mat gray;                                          ///< Image analysée (niveaux de gris), partagée et jamais réécrite.
+    uint64_t frameSequence = 0;                            ///< Numéro de séquence de l'image source.
+    bool fullScan = false;                                 ///< Détection sur toute l'image (CameraHandler::lastDetectionWasFullScan()).
+    std::chrono::steady_clock::time_point captureTime;     ///< Instant de capture de l'image source.
+    std::chrono::steady_clock::time_point completedTime;   ///< Instant de fin de la détection.
+};
+
+/**
+ * @class HandDetectionWorker
+ * @brief Exécute la détection de main sur un thread dédié, hors du thread graphique.
+ *
+ * Le thread de jeu soumet les images au fil de l'eau : seule la plus récente est conservée
+ * ("la dernière image gagne"), les précédentes non traitées sont abandonnées. Les résultats
+ * sont déposés dans une boîte aux lettres non bloquante (tampon triple) que le thread de jeu
+ * consulte à chaque mise à jour. La détection tourne donc au rythme que permet le processeur
+ * sans jamais ralentir le rendu ni les collisions.
+ */
+class HandDetectionWorker
+{
+public:
+    /**
+     * @brief Constructeur de HandDetectionWorker.
+     * @param cameraHandler Gestionnaire de caméra dont le classificateur est utilisé. Doit survivre au worker.
+     */
+    explicit HandDetectionWorker(CameraHandler *cameraHandler);
+
+    /**
+     * @brief Destructeur de HandDetectionWorker.
+     * Arrête le thread de détection.
+     */
+    ~HandDetectionWorker();
+
+    /**
+     * @brief Démarre le thread de détection.
+     */
+    void start();
+
+    /**
+     * @brief Arrête le thread de détection et attend sa fin.
+     */
+    void stop();
+
+    /**
+     * @brief Soumet une image à la détection, sans bloquer.
+     * Remplace l'image en attente si le thread n'a pas encore commencé à la traiter.
+     * @param frame Image capturée à analyser.
+     */
+    void submit(const CapturedFrame &frame);
+
+    /**
+     * @brief Récupère le dernier résultat publié, sans bloquer.
+     * @param result Résultat de détection. (paramètre de sortie)
+     * @return true si un résultat plus récent que la précédente lecture est disponible.
+     */
+    bool takeResult(DetectionResult &result);
+
+    /**
+     * @brief Nombre d'images analysées depuis le démarrage.
+     * @return Compteur d'images traitées.
+     */
+    uint64_t processedCount() const { return processedFrames.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Nombre d'images remplacées avant d'avoir été analysées.
+     * @return Compteur d'images abandonnées.
+     */
+    uint64_t skippedCount() const { return skippedFrames.load(std::memory_order_relaxed); }
+
+private:
+    CameraHandler *cameraHandler;               ///< Gestionnaire de caméra fournissant le classificateur.
+    std::thread thread;                         ///< Thread de détection.
+
+    std::mutex inputMutex;                      ///< Protège pendingFrame, hasPendingFrame et stopping.
+    std::condition_variable inputReady;         ///< Réveille le thread lorsqu'une image est soumise.
+    CapturedFrame pendingFrame;                 ///< Dernière image soumise, en attente d'analyse.
+    bool hasPendingFrame = false;               ///< Indique qu'une image attend d'être analysée.
+    bool stopping = false;                      ///< Demande d'arrêt du thread.
+
+    TripleBuffer<DetectionResult> results;      ///< Boîte aux lettres des résultats.
+    std::atomic<uint64_t> processedFrames{0};   ///< Nombre d'images analysées.
+    std::atomic<uint64_t> skippedFrames{0};     ///< Nombre d'images abandonnées.
+
+    /**
+     * @brief Boucle du thread de détection.
+     */
+    void run();
+};
+
+#endif // HANDDETECTIONWORKER_H
@@ -12,41 +12,52 @@ Katana::~Katana() {
     }
 }
 
-void Katana::draw(const QVector3D& position) {
-    glPushMatrix();
-    
+void Katana::submit(RenderQueue &queue, const QVector3D& position) {
+    QMatrix4x4 model;
+
     // Positionner le katana
-    glTranslatef(position.x(), position.y(), position.z());
-    
+    model.translate(position);
+
     // Rotation pour une meilleure orientation
-    glRotatef(-45.0f, 0.0f, 1.0f, 0.0f);
-    glRotatef(30.0f, 1.0f, 0.0f, 0.0f);
-    
+    model.rotate(-45.0f, 0.0f, 1.0f, 0.0f);
+    model.rotate(30.0f, 1.0f, 0.0f, 0.0f);
+
     // Échelle globale réduite (changé de 0.8f à 0.6f)
-    glScalef(0.6f, 0.6f, 0.6f);
-    
-    // Dessiner la lame
-    drawBlade();
+    model.scale(0.6f);
 
-    // Dessiner le tsuba (garde-bout)
-    drawHandle();
+    // Lame droite et argentée
+    RenderQueue::State blade = partState(0, {0.8f, 0.8f, 0.8f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, 100.0f);
+    queue.submit(RenderQueue::Opaque, model, blade, [this](GLStateCache &) { drawBlade(); });
 
-    // Dessiner la chaîne
-    drawChain();
+    // Tsuba (garde) : métal foncé, mêmes reflets que la lame
+    RenderQueue::State tsuba = partState(1, {0.4f, 0.4f, 0.4f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, 100.0f);
+    queue.submit(RenderQueue::Opaque, model, tsuba, [this](GLStateCache &) { drawTsuba(); });
 
-    glPopMatrix();
+    // Manche en bois
+    RenderQueue::State handle = partState(1, {0.5f, 0.3f, 0.1f, 1.0f}, {0.8f, 0.5f, 0.2f, 1.0f}, 50.0f);
+    queue.submit(RenderQueue::Opaque, model, handle, [this](GLStateCache &) { drawHandle(); });
+
+    // Chaîne gris métallique
+    RenderQueue::State chain = partState(2, {0.3f, 0.3f, 0.3f, 1.0f}, {0.8f, 0.8f, 0.8f, 1.0f}, 50.0f);
+    queue.submit(RenderQueue::Opaque, model, chain, [this](GLStateCache &) { drawChain(); });
 }
 
+RenderQueue::State Katana::partState(int index, const QVector4D &ambientAndDiffuse, const QVector4D &specular, GLfloat shininess) const {
+    RenderQueue::State state;
+    // The parts have no texture coordinates: they sample the middle of this texture's region of the atlas
+    state.texture = textures[index];
+    state.textureRegion = textureRegions[index];
+    for (int i = 0; i < 4; ++i) {
+        state.material.ambient[i] = ambientAndDiffuse[i];
+        state.material.diffuse[i] = ambientAndDiffuse[i];
+        state.material.specular[i] = specular[i];
+    }
+    state.material.shininess = shininess;
+    return state;
+}
 
 void Katana::drawChain(void) {
-    GLfloat chain_ambient[] = {0.3f, 0.3f, 0.3f, 1.0f};  // Couleur gris métallique
-    GLfloat chain_specular[] = {0.8f, 0.8f, 0.8f, 1.0f}; // Reflets métalliques
-    glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, chain_ambient);
-    glMaterialfv(GL_FRONT, GL_SPECULAR, chain_specular);
-    glMaterialf(GL_FRONT, GL_SHININESS, 50.0f);
-
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, textures[2]); 
+    glTexCoord2f(0.5f, 0.5f);
 
     // Position de départ de la chaîne (au bout du manche)
     float startX = 0.0f;
@@ -80,7 +91,6 @@ void Katana::drawChain(void) {
         }
         glPopMatrix();
     }
-    glDisable(GL_TEXTURE_2D);
     glPopMatrix();
 }
 
@@ -89,15 +99,9 @@ void Katana::drawChain(void) {
 void Katana::drawBlade() {
     
     // 1. Dessiner la lame (droite et argentée)
-    GLfloat blade_ambient[] = {0.8f, 0.8f, 0.8f, 1.0f};
-    GLfloat blade_specular[] = {1.0f, 1.0f, 1.0f, 1.0f};
-    glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, blade_ambient);
-    glMaterialfv(GL_FRONT, GL_SPECULAR, blade_specular);
-    glMaterialf(GL_FRONT, GL_SHININESS, 100.0f);
-
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, textures[0]); // Texture pour la lame
-    
+    glTexCoord2f(0.5f, 0.5f);
+
+
     // Lame droite
     glBegin(GL_QUADS);
     // Face avant
@@ -144,46 +148,31 @@ void Katana::drawBlade() {
     glVertex3f(0.05f, 2.0f, 0.01f);
     glVertex3f(-0.05f, 2.2f, 0.0f);     // Pointe (alignée avec le côté gauche)
     glEnd();
-
-    glDisable(GL_TEXTURE_2D);
-
 }
 
-void Katana::drawHandle() {
+void Katana::drawTsuba() {
     // 2. Dessiner le tsuba (garde-bout)
-    GLfloat tsuba_ambient[] = {0.4f, 0.4f, 0.4f, 1.0f}; // Couleur métallique foncée
-    glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, tsuba_ambient);
-        
-    glPushMatrix();
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, textures[1]); // Texture pour le tsuba
+    glTexCoord2f(0.5f, 0.5f);
 
+    glPushMatrix();
     glTranslatef(0.0f, 0.0f, 0.0f);
     glRotatef(90.0f, 1.0f, 0.0f, 0.0f);
     gluDisk(quadric, 0.0f, 0.2f, 32, 1);    // Face avant
     glTranslatef(0.0f, 0.0f, 0.02f);
     gluDisk(quadric, 0.0f, 0.2f, 32, 1);    // Face arrière
     gluCylinder(quadric, 0.2f, 0.2f, 0.02f, 32, 1); // Bord
-
-    glDisable(GL_TEXTURE_2D);
     glPopMatrix();
+}
 
-
+void Katana::drawHandle() {
     // 3. Dessiner le manche (cylindrique)
-    GLfloat handle_ambient[] = {0.5f, 0.3f, 0.1f, 1.0f}; // Couleur bois
-    GLfloat handle_specular[] = {0.8f, 0.5f, 0.2f, 1.0f}; // Reflets bois
-    glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, handle_ambient);
-    glMaterialfv(GL_FRONT, GL_SPECULAR, handle_specular);
-    glMaterialf(GL_FRONT, GL_SHININESS, 50.0f);
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, textures[1]); // Texture pour le manche
+    glTexCoord2f(0.5f, 0.5f);
+
     glPushMatrix();
     glTranslatef(0.0f, 0.0f, 0.0f); // Positionner le manche
     glRotatef(90.0f, 1.0f, 0.0f, 0.0f); // Rotation pour aligner le cylindre
     gluCylinder(quadric, 0.05f, 0.05f, 0.6f, 32, 1); // Dessiner le manche
-    glDisable(GL_TEXTURE_2D);
     glPopMatrix();
-    
 }
 
 std::vector<QVector3D> Katana::getBladePosition() {
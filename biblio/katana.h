@@ -13,8 +13,11 @@
 #include <GL/glu.h>
 #endif
 
+#include <QRectF>
 #include <QVector3D>
+#include <QVector4D>
 #include <vector>
+#include "renderqueue.h"
 
 /**
  * @class Katana
@@ -41,10 +44,11 @@ public:
     ~Katana();
 
     /**
-     * @brief Dessine le katana à la position spécifiée.
+     * @brief Soumet le katana à la file de rendu, une partie par élément (lame, tsuba, manche, chaîne).
+     * @param queue File de rendu de l'image.
      * @param position Position 3D où le katana doit être dessiné.
      */
-    void draw(const QVector3D& position);
+    void submit(RenderQueue &queue, const QVector3D& position);
 
     /**
      * @brief Définit les textures du katana.
@@ -52,6 +56,14 @@ public:
      */
     void setTextures(GLuint blade, GLuint handle, GLuint chain) { textures[0] = blade; textures[1] = handle; textures[2] = chain; } 
 
+    /**
+     * @brief Définit la région de chaque image du katana dans sa texture (atlas).
+     * @param blade Région de l'image de la lame.
+     * @param handle Région de l'image du manche.
+     * @param chain Région de l'image de la chaîne.
+     */
+    void setTextureRegions(const QRectF &blade, const QRectF &handle, const QRectF &chain) { textureRegions[0] = blade; textureRegions[1] = handle; textureRegions[2] = chain; }
+
     /**
      * @brief renvoie la position de la lame du katana.
      * @return Vecteur de positions de la lame.
@@ -64,6 +76,11 @@ private:
      */
     void drawBlade();
 
+    /**
+     * @brief Dessine le tsuba (garde) du katana.
+     */
+    void drawTsuba();
+
     /**
      * @brief Dessine le manche du katana.
      */
@@ -73,6 +90,17 @@ private:
      * @brief Dessine la chaîne ou un élément décoratif du katana.
      */
     void drawChain();
+
+    /**
+     * @brief État de dessin d'une partie : texture et région de l'atlas, matériau, couleur blanche.
+     * @param index Indice dans textures (0 lame, 1 manche, 2 chaîne).
+     * @param ambientAndDiffuse Composantes ambiante et diffuse du matériau.
+     * @param specular Composante spéculaire du matériau.
+     * @param shininess Exposant de brillance spéculaire.
+     */
+    RenderQueue::State partState(int index, const QVector4D &ambientAndDiffuse, const QVector4D &specular, GLfloat shininess) const;
+
+    QRectF textureRegions[3] = {QRectF(0, 0, 1, 1), QRectF(0, 0, 1, 1), QRectF(0, 0, 1, 1)}; ///< Région de chaque texture dans l'atlas.
     GLUquadric* quadric; ///< Objet quadrique GLU utilisé pour dessiner les parties cylindriques du katana.
 };
 
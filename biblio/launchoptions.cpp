@@ -0,0 +1,109 @@
+#include "launchoptions.h"
+#include <QCommandLineParser>
+#include <QDebug>
+#include <algorithm>
+
+static LaunchOptions launchOptions;
+
+void LaunchOptions::parse(const QStringList &arguments)
+{
+    LaunchOptions options;
+
+    // Environment first, so command-line arguments override it
+    options.source = qEnvironmentVariable("BIBLIO_SOURCE");
+    bool ok = false;
+    double rate = qEnvironmentVariable("BIBLIO_SOURCE_RATE").toDouble(&ok);
+    if (ok)
+    {
+        options.sourceRate = rate;
+    }
+    double fps = qEnvironmentVariable("BIBLIO_SOURCE_FPS").toDouble(&ok);
+    if (ok && fps > 0.0)
+    {
+        options.sourceFps = fps;
+    }
+    options.sourceLoop = qEnvironmentVariable("BIBLIO_SOURCE_LOOP") == "1";
+    options.recordPath = qEnvironmentVariable("BIBLIO_RECORD");
+    if (qEnvironmentVariableIsSet("BIBLIO_RENDERER"))
+    {
+        options.renderer = qEnvironmentVariable("BIBLIO_RENDERER");
+    }
+    options.assets = qEnvironmentVariable("BIBLIO_ASSETS");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Biblio");
+    parser.addHelpOption();
+    QCommandLineOption sourceOption("source", "Video file or directory of images to use instead of the camera.", "path");
+    QCommandLineOption rateOption("source-rate", "Playback rate multiplier for --source (0: every frame, no waiting).", "rate");
+    QCommandLineOption fpsOption("source-fps", "Frame rate of an image directory given to --source.", "fps");
+    QCommandLineOption loopOption("source-loop", "Restart --source from the beginning when it ends.");
+    QCommandLineOption recordOption("record", "Record camera frames, detections and collisions to a session file.", "file");
+    QCommandLineOption verifyOption("replay-verify", "Replay a session file through detection and collisions, report differences and exit.", "file");
+    QCommandLineOption rendererOption("renderer", "Fruit renderer: instanced (shaders, OpenGL 3.3) or fixed (fixed-function pipeline).", "name");
+    QCommandLineOption assetsOption("assets", "Packed asset archive (.rcc) or asset directory to load the game data from.", "path");
+    parser.addOptions({sourceOption, rateOption, fpsOption, loopOption, recordOption, verifyOption, rendererOption, assetsOption});
+
+    // parse() instead of process(): do not exit on arguments added by the platform
+    if (!parser.parse(arguments))
+    {
+        qDebug() << "Ignoring command line:" << parser.errorText();
+    }
+    if (parser.isSet("help"))
+    {
+        parser.showHelp();
+    }
+
+    if (parser.isSet(sourceOption))
+    {
+        options.source = parser.value(sourceOption);
+    }
+    if (parser.isSet(rateOption))
+    {
+        rate = parser.value(rateOption).toDouble(&ok);
+        if (ok)
+        {
+            options.sourceRate = rate;
+        }
+    }
+    if (parser.isSet(fpsOption))
+    {
+        fps = parser.value(fpsOption).toDouble(&ok);
+        if (ok && fps > 0.0)
+        {
+            options.sourceFps = fps;
+        }
+    }
+    if (parser.isSet(loopOption))
+    {
+        options.sourceLoop = true;
+    }
+    if (parser.isSet(recordOption))
+    {
+        options.recordPath = parser.value(recordOption);
+    }
+    if (parser.isSet(verifyOption))
+    {
+        options.replayVerifyPath = parser.value(verifyOption);
+    }
+    if (parser.isSet(rendererOption))
+    {
+        options.renderer = parser.value(rendererOption);
+    }
+    if (parser.isSet(assetsOption))
+    {
+        options.assets = parser.value(assetsOption);
+    }
+    if (options.renderer != "instanced" && options.renderer != "fixed")
+    {
+        qDebug() << "Unknown renderer" << options.renderer << "- using instanced";
+        options.renderer = "instanced";
+    }
+    options.sourceRate = std::max(0.0, options.sourceRate);
+
+    launchOptions = options;
+}
+
+const LaunchOptions &LaunchOptions::get()
+{
+    return launchOptions;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file launchoptions.h
+ * @brief Déclaration de la structure LaunchOptions.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef LAUNCHOPTIONS_H
+#define LAUNCHOPTIONS_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @struct LaunchOptions
+ * @brief Options de lancement lues sur la ligne de commande et dans l'environnement.
+ *
+ * Chaque option peut être donnée par un argument (prioritaire) ou par une variable d'environnement,
+ * ce qui permet de lancer le jeu sans caméra sur une machine d'intégration continue :
+ * @code
+ * biblio --source session.mp4 --source-rate 0
+ * BIBLIO_SOURCE=frames/ BIBLIO_SOURCE_LOOP=1 biblio
+ * biblio --record salle.bses
+ * biblio --replay-verify salle.bses
+ * biblio --renderer fixed
+ * biblio --assets /opt/biblio/assets.rcc
+ * @endcode
+ */
+struct LaunchOptions
+{
+    QString source;             ///< Fichier vidéo ou dossier d'images remplaçant la caméra (--source, BIBLIO_SOURCE) ; vide pour la caméra.
+    double sourceRate = 1.0;    ///< Multiplicateur de cadence de la source (--source-rate, BIBLIO_SOURCE_RATE) ; 0 pour livrer chaque image sans attente.
+    double sourceFps = 30.0;    ///< Cadence d'origine d'une séquence d'images (--source-fps, BIBLIO_SOURCE_FPS).
+    bool sourceLoop = false;    ///< Rejoue la source en boucle (--source-loop, BIBLIO_SOURCE_LOOP=1).
+    QString recordPath;         ///< Enregistre la partie dans ce fichier (--record, BIBLIO_RECORD) ; vide pour ne rien enregistrer.
+    QString replayVerifyPath;   ///< Rejoue cet enregistrement sans interface et compare les résultats (--replay-verify).
+    QString renderer = "instanced"; ///< Dessin des fruits (--renderer, BIBLIO_RENDERER) : "instanced" (shaders, si OpenGL 3.3) ou "fixed" (pipeline fixe).
+    QString assets;             ///< Archive (.rcc) ou dossier des ressources (--assets, BIBLIO_ASSETS) ; vide pour les chercher près de l'exécutable (AssetRegistry).
+
+    /**
+     * @brief Lit les options à partir des arguments du programme et de l'environnement.
+     * Les arguments inconnus sont ignorés (par exemple ceux ajoutés par macOS au lancement d'un bundle).
+     * @param arguments Arguments du programme (QCoreApplication::arguments()).
+     */
+    static void parse(const QStringList &arguments);
+
+    /**
+     * @brief Options lues par parse() (valeurs par défaut si parse() n'a pas été appelée).
+     * @return Référence vers les options du processus.
+     */
+    static const LaunchOptions &get();
+};
+
+#endif // LAUNCHOPTIONS_H
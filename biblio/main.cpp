@@ -1,10 +1,29 @@
 #include "mainwindow.h"
+#include "launchoptions.h"
+#include "sessionrecorder.h"
 
 #include <QApplication>
+#include <QSurfaceFormat>
 
 int main(int argc, char *argv[])
 {
+    // Game windows share one set of textures and meshes (see GLResourceRegistry)
+    QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+    // Buffer swaps wait for vsync: FrameScheduler paces the game on them
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    format.setSwapInterval(1);
+    QSurfaceFormat::setDefaultFormat(format);
     QApplication a(argc, argv);
+    // Identifies the QSettings store (capture profile chosen in the settings window)
+    QCoreApplication::setOrganizationName("Biblio");
+    QCoreApplication::setApplicationName("biblio");
+    // --source and friends replace the camera with a recorded input
+    LaunchOptions::parse(a.arguments());
+    // Headless regression check of a recorded session
+    if (!LaunchOptions::get().replayVerifyPath.isEmpty())
+    {
+        return SessionReplay::verify(LaunchOptions::get().replayVerifyPath);
+    }
     MainWindow w;
     w.show();
     return a.exec();
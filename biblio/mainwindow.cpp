@@ -2,9 +2,8 @@
 #include "ui_mainwindow.h"
 #include "gamewindow.h"
 #include "settingswindow.h"
-#include <QDir>
+#include "assetregistry.h"
 #include <QDebug>
-#include <QCoreApplication>
 #include <QDesktopServices>
 #include <QUrl>
 #include <QMessageBox>
@@ -16,26 +15,8 @@ MainWindow::MainWindow(QWidget *parent)
     ui->setupUi(this);
 
     // Charger la police personnalisée
-    QStringList possibleFontPaths = {
-        QCoreApplication::applicationDirPath() + "/../../../biblio/assets/fonts/NinjaStrike.otf",
-        "./assets/fonts/NinjaStrike.otf",
-        "../assets/fonts/NinjaStrike.otf",
-        "../../assets/fonts/NinjaStrike.otf",
-        "../../../assets/fonts/NinjaStrike.otf"
-    };
-
-    QString fontPath;
-    bool foundFontPath = false;
-    for (const auto &path : possibleFontPaths) {
-        if (QFile::exists(path)) {
-            fontPath = path;
-            foundFontPath = true;
-            qDebug() << "Found font path: " << fontPath;
-            break;
-        }
-    }
-
-    if (foundFontPath) {
+    const QString fontPath = AssetRegistry::get().path("NinjaStrike.otf");
+    if (!fontPath.isEmpty()) {
         int fontId = QFontDatabase::addApplicationFont(fontPath);
         if (fontId != -1) {
             QStringList fontFamilies = QFontDatabase::applicationFontFamilies(fontId);
@@ -51,42 +32,18 @@ MainWindow::MainWindow(QWidget *parent)
             qWarning() << "Failed to load font from" << fontPath;
         }
     } else {
-        qWarning() << "NinjaStrike.otf font file not found. Tried paths:";
-        for (const auto &path : possibleFontPaths) {
-            qWarning() << " - " << path;
-        }
+        qWarning() << "NinjaStrike.otf font file not found in" << AssetRegistry::get().root();
     }
 
 
     // Charger l'image de fond
-    QStringList possibleImagePaths = {
-        QCoreApplication::applicationDirPath() + "/../../../biblio/assets/textures/main_menu_background.jpg",
-        "./assets/textures/main_menu_background.jpg",
-        "../assets/textures/main_menu_background.jpg",
-        "../../assets/textures/main_menu_background.jpg",
-        "../../../assets/textures/main_menu_background.jpg"
-    };
-    
-    QString imagePath;
-    bool foundImagePath = false;
-    for (const auto &path : possibleImagePaths) {
-        if (QFile::exists(path)) {
-            imagePath = path;
-            foundImagePath = true;
-            qDebug() << "Found background image path: " << imagePath;
-            break;
-        }
-    }
-
-    if (foundImagePath) {
+    const QString imagePath = AssetRegistry::get().path("textures/main_menu_background.jpg");
+    if (!imagePath.isEmpty()) {
         if (!m_backgroundImage.load(imagePath)) {
             qWarning() << "Failed to load background image from" << imagePath;
         }
     } else {
-        qWarning() << "Background image main_menu_background.jpg not found. Tried paths:";
-        for (const auto &path : possibleImagePaths) {
-            qWarning() << " - " << path;
-        }
+        qWarning() << "Background image main_menu_background.jpg not found in" << AssetRegistry::get().root();
     }
 }
 
@@ -127,37 +84,16 @@ void MainWindow::on_pushButton_clicked()
 
 void MainWindow::on_pushButton_3_clicked()
 {
-    // Chercher le fichier PDF dans les dossiers assets
-    QStringList possiblePdfPaths = {
-        QCoreApplication::applicationDirPath() + "/../../../biblio/assets/Rapport_BDM.pdf",
-        "./assets/Rapport_BDM.pdf",
-        "../assets/Rapport_BDM.pdf",
-        "../../assets/Rapport_BDM.pdf",
-        "../../../assets/Rapport_BDM.pdf"
-    };
-    
-    QString pdfPath;
-    bool foundPdfPath = false;
-    for (const auto &path : possiblePdfPaths) {
-        if (QFile::exists(path)) {
-            pdfPath = path;
-            foundPdfPath = true;
-            qDebug() << "Found PDF path: " << pdfPath;
-            break;
-        }
-    }
-
-    if (foundPdfPath) {
-        QUrl pdfUrl = QUrl::fromLocalFile(QFileInfo(pdfPath).absoluteFilePath());
+    // Un lecteur externe a besoin d'un vrai fichier : extrait de l'archive si besoin
+    const QString pdfPath = AssetRegistry::get().localFile("Rapport_BDM.pdf");
+    if (!pdfPath.isEmpty()) {
+        QUrl pdfUrl = QUrl::fromLocalFile(pdfPath);
         if (!QDesktopServices::openUrl(pdfUrl)) {
             QMessageBox::warning(this, "Erreur", "Impossible d'ouvrir le fichier PDF.\nVérifiez qu'un lecteur PDF est installé.");
         }
     } else {
         QMessageBox::information(this, "Fichier non trouvé", "Le fichier PDF n'a pas été trouvé dans le dossier assets.");
-        qDebug() << "PDF file not found. Tried paths:";
-        for (const auto &path : possiblePdfPaths) {
-            qDebug() << " - " << path;
-        }
+        qDebug() << "PDF file not found in" << AssetRegistry::get().root();
     }
 }
 
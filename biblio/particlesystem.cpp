@@ -0,0 +1,156 @@
+#include "particlesystem.h"
+#include "gamegeometry.h"
+#include <QElapsedTimer>
+#include <QOpenGLBuffer>
+#include <algorithm>
+#include <cstring>
+
+// Constants
+const float INHERITED_VELOCITY = 0.5f;   // Share of the fruit's velocity given to its particles
+const float JET_SPREAD = 0.6f;           // Random deviation around a jet's direction
+const int JUICE_PER_SIDE = 24;           // Juice droplets on each side of the cut plane
+const int DEBRIS_PER_CUT = 12;           // Seeds, or smoke for the bomb
+const float POINT_SIZE = 4.0f;           // Pixels
+// Juice and debris colors, indexed by Fruit::FruitType (the bomb throws sparks and smoke)
+const GLubyte JUICE_COLORS[][4] = {{200, 20, 30, 255}, {225, 35, 60, 255}, {250, 225, 90, 255}, {200, 225, 110, 255}, {255, 160, 40, 255}};
+const GLubyte DEBRIS_COLORS[][4] = {{70, 40, 20, 255}, {235, 210, 90, 255}, {60, 50, 30, 255}, {70, 45, 25, 255}, {80, 80, 80, 255}};
+
+ParticleSystem::ParticleSystem()
+    : positions(3 * MAX_PARTICLES), velocities(3 * MAX_PARTICLES), lifetimes(MAX_PARTICLES), fadeRates(MAX_PARTICLES),
+      colors(4 * MAX_PARTICLES)
+{
+}
+
+float ParticleSystem::uniform(float low, float high)
+{
+    return std::uniform_real_distribution<float>(low, high)(random);
+}
+
+void ParticleSystem::emitCut(const QVector3D &origin, const QVector3D &normal, const QVector3D &velocity, Fruit::FruitType type)
+{
+    // Juice sprays out of both cut faces, debris falls out in every direction
+    emitBurst(JUICE_PER_SIDE, origin, normal, velocity, 1.5f, 4.0f, 0.4f, 0.9f, JUICE_COLORS[type]);
+    emitBurst(JUICE_PER_SIDE, origin, -normal, velocity, 1.5f, 4.0f, 0.4f, 0.9f, JUICE_COLORS[type]);
+    emitBurst(DEBRIS_PER_CUT, origin, QVector3D(), velocity, 0.5f, 2.0f, 0.8f, 1.5f, DEBRIS_COLORS[type]);
+}
+
+void ParticleSystem::emitBurst(int count, const QVector3D &origin, const QVector3D &direction, const QVector3D &velocity,
+                               float minSpeed, float maxSpeed, float minLife, float maxLife, const GLubyte *color)
+{
+    const int emitted = std::min(count, MAX_PARTICLES - alive);
+    totals.emitted += emitted;
+    totals.dropped += count - emitted;
+
+    const QVector3D inherited = velocity * INHERITED_VELOCITY;
+    for (int n = 0; n < emitted; ++n)
+    {
+        const int i = alive++;
+        QVector3D jitter(uniform(-1.f, 1.f), uniform(-1.f, 1.f), uniform(-1.f, 1.f));
+        const QVector3D jet = direction.isNull() ? jitter.normalized() : (direction + jitter * JET_SPREAD).normalized();
+        const QVector3D speed = jet * uniform(minSpeed, maxSpeed) + inherited;
+        const float life = uniform(minLife, maxLife);
+
+        positions[3 * i] = origin.x();
+        positions[3 * i + 1] = origin.y();
+        positions[3 * i + 2] = origin.z();
+        velocities[3 * i] = speed.x();
+        velocities[3 * i + 1] = speed.y();
+        velocities[3 * i + 2] = speed.z();
+        lifetimes[i] = life;
+        fadeRates[i] = 1.0f / life;
+        std::memcpy(&colors[4 * i], color, 4);
+    }
+    totals.peak = std::max(totals.peak, alive);
+}
+
+void ParticleSystem::update(float dt)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const int n = alive;
+    float *p = positions.data();
+    float *v = velocities.data();
+    float *life = lifetimes.data();
+    const float *fade = fadeRates.data();
+    GLubyte *c = colors.data();
+
+    // Integrate: branch-free loops over the flat arrays, vectorized by the compiler
+    const float fall = GameGeometry::gravity() * dt; // Same as the fruits (GameGeometry::fruitTrajectory)
+    for (int i = 0; i < n; ++i)
+    {
+        v[3 * i + 1] -= fall;
+    }
+    for (int k = 0; k < 3 * n; ++k)
+    {
+        p[k] += v[k] * dt;
+    }
+    // Particles die of age or on the floor, and fade out as they age
+    for (int i = 0; i < n; ++i)
+    {
+        life[i] = p[3 * i + 1] < 0.0f ? 0.0f : life[i] - dt;
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        c[4 * i + 3] = static_cast<GLubyte>(std::clamp(life[i] * fade[i], 0.0f, 1.0f) * 255.0f);
+    }
+
+    // Kill: the last live particle takes each dead one's slot
+    for (int i = 0; i < alive;)
+    {
+        if (life[i] > 0.0f)
+        {
+            ++i;
+            continue;
+        }
+        const int last = --alive;
+        std::memcpy(p + 3 * i, p + 3 * last, 3 * sizeof(float));
+        std::memcpy(v + 3 * i, v + 3 * last, 3 * sizeof(float));
+        life[i] = life[last];
+        fadeRates[i] = fadeRates[last];
+        std::memcpy(c + 4 * i, c + 4 * last, 4);
+    }
+
+    lastMs = timer.nsecsElapsed() / 1.0e6;
+    ++totals.updates;
+    totalUpdateMs += lastMs;
+    totals.maxUpdateMs = std::max(totals.maxUpdateMs, lastMs);
+}
+
+void ParticleSystem::draw() const
+{
+    if (alive == 0)
+    {
+        return;
+    }
+
+    // Unlit, translucent and not hiding what is drawn after
+    glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_POINT_BIT);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_COLOR_MATERIAL);
+    glDisable(GL_TEXTURE_2D);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_POINT_SMOOTH);
+    glPointSize(POINT_SIZE);
+
+    // Client-side arrays: no vertex buffer may be bound
+    QOpenGLBuffer::release(QOpenGLBuffer::VertexBuffer);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, positions.data());
+    glColorPointer(4, GL_UNSIGNED_BYTE, 0, colors.data());
+    glDrawArrays(GL_POINTS, 0, alive);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glPopAttrib();
+}
+
+ParticleSystem::Stats ParticleSystem::stats() const
+{
+    Stats result = totals;
+    result.meanUpdateMs = totals.updates > 0 ? totalUpdateMs / totals.updates : 0.0;
+    return result;
+}
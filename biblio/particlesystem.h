@@ -0,0 +1,127 @@
+/**
+ * @file particlesystem.h
+ * @brief Déclaration de la classe ParticleSystem.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+
+#include <qopengl.h>
+#include <QVector3D>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "fruit.h"
+
+/**
+ * @class ParticleSystem
+ * @brief Éclaboussures de jus et débris (pépins, étincelles de bombe) projetés à chaque découpe.
+ *
+ * Les particules sont rangées en structure de tableaux : positions (x, y, z à la suite), vitesses,
+ * durées de vie et couleurs RGBA, chacun dans son propre tableau alloué une fois pour MAX_PARTICLES.
+ * La mise à jour est faite de boucles simples sur ces tableaux, sans branche, que le compilateur
+ * vectorise ; les particules mortes sont remplacées par la dernière vivante, les vivantes restent
+ * donc au début des tableaux. Positions et couleurs sont dessinées telles quelles en un seul appel
+ * (GL_POINTS, tableaux de sommets du pipeline fixe).
+ */
+class ParticleSystem
+{
+public:
+    /**
+     * @struct Stats
+     * @brief Mesures cumulées depuis la création.
+     */
+    struct Stats
+    {
+        uint64_t emitted = 0;       ///< Particules émises.
+        uint64_t dropped = 0;       ///< Particules non émises faute de place.
+        int peak = 0;               ///< Plus grand nombre de particules vivantes.
+        uint64_t updates = 0;       ///< Appels à update().
+        double meanUpdateMs = 0.0;  ///< Durée moyenne d'une mise à jour (ms).
+        double maxUpdateMs = 0.0;   ///< Durée maximale d'une mise à jour (ms).
+    };
+
+    static constexpr int MAX_PARTICLES = 32768; ///< Particules vivantes au plus (des centaines de découpes simultanées).
+
+    /**
+     * @brief Constructeur de ParticleSystem. Alloue les tableaux pour MAX_PARTICLES.
+     */
+    ParticleSystem();
+
+    /**
+     * @brief Projette le jus et les débris d'un fruit coupé.
+     * @param origin Point d'où partent les particules (le fruit au moment de la coupe).
+     * @param normal Normale du plan de coupe : le jus gicle surtout de part et d'autre de ce plan.
+     * @param velocity Vitesse du fruit en unités par seconde de jeu, transmise en partie aux particules.
+     * @param type Type du fruit, qui choisit les couleurs (étincelles et fumée pour la bombe).
+     */
+    void emitCut(const QVector3D &origin, const QVector3D &normal, const QVector3D &velocity, Fruit::FruitType type);
+
+    /**
+     * @brief Avance les particules d'un pas (gravité, déplacement, vieillissement) et retire les mortes.
+     * Une particule meurt au bout de sa durée de vie ou en passant sous le sol.
+     * @param dt Durée du pas en secondes de jeu (GameGeometry::gameSeconds()), comme les fruits.
+     */
+    void update(float dt);
+
+    /**
+     * @brief Dessine toutes les particules vivantes en un appel. Nécessite un contexte OpenGL courant.
+     * L'état OpenGL est rétabli après le dessin.
+     */
+    void draw() const;
+
+    /**
+     * @brief Retire toutes les particules.
+     */
+    void clear() { alive = 0; }
+
+    /**
+     * @brief Nombre de particules vivantes.
+     */
+    int count() const { return alive; }
+
+    /**
+     * @brief Durée de la dernière mise à jour (ms).
+     */
+    double lastUpdateMs() const { return lastMs; }
+
+    /**
+     * @brief Mesures cumulées depuis la création.
+     */
+    Stats stats() const;
+
+private:
+    std::vector<float> positions;   ///< x, y, z de chaque particule.
+    std::vector<float> velocities;  ///< vx, vy, vz de chaque particule.
+    std::vector<float> lifetimes;   ///< Temps restant avant la disparition (s).
+    std::vector<float> fadeRates;   ///< Inverse de la durée de vie initiale, pour la transparence.
+    std::vector<GLubyte> colors;    ///< r, g, b, a de chaque particule.
+    int alive = 0;                  ///< Particules vivantes, aux indices [0, alive).
+    std::minstd_rand random;        ///< Tirages des particules, indépendants de rand().
+    Stats totals;                   ///< Mesures cumulées (sans moyenne).
+    double totalUpdateMs = 0.0;     ///< Somme des durées de mise à jour.
+    double lastMs = 0.0;            ///< Durée de la dernière mise à jour.
+
+    /**
+     * @brief Émet un jet de particules d'une même couleur.
+     * @param count Nombre de particules voulues ; tronqué s'il n'y a plus de place.
+     * @param origin Point de départ.
+     * @param direction Direction principale du jet (unitaire), ou nulle pour un jet dans toutes les directions.
+     * @param velocity Vitesse héritée du fruit.
+     * @param minSpeed Vitesse minimale propre.
+     * @param maxSpeed Vitesse maximale propre.
+     * @param minLife Durée de vie minimale (s).
+     * @param maxLife Durée de vie maximale (s).
+     * @param color Couleur RGBA.
+     */
+    void emitBurst(int count, const QVector3D &origin, const QVector3D &direction, const QVector3D &velocity,
+                   float minSpeed, float maxSpeed, float minLife, float maxLife, const GLubyte *color);
+
+    /**
+     * @brief Tirage uniforme dans [low, high).
+     */
+    float uniform(float low, float high);
+};
+
+#endif // PARTICLESYSTEM_H
@@ -0,0 +1,184 @@
+#include "renderqueue.h"
+#include "fruitmeshlibrary.h"
+#include <algorithm>
+#include <cstring>
+
+// Constants
+// Sort key layout, most significant first: pass (4 bits), texture (12), surface (12), geometry (16), sequence (20)
+const int TEXTURE_SHIFT = 48;
+const int SURFACE_SHIFT = 36;
+const int GEOMETRY_SHIFT = 20;
+const uint64_t TEXTURE_MASK = 0xFFF;
+const uint64_t SURFACE_MASK = 0xFFF;
+const uint64_t GEOMETRY_MASK = 0xFFFF;
+const uint64_t SEQUENCE_MASK = 0xFFFFF;
+const GLfloat WHITE[] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+void RenderQueue::submit(Pass pass, const QMatrix4x4 &model, const State &state, FruitMeshLibrary &meshes, FruitSlice *slice,
+                         GLint first, GLsizei count)
+{
+    int geometry = 0;
+    while (geometry < static_cast<int>(geometries.size()) &&
+           (geometries[geometry].meshes != &meshes || geometries[geometry].slice != slice))
+    {
+        ++geometry;
+    }
+    if (geometry == static_cast<int>(geometries.size()))
+    {
+        geometries.push_back({&meshes, slice});
+    }
+    add(pass, model, state, geometry, -1, first, count);
+}
+
+void RenderQueue::submit(Pass pass, const QMatrix4x4 &model, const State &state, DrawFunction draw)
+{
+    functions.push_back(std::move(draw));
+    add(pass, model, state, -1, static_cast<int>(functions.size()) - 1, 0, 0);
+}
+
+void RenderQueue::add(Pass pass, const QMatrix4x4 &model, const State &state, int geometry, int function, GLint first, GLsizei count)
+{
+    // A frame only holds a handful of distinct textures and materials: a linear search finds them
+    int texture = 0;
+    while (texture < static_cast<int>(textures.size()) &&
+           (textures[texture].texture != state.texture || textures[texture].region != state.textureRegion))
+    {
+        ++texture;
+    }
+    if (texture == static_cast<int>(textures.size()))
+    {
+        textures.push_back({state.texture, state.textureRegion});
+    }
+
+    int surface = 0;
+    while (surface < static_cast<int>(surfaces.size()) &&
+           (surfaces[surface].material != state.material || !std::equal(state.color, state.color + 4, surfaces[surface].color)))
+    {
+        ++surface;
+    }
+    if (surface == static_cast<int>(surfaces.size()))
+    {
+        SurfaceState added;
+        added.material = state.material;
+        std::memcpy(added.color, state.color, sizeof(added.color));
+        surfaces.push_back(added);
+    }
+
+    items.push_back({model, pass, texture, surface, geometry, function, first, count});
+}
+
+uint64_t RenderQueue::sortKey(const Item &item, int sequence)
+{
+    // Drawing functions come after the mesh parts sharing their state, so the vertex buffer is released once
+    const uint64_t geometry = item.geometry >= 0 ? static_cast<uint64_t>(item.geometry) : GEOMETRY_MASK;
+    return static_cast<uint64_t>(item.pass) << 60 |
+           std::min<uint64_t>(item.texture, TEXTURE_MASK) << TEXTURE_SHIFT |
+           std::min<uint64_t>(item.surface, SURFACE_MASK) << SURFACE_SHIFT |
+           std::min(geometry, GEOMETRY_MASK) << GEOMETRY_SHIFT |
+           std::min<uint64_t>(sequence, SEQUENCE_MASK);
+}
+
+void RenderQueue::beginPass(Pass pass, GLStateCache &cache)
+{
+    cache.setEnabled(GL_LIGHTING, pass == Opaque);
+    cache.setEnabled(GL_DEPTH_TEST, pass != Overlay);
+}
+
+void RenderQueue::flush(GLStateCache &cache)
+{
+    // Whatever was drawn since the last flush may have changed any state
+    cache.invalidate();
+    cache.resetCounters();
+    // Known for the whole frame, so materials only send their specular part (the color drives ambient and diffuse)
+    cache.setEnabled(GL_COLOR_MATERIAL, true);
+    last = Stats();
+    last.frames = 1;
+
+    order.clear();
+    for (int i = 0; i < static_cast<int>(items.size()); ++i)
+    {
+        order.emplace_back(sortKey(items[i], i), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    glMatrixMode(GL_MODELVIEW);
+    int pass = -1;
+    int boundGeometry = -1;
+    for (const auto &entry : order)
+    {
+        const Item &item = items[entry.second];
+        if (item.pass != pass)
+        {
+            pass = item.pass;
+            beginPass(item.pass, cache);
+        }
+
+        const TextureState &texture = textures[item.texture];
+        cache.bindTexture(texture.texture);
+        if (texture.texture != 0)
+        {
+            cache.setTextureRegion(texture.region);
+        }
+        const SurfaceState &surface = surfaces[item.surface];
+        cache.setMaterial(surface.material);
+        cache.setColor(surface.color);
+
+        glPushMatrix();
+        glMultMatrixf(item.model.constData());
+        if (item.geometry >= 0)
+        {
+            if (item.geometry != boundGeometry)
+            {
+                const Geometry &geometry = geometries[item.geometry];
+                if (geometry.slice)
+                {
+                    geometry.meshes->bind(*geometry.slice);
+                }
+                else
+                {
+                    geometry.meshes->bind();
+                }
+                boundGeometry = item.geometry;
+                ++last.bufferBinds;
+            }
+            glDrawArrays(GL_TRIANGLES, item.first, item.count);
+        }
+        else
+        {
+            // Drawing functions may use client-side arrays or immediate mode: no vertex buffer may stay bound
+            if (boundGeometry >= 0)
+            {
+                geometries[boundGeometry].meshes->release();
+                boundGeometry = -1;
+            }
+            functions[item.function](cache);
+        }
+        glPopMatrix();
+        ++last.draws;
+    }
+    if (boundGeometry >= 0)
+    {
+        geometries[boundGeometry].meshes->release();
+    }
+
+    // Leave the defaults the rest of the frame expects
+    cache.setEnabled(GL_LIGHTING, true);
+    cache.setEnabled(GL_DEPTH_TEST, true);
+    cache.bindTexture(0);
+    cache.setTextureRegion(QRectF(0.0, 0.0, 1.0, 1.0));
+    cache.setColor(WHITE);
+
+    last.stateChanges = cache.counters().stateChanges;
+    last.skippedChanges = cache.counters().skippedChanges;
+    total.frames += last.frames;
+    total.draws += last.draws;
+    total.stateChanges += last.stateChanges;
+    total.skippedChanges += last.skippedChanges;
+    total.bufferBinds += last.bufferBinds;
+
+    items.clear();
+    textures.clear();
+    surfaces.clear();
+    geometries.clear();
+    functions.clear();
+}
@@ -0,0 +1,199 @@
+/**
+ * @file renderqueue.h
+ * @brief Déclaration de la classe RenderQueue.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <qopengl.h>
+#include <QMatrix4x4>
+#include <QRectF>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "glstatecache.h"
+
+class FruitMeshLibrary;
+struct FruitSlice;
+
+/**
+ * @class RenderQueue
+ * @brief File des éléments à dessiner dans une image, triés par passe, texture et matériau avant d'être exécutés.
+ *
+ * Les objets de la scène (fruits, katana, canon, particules, retour caméra) ne dessinent plus
+ * directement : ils soumettent des éléments, chacun avec sa matrice modèle, son état (texture,
+ * région de l'atlas, matériau, couleur) et sa géométrie (une partie d'un maillage de
+ * FruitMeshLibrary, ou une fonction de dessin). flush() trie les éléments par une clé de 64 bits
+ * (passe, texture, matériau, tampon de sommets, ordre de soumission) puis les exécute à travers
+ * un GLStateCache : deux éléments voisins qui partagent une texture ou un matériau ne les
+ * renvoient pas, et un même tampon de sommets n'est activé qu'une fois pour tous ses éléments.
+ */
+class RenderQueue
+{
+public:
+    /**
+     * @enum Pass
+     * @brief Passes de rendu, exécutées dans cet ordre.
+     */
+    enum Pass
+    {
+        Opaque,         ///< Objets éclairés avec test de profondeur.
+        Translucent,    ///< Objets transparents non éclairés, après tous les objets opaques.
+        Overlay,        ///< Éléments en 2D par-dessus la scène, sans éclairage ni test de profondeur.
+        PassCount
+    };
+
+    /**
+     * @struct State
+     * @brief État de dessin d'un élément.
+     */
+    struct State
+    {
+        GLuint texture = 0;                         ///< Texture 2D, 0 pour dessiner sans texture.
+        QRectF textureRegion = QRectF(0, 0, 1, 1);  ///< Région de l'atlas où ramener les coordonnées de texture.
+        GLStateCache::Material material;            ///< Matériau des faces avant ; ambiant et diffus suivent color (GL_COLOR_MATERIAL).
+        GLfloat color[4] = {1.0f, 1.0f, 1.0f, 1.0f}; ///< Couleur courante (GL_COLOR_MATERIAL).
+    };
+
+    /**
+     * @brief Fonction de dessin d'un élément, appelée avec la matrice modèle et l'état de l'élément en place.
+     * Elle peut passer par le cache pour modifier l'état ; un état modifié directement doit être rétabli.
+     */
+    using DrawFunction = std::function<void(GLStateCache &)>;
+
+    /**
+     * @struct Stats
+     * @brief Mesures d'une image, ou cumulées sur plusieurs.
+     */
+    struct Stats
+    {
+        uint64_t frames = 0;            ///< Images exécutées par flush().
+        uint64_t draws = 0;             ///< Éléments dessinés.
+        uint64_t stateChanges = 0;      ///< Modifications d'état envoyées à OpenGL (GLStateCache).
+        uint64_t skippedChanges = 0;    ///< Modifications d'état évitées.
+        uint64_t bufferBinds = 0;       ///< Activations d'un tampon de sommets.
+    };
+
+    /**
+     * @brief Soumet une partie d'un maillage de fruit, dessinée par glDrawArrays(GL_TRIANGLES, first, count).
+     * @param pass Passe de l'élément.
+     * @param model Matrice modèle, multipliée à la matrice de vue courante.
+     * @param state Texture, matériau et couleur.
+     * @param meshes Maillages des fruits, déjà envoyés au GPU.
+     * @param slice Moitiés d'un fruit coupé dont le tampon contient la partie, nullptr pour le tampon des fruits entiers.
+     * @param first Premier sommet de la partie.
+     * @param count Nombre de sommets.
+     */
+    void submit(Pass pass, const QMatrix4x4 &model, const State &state, FruitMeshLibrary &meshes, FruitSlice *slice,
+                GLint first, GLsizei count);
+
+    /**
+     * @brief Soumet un élément dessiné par une fonction (primitives immédiates, quadriques, listes d'affichage...).
+     * @param pass Passe de l'élément.
+     * @param model Matrice modèle, multipliée à la matrice de vue courante.
+     * @param state Texture, matériau et couleur.
+     * @param draw Fonction de dessin.
+     */
+    void submit(Pass pass, const QMatrix4x4 &model, const State &state, DrawFunction draw);
+
+    /**
+     * @brief Trie et dessine les éléments soumis, puis vide la file. Nécessite un contexte OpenGL courant.
+     * Le cache est invalidé au début, puis GL_COLOR_MATERIAL activé : la couleur de chaque élément donne ses
+     * composantes ambiante et diffuse. À la fin, l'éclairage, GL_COLOR_MATERIAL et le test de profondeur sont actifs,
+     * le texturage inactif, la matrice de texture et la couleur remises à leurs valeurs par défaut.
+     * @param cache État OpenGL connu.
+     */
+    void flush(GLStateCache &cache);
+
+    /**
+     * @brief Nombre d'éléments soumis depuis le dernier flush().
+     */
+    int size() const { return static_cast<int>(items.size()); }
+
+    /**
+     * @brief Mesures de la dernière image.
+     */
+    const Stats &lastFrame() const { return last; }
+
+    /**
+     * @brief Mesures cumulées depuis la création.
+     */
+    const Stats &totals() const { return total; }
+
+private:
+    /**
+     * @struct Item
+     * @brief Élément soumis. Son état et sa géométrie sont des indices dans les tables de l'image.
+     */
+    struct Item
+    {
+        QMatrix4x4 model;       ///< Matrice modèle.
+        Pass pass;              ///< Passe.
+        int texture;            ///< Indice dans textures.
+        int surface;            ///< Indice dans surfaces.
+        int geometry;           ///< Indice dans geometries, -1 pour une fonction de dessin.
+        int function;           ///< Indice dans functions, -1 pour une partie de maillage.
+        GLint first;            ///< Premier sommet (partie de maillage).
+        GLsizei count;          ///< Nombre de sommets (partie de maillage).
+    };
+
+    /**
+     * @struct TextureState
+     * @brief Texture et région de l'atlas, regroupées dans la clé de tri.
+     */
+    struct TextureState
+    {
+        GLuint texture;     ///< Texture 2D, 0 sans texture.
+        QRectF region;      ///< Région de l'atlas.
+    };
+
+    /**
+     * @struct SurfaceState
+     * @brief Matériau et couleur, regroupés dans la clé de tri.
+     */
+    struct SurfaceState
+    {
+        GLStateCache::Material material;    ///< Matériau.
+        GLfloat color[4];                   ///< Couleur courante.
+    };
+
+    /**
+     * @struct Geometry
+     * @brief Tampon de sommets d'une partie de maillage.
+     */
+    struct Geometry
+    {
+        FruitMeshLibrary *meshes;   ///< Maillages des fruits.
+        FruitSlice *slice;          ///< Moitiés d'un fruit coupé, nullptr pour le tampon des fruits entiers.
+    };
+
+    std::vector<Item> items;                    ///< Éléments de l'image, dans l'ordre de soumission.
+    std::vector<TextureState> textures;         ///< Textures distinctes de l'image.
+    std::vector<SurfaceState> surfaces;         ///< Matériaux distincts de l'image.
+    std::vector<Geometry> geometries;           ///< Tampons distincts de l'image.
+    std::vector<DrawFunction> functions;        ///< Fonctions de dessin de l'image.
+    std::vector<std::pair<uint64_t, int>> order; ///< Clé de tri et indice de chaque élément, réutilisé d'une image à l'autre.
+    Stats last;                                 ///< Mesures de la dernière image.
+    Stats total;                                ///< Mesures cumulées.
+
+    /**
+     * @brief Ajoute un élément avec son état, en réutilisant les textures et matériaux déjà vus dans l'image.
+     */
+    void add(Pass pass, const QMatrix4x4 &model, const State &state, int geometry, int function, GLint first, GLsizei count);
+
+    /**
+     * @brief Applique l'état propre à une passe (éclairage, test de profondeur).
+     */
+    static void beginPass(Pass pass, GLStateCache &cache);
+
+    /**
+     * @brief Clé de tri d'un élément : passe, texture, matériau, tampon, puis ordre de soumission.
+     * @param item Élément.
+     * @param sequence Rang de soumission.
+     */
+    static uint64_t sortKey(const Item &item, int sequence);
+};
+
+#endif // RENDERQUEUE_H
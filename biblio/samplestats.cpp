@@ -0,0 +1,27 @@
+#include "samplestats.h"
+#include <algorithm>
+#include <cmath>
+
+double SampleStats::mean(const std::vector<double> &samples)
+{
+    double total = 0.0;
+    for (double sample : samples)
+    {
+        total += sample;
+    }
+    return samples.empty() ? 0.0 : total / samples.size();
+}
+
+double SampleStats::percentile(std::vector<double> samples, double fraction)
+{
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+
+    // Nearest rank: the ceil(fraction * n)-th smallest sample, clamped to [1, n]
+    size_t rank = static_cast<size_t>(std::ceil(fraction * samples.size()));
+    size_t index = std::min(samples.size(), std::max<size_t>(rank, 1)) - 1;
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
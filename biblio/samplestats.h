@@ -0,0 +1,40 @@
+/**
+ * @file samplestats.h
+ * @brief Déclaration de la classe SampleStats.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef SAMPLESTATS_H
+#define SAMPLESTATS_H
+
+#include <vector>
+
+/**
+ * @class SampleStats
+ * @brief Statistiques sur des séries de mesures de durée, sans état.
+ *
+ * Une seule définition des percentiles pour le banc de mesure (biblio_bench), la
+ * vérification de sessions enregistrées (SessionReplay) et le suivi du rythme d'affichage
+ * (FrameScheduler), afin que leurs chiffres restent comparables.
+ */
+class SampleStats
+{
+public:
+    /**
+     * @brief Moyenne des mesures.
+     * @param samples Mesures.
+     * @return Moyenne, ou 0 si la série est vide.
+     */
+    static double mean(const std::vector<double> &samples);
+
+    /**
+     * @brief Percentile au rang le plus proche : plus petite mesure atteinte ou dépassée
+     * par la fraction demandée des mesures.
+     * @param samples Mesures, copiées pour être partiellement triées.
+     * @param fraction Fraction entre 0 et 1 (0,95 pour le p95).
+     * @return Valeur du percentile, ou 0 si la série est vide.
+     */
+    static double percentile(std::vector<double> samples, double fraction);
+};
+
+#endif // SAMPLESTATS_H
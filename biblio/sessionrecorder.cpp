@@ -0,0 +1,467 @@
+#include "sessionrecorder.h"
+#include "camerahandler.h"
+#include "gamegeometry.h"
+#include "samplestats.h"
+#include <QDebug>
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+// Constants
+const char SESSION_MAGIC[8] = {'B', 'I', 'B', 'S', 'E', 'S', 'S', '1'};
+const uint32_t SESSION_VERSION = 2;
+const size_t MAX_QUEUED_FRAMES = 120;   // About four seconds of frames waiting for the writer
+const int PNG_COMPRESSION = 1;          // Fastest zlib level: the writer has to keep up with the camera
+const int POINT_TOLERANCE = 2;          // Replayed hand centers may move this many pixels and still match
+const int MAX_REPORTED_MISMATCHES = 20; // Detailed mismatch lines printed by verify()
+
+// On-disk layout, host byte order
+struct SessionHeader
+{
+    char magic[8];
+    uint32_t version;
+    int32_t detectionMode;
+    int32_t pyramidLevel;
+    uint32_t droppedFrames;     // Written when the recording is closed
+    uint32_t cascadeBytes;      // Comma-separated cascade file names following the header, padded to 8 bytes
+    uint32_t reserved;
+};
+
+struct RecordHeader
+{
+    uint32_t recordSize;        // Whole record including this header and trailing padding
+    uint32_t imageBytes;        // PNG data following the points and checks
+    uint64_t sequence;
+    int64_t captureTimeUs;
+    int64_t detectionLatencyUs;
+    float katana[3];
+    uint32_t hasKatana;
+    uint32_t pointCount;
+    uint32_t checkCount;
+    uint32_t droppedBefore;     // Frames dropped from the queue right before this one
+    uint32_t fullScan;          // Detection scanned the whole frame, without tracking state
+};
+
+struct RecordedPoint
+{
+    int32_t x;
+    int32_t y;
+};
+
+struct RecordedCheck
+{
+    uint32_t pointIndex;
+    float fruit[3];
+    uint32_t hit;
+};
+
+static_assert(sizeof(SessionHeader) == 32, "session header layout");
+static_assert(sizeof(RecordHeader) == 64, "record header layout");
+static_assert(sizeof(RecordedPoint) == 8 && sizeof(RecordedCheck) == 20, "record payload layout");
+
+SessionRecorder::~SessionRecorder()
+{
+    close();
+}
+
+// Bytes after the session header taking a field of the given size to a multiple of 8
+static size_t paddingFor(size_t size)
+{
+    return (8 - size % 8) % 8;
+}
+
+bool SessionRecorder::open(const QString &path, int detectionMode, int pyramidLevel, const QStringList &cascadeSet)
+{
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qDebug() << "Error: could not create session recording" << path << ":" << file.errorString();
+        return false;
+    }
+
+    SessionHeader header = {};
+    std::memcpy(header.magic, SESSION_MAGIC, sizeof(header.magic));
+    header.version = SESSION_VERSION;
+    header.detectionMode = detectionMode;
+    header.pyramidLevel = pyramidLevel;
+    const QByteArray cascades = cascadeSet.join(',').toUtf8();
+    header.cascadeBytes = static_cast<uint32_t>(cascades.size());
+    static const char zeros[8] = {};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(cascades);
+    file.write(zeros, paddingFor(cascades.size()));
+
+    sessionStart = std::chrono::steady_clock::now();
+    writtenFrames.store(0, std::memory_order_relaxed);
+    droppedFrames.store(0, std::memory_order_relaxed);
+    pendingDrops = 0;
+    stopping = false;
+    writerThread = std::thread(&SessionRecorder::run, this);
+
+    qDebug() << "Recording session to" << path;
+    return true;
+}
+
+void SessionRecorder::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+
+    if (writerThread.joinable())
+    {
+        writerThread.join();
+        qDebug() << "Session recording closed:" << writtenCount() << "frames written," << droppedCount() << "dropped";
+    }
+    if (file.isOpen())
+    {
+        const uint32_t dropped = static_cast<uint32_t>(droppedCount());
+        file.seek(offsetof(SessionHeader, droppedFrames));
+        file.write(reinterpret_cast<const char *>(&dropped), sizeof(dropped));
+        file.close();
+    }
+}
+
+void SessionRecorder::record(SessionFrame &&frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (queue.size() >= MAX_QUEUED_FRAMES)
+        {
+            // Noted in the next record: replay has to know detection ran on frames it does not have
+            droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            ++pendingDrops;
+            return;
+        }
+        frame.droppedBefore = pendingDrops;
+        pendingDrops = 0;
+        queue.push_back(std::move(frame));
+    }
+    queueReady.notify_one();
+}
+
+void SessionRecorder::run()
+{
+    while (true)
+    {
+        SessionFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this]() { return stopping || !queue.empty(); });
+            // Drain what is queued before stopping so the end of the session is kept
+            if (queue.empty())
+            {
+                return;
+            }
+            frame = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        write(frame);
+        writtenFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SessionRecorder::write(const SessionFrame &frame)
+{
+    std::vector<uchar> encoded;
+    if (!frame.image.empty())
+    {
+        cv::imencode(".png", frame.image, encoded, {cv::IMWRITE_PNG_COMPRESSION, PNG_COMPRESSION});
+    }
+
+    std::vector<RecordedPoint> points;
+    for (const cv::Point &point : frame.points)
+    {
+        points.push_back({point.x, point.y});
+    }
+    std::vector<RecordedCheck> checks;
+    for (const SessionFrame::FruitCheck &check : frame.checks)
+    {
+        checks.push_back({check.pointIndex,
+                          {check.fruitPosition.x(), check.fruitPosition.y(), check.fruitPosition.z()},
+                          check.hit ? 1u : 0u});
+    }
+
+    const size_t payload = sizeof(RecordHeader) + points.size() * sizeof(RecordedPoint)
+                           + checks.size() * sizeof(RecordedCheck) + encoded.size();
+    const size_t padding = paddingFor(payload);
+
+    RecordHeader header = {};
+    header.recordSize = static_cast<uint32_t>(payload + padding);
+    header.imageBytes = static_cast<uint32_t>(encoded.size());
+    header.sequence = frame.sequence;
+    header.captureTimeUs = frame.captureTimeUs;
+    header.detectionLatencyUs = frame.detectionLatencyUs;
+    header.katana[0] = frame.katanaPosition.x();
+    header.katana[1] = frame.katanaPosition.y();
+    header.katana[2] = frame.katanaPosition.z();
+    header.hasKatana = frame.hasKatana ? 1u : 0u;
+    header.pointCount = static_cast<uint32_t>(points.size());
+    header.checkCount = static_cast<uint32_t>(checks.size());
+    header.droppedBefore = frame.droppedBefore;
+    header.fullScan = frame.fullScan ? 1u : 0u;
+
+    static const char zeros[8] = {};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(points.data()), points.size() * sizeof(RecordedPoint));
+    file.write(reinterpret_cast<const char *>(checks.data()), checks.size() * sizeof(RecordedCheck));
+    file.write(reinterpret_cast<const char *>(encoded.data()), encoded.size());
+    file.write(zeros, padding);
+}
+
+SessionReplay::~SessionReplay()
+{
+    if (data)
+    {
+        file.unmap(const_cast<uchar *>(data));
+    }
+}
+
+bool SessionReplay::open(const QString &path)
+{
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qDebug() << "Error: could not open session recording" << path << ":" << file.errorString();
+        return false;
+    }
+    size = file.size();
+    if (size < static_cast<qint64>(sizeof(SessionHeader)))
+    {
+        qDebug() << "Error:" << path << "is not a session recording";
+        return false;
+    }
+    data = file.map(0, size);
+    if (!data)
+    {
+        qDebug() << "Error: could not map" << path << ":" << file.errorString();
+        return false;
+    }
+
+    SessionHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, SESSION_MAGIC, sizeof(header.magic)) != 0 || header.version != SESSION_VERSION)
+    {
+        qDebug() << "Error:" << path << "is not a session recording (or an unsupported version)";
+        return false;
+    }
+    recordedDetectionMode = header.detectionMode;
+    recordedPyramidLevel = header.pyramidLevel;
+    recordedDroppedFrames = header.droppedFrames;
+
+    qint64 offset = sizeof(SessionHeader);
+    if (offset + header.cascadeBytes > size)
+    {
+        qDebug() << "Error:" << path << "is truncated";
+        return false;
+    }
+    const QString cascades = QString::fromUtf8(reinterpret_cast<const char *>(data + offset), header.cascadeBytes);
+    recordedCascadeSet = cascades.split(',', Qt::SkipEmptyParts);
+    offset += header.cascadeBytes + paddingFor(header.cascadeBytes);
+
+    // Index the records; a truncated last record (recording interrupted) is ignored
+    while (offset + static_cast<qint64>(sizeof(RecordHeader)) <= size)
+    {
+        RecordHeader record;
+        std::memcpy(&record, data + offset, sizeof(record));
+        if (record.recordSize < sizeof(RecordHeader) || offset + record.recordSize > size)
+        {
+            break;
+        }
+        offsets.push_back(offset);
+        offset += record.recordSize;
+    }
+    return true;
+}
+
+bool SessionReplay::frame(size_t index, SessionFrame &frame, bool decodeImage) const
+{
+    if (index >= offsets.size())
+    {
+        return false;
+    }
+
+    const uchar *record = data + offsets[index];
+    RecordHeader header;
+    std::memcpy(&header, record, sizeof(header));
+    const size_t needed = sizeof(RecordHeader) + header.pointCount * sizeof(RecordedPoint)
+                          + header.checkCount * sizeof(RecordedCheck) + header.imageBytes;
+    if (needed > header.recordSize)
+    {
+        return false;
+    }
+
+    frame.sequence = header.sequence;
+    frame.captureTimeUs = header.captureTimeUs;
+    frame.detectionLatencyUs = header.detectionLatencyUs;
+    frame.hasKatana = header.hasKatana != 0;
+    frame.katanaPosition = QVector3D(header.katana[0], header.katana[1], header.katana[2]);
+    frame.droppedBefore = header.droppedBefore;
+    frame.fullScan = header.fullScan != 0;
+
+    const uchar *cursor = record + sizeof(RecordHeader);
+    frame.points.clear();
+    for (uint32_t i = 0; i < header.pointCount; ++i, cursor += sizeof(RecordedPoint))
+    {
+        RecordedPoint point;
+        std::memcpy(&point, cursor, sizeof(point));
+        frame.points.emplace_back(point.x, point.y);
+    }
+    frame.checks.clear();
+    for (uint32_t i = 0; i < header.checkCount; ++i, cursor += sizeof(RecordedCheck))
+    {
+        RecordedCheck recorded;
+        std::memcpy(&recorded, cursor, sizeof(recorded));
+        SessionFrame::FruitCheck check;
+        check.pointIndex = recorded.pointIndex;
+        check.fruitPosition = QVector3D(recorded.fruit[0], recorded.fruit[1], recorded.fruit[2]);
+        check.hit = recorded.hit != 0;
+        frame.checks.push_back(check);
+    }
+
+    frame.image.release();
+    if (decodeImage && header.imageBytes > 0)
+    {
+        // Decodes straight from the mapping, no intermediate copy
+        cv::Mat encoded(1, static_cast<int>(header.imageBytes), CV_8UC1, const_cast<uchar *>(cursor));
+        frame.image = cv::imdecode(encoded, cv::IMREAD_UNCHANGED);
+        if (frame.image.empty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int SessionReplay::verify(const QString &path)
+{
+    SessionReplay replay;
+    if (!replay.open(path))
+    {
+        return 2;
+    }
+
+    // Detection is stateful (tracking), so replay every frame in order with the recorded settings and cascades
+    const CameraHandler::DetectionMode mode = static_cast<CameraHandler::DetectionMode>(replay.detectionMode());
+    CameraHandler cameraHandler(false);
+    cameraHandler.setDetectionMode(mode);
+    cameraHandler.setDetectionPyramidLevel(replay.pyramidLevel());
+    const QStringList cascadeSet = replay.cascadeSet().isEmpty() ? CameraHandler::configuredCascadeSet() : replay.cascadeSet();
+    if (!cameraHandler.setCascades(CameraHandler::loadCascadeSet(cascadeSet)))
+    {
+        std::cout << "Cannot load the cascades " << cascadeSet.join(',').toStdString() << std::endl;
+        return 2;
+    }
+    if (cascadeSet != CameraHandler::configuredCascadeSet())
+    {
+        std::cout << "Using the recorded cascades " << cascadeSet.join(',').toStdString()
+                  << " instead of " << CameraHandler::configuredCascadeSet().join(',').toStdString() << std::endl;
+    }
+
+    size_t pointMismatches = 0;
+    size_t hitMismatches = 0;
+    size_t checks = 0;
+    int reported = 0;
+    std::vector<double> recordedLatencyMs;
+    std::vector<double> replayedMs;
+    size_t unverified = 0;
+    bool resynchronising = false;
+
+    SessionFrame recorded;
+    for (size_t i = 0; i < replay.frameCount(); ++i)
+    {
+        if (!replay.frame(i, recorded))
+        {
+            std::cout << "Frame " << i << ": corrupt record, stopping" << std::endl;
+            break;
+        }
+
+        // Frames dropped while recording still went through detection: the recorded tracking state depends on
+        // them until its next full scan, where the replayed detection restarts from scratch as well
+        if (recorded.droppedBefore > 0)
+        {
+            resynchronising = true;
+        }
+        if (resynchronising)
+        {
+            if (!recorded.fullScan)
+            {
+                ++unverified;
+                continue;
+            }
+            cameraHandler.setDetectionMode(mode);
+            resynchronising = false;
+        }
+
+        cv::Mat gray = recorded.image;
+        cv::Mat color;
+        if (gray.channels() == 3)
+        {
+            color = gray;
+            cv::cvtColor(color, gray, cv::COLOR_BGR2GRAY);
+        }
+        else
+        {
+            cv::cvtColor(gray, color, cv::COLOR_GRAY2BGR);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<cv::Point> points = cameraHandler.detectFaces(color, gray, false);
+        replayedMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        recordedLatencyMs.push_back(recorded.detectionLatencyUs / 1000.0);
+
+        bool pointsMatch = points.size() == recorded.points.size();
+        for (size_t p = 0; pointsMatch && p < points.size(); ++p)
+        {
+            pointsMatch = std::abs(points[p].x - recorded.points[p].x) <= POINT_TOLERANCE
+                          && std::abs(points[p].y - recorded.points[p].y) <= POINT_TOLERANCE;
+        }
+        if (!pointsMatch)
+        {
+            ++pointMismatches;
+            if (reported++ < MAX_REPORTED_MISMATCHES)
+            {
+                std::cout << "Frame " << i << " (capture " << recorded.sequence << "): recorded "
+                          << recorded.points.size() << " hands, replay found " << points.size() << std::endl;
+            }
+        }
+
+        for (const SessionFrame::FruitCheck &check : recorded.checks)
+        {
+            ++checks;
+            bool hit = check.pointIndex < points.size()
+                       && GameGeometry::isKatanaHit(GameGeometry::projectCameraPoint(points[check.pointIndex], gray.size()),
+                                                    check.fruitPosition);
+            if (hit != check.hit)
+            {
+                ++hitMismatches;
+                if (reported++ < MAX_REPORTED_MISMATCHES)
+                {
+                    std::cout << "Frame " << i << " (capture " << recorded.sequence << "): fruit at ("
+                              << check.fruitPosition.x() << ", " << check.fruitPosition.y() << ", " << check.fruitPosition.z()
+                              << ") recorded " << (check.hit ? "hit" : "miss") << ", replay " << (hit ? "hit" : "miss") << std::endl;
+                }
+            }
+        }
+    }
+
+    std::cout << "Replayed " << replay.frameCount() << " frames from " << path.toStdString() << std::endl;
+    std::cout << "  dropped while recording: " << replay.droppedFrames() << ", " << unverified
+              << " frames not compared while resynchronising" << std::endl;
+    std::cout << "  hand mismatches:      " << pointMismatches << std::endl;
+    std::cout << "  collision mismatches: " << hitMismatches << " of " << checks << " checks" << std::endl;
+    std::cout << "  recorded capture-to-detection: " << SampleStats::mean(recordedLatencyMs) << " ms mean, "
+              << SampleStats::percentile(recordedLatencyMs, 0.95) << " ms p95" << std::endl;
+    std::cout << "  replayed detection:            " << SampleStats::mean(replayedMs) << " ms mean, "
+              << SampleStats::percentile(replayedMs, 0.95) << " ms p95" << std::endl;
+
+    return pointMismatches == 0 && hitMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file sessionrecorder.h
+ * @brief Déclaration des classes SessionRecorder et SessionReplay.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <opencv2/core.hpp>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector3D>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct SessionFrame
+ * @brief Une image analysée pendant une partie, avec ce que le jeu en a déduit.
+ */
+struct SessionFrame
+{
+    /**
+     * @struct FruitCheck
+     * @brief Test de collision effectué entre une main détectée et un fruit.
+     */
+    struct FruitCheck
+    {
+        uint32_t pointIndex = 0;    ///< Indice de la main testée dans points.
+        QVector3D fruitPosition;    ///< Position du fruit au moment du test.
+        bool hit = false;           ///< Résultat du test.
+    };
+
+    cv::Mat image;                      ///< Image analysée par la détection (niveaux de gris ou BGR).
+    uint64_t sequence = 0;              ///< Numéro de séquence de la capture.
+    int64_t captureTimeUs = 0;          ///< Instant de capture, en microsecondes depuis le début de l'enregistrement.
+    int64_t detectionLatencyUs = 0;     ///< Durée entre la capture et la fin de la détection, en microsecondes.
+    std::vector<cv::Point> points;      ///< Centres des mains détectées.
+    bool hasKatana = false;             ///< Indique qu'une position du katana a été projetée.
+    QVector3D katanaPosition;           ///< Position projetée du katana (dernière main traitée).
+    std::vector<FruitCheck> checks;     ///< Tests de collision effectués avec ce résultat.
+    bool fullScan = false;              ///< La détection a balayé toute l'image (DetectionResult::fullScan).
+    uint32_t droppedBefore = 0;         ///< Images abandonnées juste avant celle-ci, faute de place (rempli par SessionRecorder).
+};
+
+/**
+ * @class SessionRecorder
+ * @brief Enregistre une partie dans un fichier binaire compact, depuis un thread d'écriture dédié.
+ *
+ * Format (entiers en ordre de l'hôte, enregistrements complétés à un multiple de 8 octets) : un en-tête de 32 octets
+ * ("BIBSESS1", version, mode et niveau de pyramide de la détection, nombre total d'images abandonnées),
+ * les noms des classificateurs séparés par des virgules, puis une suite d'enregistrements, chacun
+ * préfixé par sa taille : horodatages, images abandonnées juste avant, balayage complet ou non,
+ * image compressée en PNG (sans perte, pour que le rejeu redonne exactement la même détection),
+ * points détectés, position du katana et tests de collision.
+ *
+ * record() ne bloque jamais le jeu : la compression et l'écriture se font sur le thread
+ * d'écriture, et les images sont abandonnées si la file d'attente est pleine. Chaque abandon
+ * est noté dans l'enregistrement suivant, pour que le rejeu se resynchronise.
+ */
+class SessionRecorder
+{
+public:
+    SessionRecorder() = default;
+
+    /**
+     * @brief Destructeur de SessionRecorder.
+     * Écrit les images en attente et ferme le fichier.
+     */
+    ~SessionRecorder();
+
+    /**
+     * @brief Crée le fichier d'enregistrement et démarre le thread d'écriture.
+     * @param path Chemin du fichier à créer.
+     * @param detectionMode Mode de détection utilisé (CameraHandler::DetectionMode), rejoué à l'identique.
+     * @param pyramidLevel Niveau de pyramide de la détection.
+     * @param cascadeSet Fichiers des classificateurs utilisés (CameraHandler::configuredCascadeSet()), rechargés au rejeu.
+     * @return true si le fichier a pu être créé.
+     */
+    bool open(const QString &path, int detectionMode, int pyramidLevel, const QStringList &cascadeSet);
+
+    /**
+     * @brief Écrit les images en attente, arrête le thread, inscrit le nombre d'images abandonnées dans l'en-tête et ferme le fichier.
+     */
+    void close();
+
+    /**
+     * @brief Indique si un enregistrement est en cours.
+     */
+    bool isOpen() const { return writerThread.joinable(); }
+
+    /**
+     * @brief Ajoute une image à l'enregistrement, sans bloquer.
+     * @param frame Image et résultats ; l'image est partagée, elle ne doit plus être modifiée par l'appelant.
+     */
+    void record(SessionFrame &&frame);
+
+    /**
+     * @brief Origine des temps de l'enregistrement, pour calculer SessionFrame::captureTimeUs.
+     */
+    std::chrono::steady_clock::time_point startTime() const { return sessionStart; }
+
+    /** @brief Nombre d'images écrites. */
+    uint64_t writtenCount() const { return writtenFrames.load(std::memory_order_relaxed); }
+
+    /** @brief Nombre d'images abandonnées faute de place dans la file d'attente. */
+    uint64_t droppedCount() const { return droppedFrames.load(std::memory_order_relaxed); }
+
+private:
+    QFile file;                                         ///< Fichier d'enregistrement.
+    std::thread writerThread;                           ///< Thread de compression et d'écriture.
+    std::mutex queueMutex;                              ///< Protège queue et stopping.
+    std::condition_variable queueReady;                 ///< Réveille le thread d'écriture.
+    std::deque<SessionFrame> queue;                     ///< Images en attente d'écriture.
+    bool stopping = false;                              ///< Demande d'arrêt du thread d'écriture.
+    std::chrono::steady_clock::time_point sessionStart; ///< Instant d'ouverture de l'enregistrement.
+    std::atomic<uint64_t> writtenFrames{0};             ///< Nombre d'images écrites.
+    std::atomic<uint64_t> droppedFrames{0};             ///< Nombre d'images abandonnées.
+    uint32_t pendingDrops = 0;                          ///< Images abandonnées depuis la dernière mise en file (protégé par queueMutex).
+
+    /**
+     * @brief Boucle du thread d'écriture.
+     */
+    void run();
+
+    /**
+     * @brief Compresse et écrit un enregistrement.
+     * @param frame Image et résultats à écrire.
+     */
+    void write(const SessionFrame &frame);
+};
+
+/**
+ * @class SessionReplay
+ * @brief Lit un enregistrement de SessionRecorder en le projetant en mémoire (QFile::map).
+ *
+ * Les enregistrements sont indexés à l'ouverture sans rien copier ; seule l'image demandée
+ * est décompressée par frame().
+ */
+class SessionReplay
+{
+public:
+    SessionReplay() = default;
+    ~SessionReplay();
+
+    /**
+     * @brief Projette le fichier en mémoire et indexe ses enregistrements.
+     * @param path Chemin du fichier.
+     * @return false si le fichier est illisible ou n'est pas un enregistrement de session.
+     */
+    bool open(const QString &path);
+
+    /** @brief Nombre d'images enregistrées. */
+    size_t frameCount() const { return offsets.size(); }
+
+    /** @brief Mode de détection utilisé pendant l'enregistrement (CameraHandler::DetectionMode). */
+    int detectionMode() const { return recordedDetectionMode; }
+
+    /** @brief Niveau de pyramide utilisé pendant l'enregistrement. */
+    int pyramidLevel() const { return recordedPyramidLevel; }
+
+    /** @brief Fichiers des classificateurs utilisés pendant l'enregistrement. */
+    const QStringList &cascadeSet() const { return recordedCascadeSet; }
+
+    /** @brief Nombre total d'images abandonnées pendant l'enregistrement (0 si l'enregistrement a été interrompu). */
+    uint32_t droppedFrames() const { return recordedDroppedFrames; }
+
+    /**
+     * @brief Lit un enregistrement.
+     * @param index Indice de l'image, de 0 à frameCount() - 1.
+     * @param frame Image et résultats enregistrés. (paramètre de sortie)
+     * @param decodeImage false pour ne lire que les résultats.
+     * @return false si l'enregistrement est corrompu.
+     */
+    bool frame(size_t index, SessionFrame &frame, bool decodeImage = true) const;
+
+    /**
+     * @brief Rejoue un enregistrement dans la détection et les collisions actuelles et compare les résultats.
+     * Affiche les écarts (mains détectées, touches) et la latence de détection enregistrée et rejouée.
+     * Les classificateurs enregistrés sont rechargés. Après des images abandonnées, le suivi enregistré dépend
+     * d'images absentes : les images suivantes ne sont pas comparées jusqu'au prochain balayage complet enregistré,
+     * où la détection rejouée repart de zéro.
+     * @param path Chemin du fichier.
+     * @return Code de sortie du programme : 0 si les résultats sont identiques, 1 sinon, 2 si le fichier est illisible.
+     */
+    static int verify(const QString &path);
+
+private:
+    QFile file;                         ///< Fichier projeté.
+    const uchar *data = nullptr;        ///< Début de la projection en mémoire.
+    qint64 size = 0;                    ///< Taille du fichier.
+    std::vector<qint64> offsets;        ///< Position de chaque enregistrement dans le fichier.
+    int recordedDetectionMode = 0;      ///< Mode de détection lu dans l'en-tête.
+    int recordedPyramidLevel = 0;       ///< Niveau de pyramide lu dans l'en-tête.
+    QStringList recordedCascadeSet;     ///< Classificateurs lus après l'en-tête.
+    uint32_t recordedDroppedFrames = 0; ///< Images abandonnées, lues dans l'en-tête.
+};
+
+#endif // SESSIONRECORDER_H
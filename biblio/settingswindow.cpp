@@ -15,6 +15,12 @@ SettingsWindow::SettingsWindow(QWidget *parent)
 
     cameraWidget = new CameraWidget(this);
     ui->camera->layout()->addWidget(cameraWidget);
+
+    populateCaptureProfiles();
+    statusTimer = new QTimer(this);
+    connect(statusTimer, &QTimer::timeout, this, &SettingsWindow::updateCaptureStatus);
+    statusTimer->start(500);
+    updateCaptureStatus();
 }
 
 SettingsWindow::~SettingsWindow()
@@ -31,3 +37,33 @@ void SettingsWindow::on_pushButton_clicked()
 
 }
 
+void SettingsWindow::populateCaptureProfiles()
+{
+    const QString preferred = CaptureProfile::preferred().toString();
+
+    ui->captureProfileCombo->clear();
+    ui->captureProfileCombo->addItem("Auto (lowest latency)", QString("auto"));
+    for (const CaptureProfile &profile : cameraWidget->supportedCaptureProfiles()) {
+        ui->captureProfileCombo->addItem(profile.toString(), profile.toString());
+    }
+
+    int index = ui->captureProfileCombo->findData(preferred);
+    if (index < 0) {
+        // Saved mode not offered by this camera: keep it, the camera will pick the closest one
+        ui->captureProfileCombo->addItem(preferred, preferred);
+        index = ui->captureProfileCombo->count() - 1;
+    }
+    ui->captureProfileCombo->setCurrentIndex(index);
+}
+
+void SettingsWindow::on_captureProfileCombo_activated(int index)
+{
+    CaptureProfile profile = CaptureProfile::fromString(ui->captureProfileCombo->itemData(index).toString());
+    cameraWidget->setCaptureProfile(profile);
+    updateCaptureStatus();
+}
+
+void SettingsWindow::updateCaptureStatus()
+{
+    ui->captureStatusLabel->setText(cameraWidget->captureStatus());
+}
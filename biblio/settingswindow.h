@@ -8,6 +8,7 @@
 #define SETTINGSWINDOW_H
 
 #include <QWidget>
+#include <QTimer>
 #include "camerawidget.h"
 
 namespace Ui {
@@ -47,9 +48,27 @@ private slots:
      */
     void on_pushButton_clicked();
 
+    /**
+     * @brief Slot appelé lorsque l'utilisateur choisit un mode de capture dans la liste.
+     * Enregistre le choix (utilisé aussi par le jeu) et rouvre la caméra de l'aperçu avec ce mode.
+     * @param index Indice du mode choisi ; 0 correspond au choix automatique.
+     */
+    void on_captureProfileCombo_activated(int index);
+
+    /**
+     * @brief Met à jour l'affichage du mode actif et de la latence mesurée.
+     */
+    void updateCaptureStatus();
+
 private:
     Ui::SettingsWindow *ui;     ///< Pointeur vers l'objet d'interface utilisateur généré par Qt Designer.
     CameraWidget *cameraWidget; ///< Pointeur vers un widget qui affiche le flux de la caméra ou permet de configurer ses paramètres.
+    QTimer *statusTimer;        ///< Rafraîchit périodiquement l'affichage du mode de capture et de la latence.
+
+    /**
+     * @brief Remplit la liste des modes de capture et sélectionne le mode enregistré.
+     */
+    void populateCaptureProfiles();
 };
 
 #endif // SETTINGSWINDOW_H
@@ -0,0 +1,161 @@
+#include "streamingtexture.h"
+#include <QDebug>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <cstring>
+
+// Desktop OpenGL 1.2+ tokens, missing from some platform headers
+#ifndef GL_BGR
+#define GL_BGR 0x80E0
+#endif
+#ifndef GL_BGRA
+#define GL_BGRA 0x80E1
+#endif
+#ifndef GL_RGBA8
+#define GL_RGBA8 0x8058
+#endif
+
+// Copies the image rows tightly packed, as glTexSubImage2D reads them with GL_UNPACK_ALIGNMENT 1
+static void copyRows(const cv::Mat &image, void *destination)
+{
+    const size_t rowBytes = image.cols * image.elemSize();
+    if (image.isContinuous())
+    {
+        std::memcpy(destination, image.data, rowBytes * image.rows);
+        return;
+    }
+    unsigned char *row = static_cast<unsigned char *>(destination);
+    for (int y = 0; y < image.rows; ++y)
+    {
+        std::memcpy(row, image.ptr(y), rowBytes);
+        row += rowBytes;
+    }
+}
+
+bool StreamingTexture::update(const cv::Mat &image, uint64_t sequence)
+{
+    if (isCurrent(sequence))
+    {
+        return true;
+    }
+    if (image.empty() || image.depth() != CV_8U || (image.channels() != 3 && image.channels() != 4))
+    {
+        return uploaded;
+    }
+
+    if (texture == 0 || image.cols != textureWidth || image.rows != textureHeight || image.channels() != textureChannels)
+    {
+        allocate(image.cols, image.rows, image.channels());
+    }
+
+    const GLenum format = image.channels() == 4 ? GL_BGRA : GL_BGR;
+    const int size = static_cast<int>(image.total() * image.elemSize());
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    if (usePixelBuffers)
+    {
+        // Alternate between the two buffers: the one written now fed the texture two frames ago, so its
+        // transfer is over and mapping it does not wait. Their storage is only reallocated on a resize.
+        QOpenGLBuffer &pixelBuffer = pixelBuffers[nextPixelBuffer];
+        nextPixelBuffer = 1 - nextPixelBuffer;
+        pixelBuffer.bind();
+        void *mapped = pixelBuffer.map(QOpenGLBuffer::WriteOnly);
+        if (mapped)
+        {
+            copyRows(image, mapped);
+            pixelBuffer.unmap();
+        }
+        else
+        {
+            cv::Mat packed = image.isContinuous() ? image : image.clone();
+            pixelBuffer.write(0, packed.data, size);
+        }
+        // Source is the bound buffer: the copy to the texture runs asynchronously
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.cols, image.rows, format, GL_UNSIGNED_BYTE, nullptr);
+        pixelBuffer.release();
+    }
+    else
+    {
+        cv::Mat packed = image.isContinuous() ? image : image.clone();
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.cols, image.rows, format, GL_UNSIGNED_BYTE, packed.data);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    uploaded = true;
+    lastSequence = sequence;
+    ++uploads;
+    return true;
+}
+
+void StreamingTexture::allocate(int width, int height, int channels)
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    const QPair<int, int> version = context->format().version();
+
+    // Immutable storage cannot be resized: a new resolution gets a new texture
+    if (texture != 0)
+    {
+        glDeleteTextures(1, &texture);
+    }
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    const bool immutable = !context->isOpenGLES() && (version >= qMakePair(4, 2) || context->hasExtension("GL_ARB_texture_storage"));
+    if (immutable)
+    {
+        context->extraFunctions()->glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+    }
+    else
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    usePixelBuffers = !context->isOpenGLES() && (version >= qMakePair(2, 1) || context->hasExtension("GL_ARB_pixel_buffer_object"));
+    for (QOpenGLBuffer &pixelBuffer : pixelBuffers)
+    {
+        if (usePixelBuffers && !pixelBuffer.isCreated())
+        {
+            usePixelBuffers = pixelBuffer.create();
+            pixelBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+        }
+        if (usePixelBuffers)
+        {
+            pixelBuffer.bind();
+            pixelBuffer.allocate(width * height * channels);
+            pixelBuffer.release();
+        }
+    }
+    nextPixelBuffer = 0;
+
+    textureWidth = width;
+    textureHeight = height;
+    textureChannels = channels;
+    uploaded = false;
+    qDebug() << "Camera texture allocated:" << width << "x" << height << (immutable ? "immutable" : "mutable") << "storage,"
+             << (usePixelBuffers ? "pixel buffer upload" : "direct upload");
+}
+
+void StreamingTexture::destroy()
+{
+    if (texture != 0)
+    {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+    for (QOpenGLBuffer &pixelBuffer : pixelBuffers)
+    {
+        pixelBuffer.destroy();
+    }
+    textureWidth = 0;
+    textureHeight = 0;
+    textureChannels = 0;
+    uploaded = false;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file streamingtexture.h
+ * @brief Déclaration de la classe StreamingTexture.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef STREAMINGTEXTURE_H
+#define STREAMINGTEXTURE_H
+
+#include <qopengl.h>
+#include <QOpenGLBuffer>
+#include <opencv2/core.hpp>
+#include <cstdint>
+
+/**
+ * @class StreamingTexture
+ * @brief Texture OpenGL alimentée par un flux d'images BGR (retour caméra), envoyée seulement à chaque nouvelle image.
+ *
+ * Le stockage de la texture est alloué une fois par résolution (immuable avec glTexStorage2D
+ * lorsque le contexte le permet), puis chaque nouvelle image est copiée par glTexSubImage2D
+ * au format GL_BGR, sans conversion sur le CPU. La copie passe par deux pixel buffer objects
+ * utilisés en alternance, alloués avec la texture : le transfert vers la texture est asynchrone
+ * et l'écriture d'une image n'attend pas la fin du transfert de la précédente.
+ *
+ * Une image dont le numéro de séquence a déjà été envoyé n'est pas renvoyée : le coût d'un
+ * rafraîchissement sans nouvelle image est nul.
+ */
+class StreamingTexture
+{
+public:
+    StreamingTexture() = default;
+
+    /**
+     * @brief Envoie une image si son numéro de séquence n'a pas encore été envoyé.
+     * @param image Image BGR 8 bits (CV_8UC3) ou BGRA (CV_8UC4).
+     * @param sequence Numéro de séquence de l'image.
+     * @return true si la texture contient une image. Nécessite un contexte OpenGL courant.
+     */
+    bool update(const cv::Mat &image, uint64_t sequence);
+
+    /**
+     * @brief Libère la texture et les tampons. Nécessite le contexte OpenGL de update().
+     */
+    void destroy();
+
+    /**
+     * @brief Indique si la texture contient une image.
+     */
+    bool hasImage() const { return uploaded; }
+
+    /**
+     * @brief Indique si l'image de ce numéro de séquence est déjà dans la texture.
+     * @param sequence Numéro de séquence de l'image.
+     */
+    bool isCurrent(uint64_t sequence) const { return uploaded && sequence == lastSequence; }
+
+    /** @brief Identifiant de la texture OpenGL, 0 avant la première image. */
+    GLuint textureId() const { return texture; }
+
+    /** @brief Largeur de l'image en pixels. */
+    int width() const { return textureWidth; }
+
+    /** @brief Hauteur de l'image en pixels. */
+    int height() const { return textureHeight; }
+
+    /** @brief Nombre d'images envoyées au GPU depuis la création. */
+    uint64_t uploadCount() const { return uploads; }
+
+private:
+    /**
+     * @brief (Ré)alloue la texture et les tampons pour une résolution et un format.
+     * @param width Largeur en pixels.
+     * @param height Hauteur en pixels.
+     * @param channels 3 (BGR) ou 4 (BGRA).
+     */
+    void allocate(int width, int height, int channels);
+
+    GLuint texture = 0;                 ///< Texture de l'image courante.
+    QOpenGLBuffer pixelBuffers[2] = {QOpenGLBuffer(QOpenGLBuffer::PixelUnpackBuffer),
+                                     QOpenGLBuffer(QOpenGLBuffer::PixelUnpackBuffer)}; ///< Tampons de transfert utilisés en alternance.
+    int nextPixelBuffer = 0;            ///< Tampon de transfert de la prochaine image.
+    bool usePixelBuffers = false;       ///< false si le contexte ne gère pas les pixel buffer objects (envoi direct).
+    int textureWidth = 0;               ///< Largeur allouée.
+    int textureHeight = 0;              ///< Hauteur allouée.
+    int textureChannels = 0;            ///< Nombre de canaux alloués (3 ou 4).
+    bool uploaded = false;              ///< true si une image a été envoyée.
+    uint64_t lastSequence = 0;          ///< Numéro de séquence de l'image envoyée.
+    uint64_t uploads = 0;               ///< Nombre d'images envoyées.
+};
+
+#endif // STREAMINGTEXTURE_H
@@ -0,0 +1,282 @@
+#include "textureatlas.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+
+// Desktop OpenGL 1.2+ tokens, missing from some platform headers
+#ifndef GL_TEXTURE_MAX_LEVEL
+#define GL_TEXTURE_MAX_LEVEL 0x813D
+#endif
+#ifndef GL_RGBA8
+#define GL_RGBA8 0x8058
+#endif
+
+// Constants
+const int CELL_SIZE = 256;              // Atlas cell, gutter included
+const int CELL_GUTTER = 8;              // Edge pixels repeated around each image
+const int ATLAS_COLUMNS = 4;
+const int ATLAS_LEVELS = 4;             // The gutter is still one pixel wide at the last level
+const int PAGE_MAX_SIZE = 1024;         // Standalone pages are scaled down to this
+const quint32 CACHE_MAGIC = 0x42544158; // "BTAX"
+const quint32 CACHE_VERSION = 1;        // Bump when the layout or the file format changes
+const int MAX_CACHED_PAGES = 64;        // Sanity limits when reading a cache file
+const int MAX_CACHED_LEVELS = 32;
+
+static int largestPowerOfTwo(int size)
+{
+    int power = 1;
+    while (power * 2 <= size)
+    {
+        power *= 2;
+    }
+    return power;
+}
+
+// Level 0 as tightly packed RGBA rows, then each level the 2x2 box filtered previous one
+static std::vector<QByteArray> mipmaps(const QImage &image, int levelCount)
+{
+    std::vector<QByteArray> levels;
+    int width = image.width();
+    int height = image.height();
+
+    QByteArray level(width * height * 4, Qt::Uninitialized);
+    for (int y = 0; y < height; ++y)
+    {
+        std::memcpy(level.data() + y * width * 4, image.constScanLine(y), width * 4);
+    }
+    levels.push_back(level);
+
+    while (static_cast<int>(levels.size()) < levelCount && (width > 1 || height > 1))
+    {
+        const int nextWidth = std::max(1, width / 2);
+        const int nextHeight = std::max(1, height / 2);
+        const uchar *source = reinterpret_cast<const uchar *>(levels.back().constData());
+        QByteArray next(nextWidth * nextHeight * 4, Qt::Uninitialized);
+        uchar *target = reinterpret_cast<uchar *>(next.data());
+        for (int y = 0; y < nextHeight; ++y)
+        {
+            const int y0 = std::min(2 * y, height - 1);
+            const int y1 = std::min(2 * y + 1, height - 1);
+            for (int x = 0; x < nextWidth; ++x)
+            {
+                const int x0 = std::min(2 * x, width - 1);
+                const int x1 = std::min(2 * x + 1, width - 1);
+                for (int c = 0; c < 4; ++c)
+                {
+                    const int sum = source[(y0 * width + x0) * 4 + c] + source[(y0 * width + x1) * 4 + c] +
+                                    source[(y1 * width + x0) * 4 + c] + source[(y1 * width + x1) * 4 + c];
+                    target[(y * nextWidth + x) * 4 + c] = static_cast<uchar>((sum + 2) / 4);
+                }
+            }
+        }
+        levels.push_back(next);
+        width = nextWidth;
+        height = nextHeight;
+    }
+    return levels;
+}
+
+QRectF TextureAtlas::region(int slot, int slotCount)
+{
+    const int rows = (slotCount + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+    const double width = ATLAS_COLUMNS * CELL_SIZE;
+    const double height = rows * CELL_SIZE;
+    const int column = slot % ATLAS_COLUMNS;
+    const int row = slot / ATLAS_COLUMNS;
+    return QRectF((column * CELL_SIZE + CELL_GUTTER) / width, (row * CELL_SIZE + CELL_GUTTER) / height,
+                  (CELL_SIZE - 2 * CELL_GUTTER) / width, (CELL_SIZE - 2 * CELL_GUTTER) / height);
+}
+
+void TextureAtlas::loadTextureMatrix(const QRectF &region)
+{
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glTranslatef(region.x(), region.y(), 0.0f);
+    glScalef(region.width(), region.height(), 1.0f);
+    glMatrixMode(GL_MODELVIEW);
+}
+
+QByteArray TextureAtlas::sourceKey(const QStringList &paths)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(CACHE_VERSION));
+    for (const QString &path : paths)
+    {
+        hash.addData(QFileInfo(path).fileName().toUtf8());
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly))
+        {
+            hash.addData(&file);
+        }
+        else
+        {
+            hash.addData(QByteArray("missing"));
+        }
+    }
+    return hash.result();
+}
+
+void TextureAtlas::build(const std::vector<QImage> &atlasImages, const std::vector<QImage> &pageImages)
+{
+    pages.clear();
+    slots = static_cast<int>(atlasImages.size());
+
+    // Each image fills the inside of its cell, the gutter repeats its edges
+    const int rows = (slots + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+    const int inner = CELL_SIZE - 2 * CELL_GUTTER;
+    QImage atlas(ATLAS_COLUMNS * CELL_SIZE, rows * CELL_SIZE, QImage::Format_RGBA8888);
+    atlas.fill(Qt::transparent);
+    for (int slot = 0; slot < slots; ++slot)
+    {
+        const QImage cell = atlasImages[slot].convertToFormat(QImage::Format_RGBA8888)
+                                .scaled(inner, inner, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        const int left = (slot % ATLAS_COLUMNS) * CELL_SIZE;
+        const int top = (slot / ATLAS_COLUMNS) * CELL_SIZE;
+        for (int y = 0; y < CELL_SIZE; ++y)
+        {
+            const quint32 *source = reinterpret_cast<const quint32 *>(cell.constScanLine(std::clamp(y - CELL_GUTTER, 0, inner - 1)));
+            quint32 *target = reinterpret_cast<quint32 *>(atlas.scanLine(top + y)) + left;
+            for (int x = 0; x < CELL_SIZE; ++x)
+            {
+                target[x] = source[std::clamp(x - CELL_GUTTER, 0, inner - 1)];
+            }
+        }
+    }
+    pages.push_back({atlas.width(), atlas.height(), mipmaps(atlas, ATLAS_LEVELS)});
+
+    // Standalone pages get a full mipmap chain, down to one pixel
+    for (const QImage &image : pageImages)
+    {
+        const int width = largestPowerOfTwo(std::min(image.width(), PAGE_MAX_SIZE));
+        const int height = largestPowerOfTwo(std::min(image.height(), PAGE_MAX_SIZE));
+        const QImage page = image.convertToFormat(QImage::Format_RGBA8888)
+                                .scaled(width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        pages.push_back({width, height, mipmaps(page, MAX_CACHED_LEVELS)});
+    }
+}
+
+bool TextureAtlas::load(const QString &path, const QByteArray &key)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QByteArray fileKey;
+    stream >> magic >> version >> fileKey;
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION || fileKey != key)
+    {
+        return false;
+    }
+
+    qint32 slotCount = 0;
+    qint32 count = 0;
+    stream >> slotCount >> count;
+    if (count <= 0 || count > MAX_CACHED_PAGES)
+    {
+        return false;
+    }
+    std::vector<Page> loaded(count);
+    for (Page &page : loaded)
+    {
+        qint32 width = 0;
+        qint32 height = 0;
+        qint32 levelCount = 0;
+        stream >> width >> height >> levelCount;
+        if (levelCount <= 0 || levelCount > MAX_CACHED_LEVELS)
+        {
+            return false;
+        }
+        page.width = width;
+        page.height = height;
+        page.levels.resize(levelCount);
+        for (int level = 0; level < levelCount; ++level)
+        {
+            stream >> page.levels[level];
+            const int expected = std::max(1, width >> level) * std::max(1, height >> level) * 4;
+            if (page.levels[level].size() != expected)
+            {
+                return false;
+            }
+        }
+    }
+    if (stream.status() != QDataStream::Ok)
+    {
+        return false;
+    }
+
+    pages = std::move(loaded);
+    slots = slotCount;
+    return true;
+}
+
+bool TextureAtlas::save(const QString &path, const QByteArray &key) const
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << CACHE_MAGIC << CACHE_VERSION << key << qint32(slots) << qint32(pages.size());
+    for (const Page &page : pages)
+    {
+        stream << qint32(page.width) << qint32(page.height) << qint32(page.levels.size());
+        for (const QByteArray &level : page.levels)
+        {
+            stream << level;
+        }
+    }
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+void TextureAtlas::upload(int page, GLuint texture, bool repeat) const
+{
+    const Page &source = pages[page];
+    const int levelCount = static_cast<int>(source.levels.size());
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+    // The atlas stops before its gutters vanish; levels past it are never sampled
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+    const bool immutable = !context->isOpenGLES() &&
+                           (context->format().version() >= qMakePair(4, 2) || context->hasExtension("GL_ARB_texture_storage"));
+    if (immutable)
+    {
+        context->extraFunctions()->glTexStorage2D(GL_TEXTURE_2D, levelCount, GL_RGBA8, source.width, source.height);
+    }
+    for (int level = 0; level < levelCount; ++level)
+    {
+        const int width = std::max(1, source.width >> level);
+        const int height = std::max(1, source.height >> level);
+        if (immutable)
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, source.levels[level].constData());
+        }
+        else
+        {
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, source.levels[level].constData());
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
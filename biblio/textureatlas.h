@@ -0,0 +1,112 @@
+/**
+ * @file textureatlas.h
+ * @brief Déclaration de la classe TextureAtlas.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+#include <qopengl.h>
+#include <QByteArray>
+#include <QImage>
+#include <QRectF>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+/**
+ * @class TextureAtlas
+ * @brief Textures du jeu regroupées dans un atlas avec mipmaps, et leur cache disque prêt à envoyer au GPU.
+ *
+ * Les images des objets (fruits, bombe, canon, katana) sont rangées dans les cases d'une seule
+ * texture (la page 0) : un objet texturé ne change plus de texture, seules ses coordonnées de
+ * texture sont ramenées dans sa région (region()). Chaque case est entourée d'une marge qui
+ * prolonge les bords de l'image, pour que les niveaux de mipmap ne mélangent pas deux images.
+ * Les images qui se répètent (le sol) restent sur des pages à part.
+ *
+ * Tous les niveaux de mipmap sont calculés sur le CPU, puis enregistrés bruts (RGBA 8 bits) dans
+ * un fichier de cache identifié par l'empreinte des images sources : aux lancements suivants, les
+ * JPEG ne sont plus décodés et les niveaux sont envoyés tels quels.
+ */
+class TextureAtlas
+{
+public:
+    /**
+     * @struct Page
+     * @brief Une texture à envoyer, avec tous ses niveaux de mipmap.
+     */
+    struct Page
+    {
+        int width = 0;                  ///< Largeur du niveau 0.
+        int height = 0;                 ///< Hauteur du niveau 0.
+        std::vector<QByteArray> levels; ///< Pixels RGBA 8 bits de chaque niveau, sans remplissage entre les lignes.
+    };
+
+    /**
+     * @brief Région d'une case de l'atlas, en coordonnées de texture.
+     * @param slot Indice de la case (ordre des images passées à build()).
+     * @param slotCount Nombre de cases de l'atlas.
+     * @return Rectangle (u, v, largeur, hauteur) ; v = 0 correspond à la première ligne des images.
+     */
+    static QRectF region(int slot, int slotCount);
+
+    /**
+     * @brief Charge la matrice de texture qui ramène les coordonnées [0, 1] dans une région (pipeline fixe).
+     * @param region Région de l'atlas, ou (0, 0, 1, 1) pour une page entière.
+     */
+    static void loadTextureMatrix(const QRectF &region);
+
+    /**
+     * @brief Empreinte des images sources, qui identifie un fichier de cache.
+     * @param paths Chemins des images (une image absente compte aussi).
+     */
+    static QByteArray sourceKey(const QStringList &paths);
+
+    /**
+     * @brief Construit l'atlas et les pages isolées, avec leurs mipmaps.
+     * @param atlasImages Images de l'atlas, dans l'ordre des cases.
+     * @param pageImages Images gardées sur leur propre page (pages 1, 2...), mises à une taille puissance de deux.
+     */
+    void build(const std::vector<QImage> &atlasImages, const std::vector<QImage> &pageImages);
+
+    /**
+     * @brief Lit les pages depuis le fichier de cache.
+     * @param path Fichier de cache.
+     * @param key Empreinte attendue (sourceKey()).
+     * @return false si le fichier est absent, d'un autre format ou construit à partir d'autres images.
+     */
+    bool load(const QString &path, const QByteArray &key);
+
+    /**
+     * @brief Enregistre les pages dans le fichier de cache.
+     * @param path Fichier de cache, son dossier est créé au besoin.
+     * @param key Empreinte des images sources.
+     * @return true si le fichier a été écrit.
+     */
+    bool save(const QString &path, const QByteArray &key) const;
+
+    /**
+     * @brief Envoie une page et ses mipmaps dans une texture. Nécessite un contexte OpenGL courant.
+     * @param page Indice de la page (0 pour l'atlas).
+     * @param texture Texture déjà créée.
+     * @param repeat true pour répéter la texture (GL_REPEAT), false pour la borner à ses bords.
+     */
+    void upload(int page, GLuint texture, bool repeat) const;
+
+    /**
+     * @brief Nombre de pages (atlas compris).
+     */
+    int pageCount() const { return static_cast<int>(pages.size()); }
+
+    /**
+     * @brief Nombre de cases de l'atlas.
+     */
+    int slotCount() const { return slots; }
+
+private:
+    std::vector<Page> pages;    ///< Atlas puis pages isolées.
+    int slots = 0;              ///< Nombre de cases de l'atlas.
+};
+
+#endif // TEXTUREATLAS_H
@@ -0,0 +1,83 @@
+/**
+ * @file triplebuffer.h
+ * @brief Déclaration du modèle TripleBuffer.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class TripleBuffer
+ * @brief Tampon triple sans verrou entre un producteur et un consommateur.
+ *
+ * Le producteur écrit dans un emplacement privé puis le publie ; le consommateur
+ * récupère toujours la valeur la plus récente. Aucun des deux ne bloque : une valeur
+ * publiée qui n'a pas été lue avant la publication suivante est simplement écrasée
+ * (et signalée comme perdue au producteur).
+ *
+ * @tparam T Type stocké dans chacun des trois emplacements.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    /**
+     * @brief Emplacement réservé au producteur.
+     * @return Référence vers l'emplacement à remplir avant publish().
+     */
+    T &writeBuffer() { return m_slots[m_back]; }
+
+    /**
+     * @brief Publie l'emplacement du producteur comme valeur la plus récente.
+     * @return true si la valeur publiée précédemment n'avait pas été lue (elle est perdue).
+     */
+    bool publish()
+    {
+        uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_back | kFreshBit), std::memory_order_acq_rel);
+        m_back = previous & kIndexMask;
+        return (previous & kFreshBit) != 0;
+    }
+
+    /**
+     * @brief Indique si la dernière valeur publiée attend encore d'être lue.
+     * Permet au producteur d'attendre le consommateur lorsqu'aucune valeur ne doit être perdue.
+     * @return true si update() n'a pas encore récupéré la dernière valeur publiée.
+     */
+    bool pending() const { return (m_middle.load(std::memory_order_acquire) & kFreshBit) != 0; }
+
+    /**
+     * @brief Récupère la dernière valeur publiée, si elle est nouvelle.
+     * @return true si readBuffer() contient une valeur qui n'avait pas encore été lue.
+     */
+    bool update()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & kFreshBit) == 0)
+        {
+            return false;
+        }
+        uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & kIndexMask;
+        return true;
+    }
+
+    /**
+     * @brief Emplacement réservé au consommateur.
+     * @return Référence vers la dernière valeur obtenue par update().
+     */
+    T &readBuffer() { return m_slots[m_front]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x03; ///< Masque de l'indice d'emplacement.
+    static constexpr uint8_t kFreshBit = 0x04;  ///< Bit indiquant une valeur publiée et non lue.
+
+    T m_slots[3];                       ///< Les trois emplacements (producteur, partagé, consommateur).
+    std::atomic<uint8_t> m_middle{1};   ///< Indice de l'emplacement partagé et bit de fraîcheur.
+    uint8_t m_back = 0;                 ///< Indice de l'emplacement du producteur.
+    uint8_t m_front = 2;                ///< Indice de l'emplacement du consommateur.
+};
+
+#endif // TRIPLEBUFFER_H
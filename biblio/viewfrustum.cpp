@@ -0,0 +1,50 @@
+#include "viewfrustum.h"
+#include <limits>
+
+ViewFrustum::ViewFrustum(const QMatrix4x4 &projection, const QMatrix4x4 &view, int viewportHeight)
+    : viewMatrix(view), valid(true)
+{
+    // Each plane is the last row of the clip matrix plus or minus one of the others
+    const QMatrix4x4 clip = projection * view;
+    const QVector4D w = clip.row(3);
+    planes[0] = w + clip.row(0);
+    planes[1] = w - clip.row(0);
+    planes[2] = w + clip.row(1);
+    planes[3] = w - clip.row(1);
+    planes[4] = w + clip.row(2);
+    planes[5] = w - clip.row(2);
+    for (QVector4D &plane : planes)
+    {
+        plane /= plane.toVector3D().length();
+    }
+
+    // projection(1, 1) is cot(fovy / 2): half the viewport height spans that many units at unit depth
+    pixelsPerUnit = projection(1, 1) * viewportHeight * 0.5f;
+}
+
+bool ViewFrustum::intersectsSphere(const QVector3D &center, float radius) const
+{
+    if (!valid)
+    {
+        return true;
+    }
+    for (const QVector4D &plane : planes)
+    {
+        if (QVector3D::dotProduct(plane.toVector3D(), center) + plane.w() < -radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+float ViewFrustum::projectedRadius(const QVector3D &center, float radius) const
+{
+    // The camera looks down -z in view space
+    const float depth = -viewMatrix.map(center).z();
+    if (!valid || depth <= radius)
+    {
+        return std::numeric_limits<float>::max();
+    }
+    return radius * pixelsPerUnit / depth;
+}
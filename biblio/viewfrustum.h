@@ -0,0 +1,63 @@
+/**
+ * @file viewfrustum.h
+ * @brief Déclaration de la classe ViewFrustum.
+ * @author Boutet Paul, El Gote Ismaïl
+ */
+
+#ifndef VIEWFRUSTUM_H
+#define VIEWFRUSTUM_H
+
+#include <QMatrix4x4>
+#include <QVector3D>
+#include <QVector4D>
+
+/**
+ * @class ViewFrustum
+ * @brief Volume visible de la caméra, pour écarter les objets hors champ et estimer leur taille à l'écran.
+ *
+ * Les six plans sont extraits de la matrice projection × vue (méthode de Gribb et Hartmann),
+ * orientés vers l'intérieur du volume. Les objets sont testés par leur sphère englobante.
+ * Sans état OpenGL : la projection est celle de gluPerspective dans GameWidget::resizeGL().
+ */
+class ViewFrustum
+{
+public:
+    ViewFrustum() = default;
+
+    /**
+     * @brief Construit le volume d'une caméra.
+     * @param projection Matrice de projection (perspective).
+     * @param view Matrice de vue (de la scène vers l'espace caméra).
+     * @param viewportHeight Hauteur de la zone d'affichage en pixels physiques (taille logique multipliée par devicePixelRatioF()).
+     */
+    ViewFrustum(const QMatrix4x4 &projection, const QMatrix4x4 &view, int viewportHeight);
+
+    /**
+     * @brief Indique si le volume a été construit.
+     */
+    bool isValid() const { return valid; }
+
+    /**
+     * @brief Teste si une sphère est au moins en partie dans le volume visible.
+     * @param center Centre de la sphère dans la scène.
+     * @param radius Rayon de la sphère.
+     * @return true si la sphère peut être visible ; toujours true si le volume n'est pas construit.
+     */
+    bool intersectsSphere(const QVector3D &center, float radius) const;
+
+    /**
+     * @brief Rayon approximatif à l'écran d'une sphère, en pixels physiques.
+     * @param center Centre de la sphère dans la scène.
+     * @param radius Rayon de la sphère.
+     * @return Rayon projeté ; très grand si la sphère touche le plan de la caméra ou si le volume n'est pas construit.
+     */
+    float projectedRadius(const QVector3D &center, float radius) const;
+
+private:
+    QVector4D planes[6];            ///< Plans gauche, droit, bas, haut, proche et lointain (normale unitaire vers l'intérieur).
+    QMatrix4x4 viewMatrix;          ///< Matrice de vue, pour la profondeur des objets.
+    float pixelsPerUnit = 0.0f;     ///< Taille en pixels d'une unité à une unité de distance.
+    bool valid = false;             ///< true une fois construit.
+};
+
+#endif // VIEWFRUSTUM_H